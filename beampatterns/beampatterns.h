@@ -27,6 +27,7 @@
 #include <usml/beampatterns/bp_piston.h>
 #include <usml/beampatterns/bp_planar.h>
 #include <usml/beampatterns/bp_solid.h>
+#include <usml/beampatterns/bp_table.h>
 #include <usml/beampatterns/bp_trig.h>
 #include <usml/beampatterns/bp_cylinder.h>
 #include <usml/beampatterns/bp_sphere.h>
\ No newline at end of file
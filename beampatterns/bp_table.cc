@@ -0,0 +1,406 @@
+/**
+ * @file bp_table.cc
+ * Tabulates the response of another beam pattern on a grid of DE and AZ
+ * angles.
+ */
+
+#include <usml/beampatterns/bp_table.h>
+#include <usml/threads/read_write_lock.h>
+#include <usml/ublas/math_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <queue>
+#include <utility>
+
+using namespace usml::beampatterns;
+using namespace usml::threads;
+
+namespace {
+
+/// Index used for coarse cells that have not been refined.
+const size_t unrefined = std::numeric_limits<size_t>::max();
+
+/**
+ * Bi-linear interpolation on a grid of values. Extrapolates from the last
+ * cell if the location is on, or beyond, the upper edge of the grid.
+ *
+ * @param grid      Values stored in row major order.
+ * @param num_rows  Number of rows in the grid.
+ * @param num_cols  Number of columns in the grid.
+ * @param x         Location in units of rows.
+ * @param y         Location in units of columns.
+ * @return          Interpolated value.
+ */
+double bilinear(const double* grid, size_t num_rows, size_t num_cols,
+                double x, double y) {
+    const auto d = std::min((size_t)std::max(x, 0.0), num_rows - 2);
+    const auto a = std::min((size_t)std::max(y, 0.0), num_cols - 2);
+    const double u = x - (double)d;
+    const double v = y - (double)a;
+    const double* row = grid + d * num_cols + a;
+    const double lower = (1.0 - v) * row[0] + v * row[1];
+    const double upper = (1.0 - v) * row[num_cols] + v * row[num_cols + 1];
+    return (1.0 - u) * lower + u * upper;
+}
+
+/**
+ * Parameters used to find tables that can be shared.
+ */
+struct table_key {
+    const bp_model* beam;
+    std::vector<double> frequencies;
+    double front, right, up;
+    double max_error, sound_speed, spacing, min_spacing;
+    size_t max_size;
+
+    bool operator==(const table_key& other) const {
+        return beam == other.beam && frequencies == other.frequencies &&
+               front == other.front && right == other.right &&
+               up == other.up && max_error == other.max_error &&
+               sound_speed == other.sound_speed && spacing == other.spacing &&
+               min_spacing == other.min_spacing && max_size == other.max_size;
+    }
+};
+
+/// Tables that may still be in use, and the parameters used to create them.
+std::list<std::pair<table_key, std::weak_ptr<const bp_model>>> table_cache;
+
+/// Mutex that locks table_cache.
+read_write_lock table_mutex;
+
+/**
+ * Searches the cache for a table that is still in use.
+ */
+bp_model::csptr find_table(const table_key& key) {
+    for (const auto& entry : table_cache) {
+        if (entry.first == key) {
+            if (auto table = entry.second.lock()) {
+                return table;
+            }
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+/**
+ * Tabulates the response of another beam pattern. Refines the cells whose
+ * interpolation error is above max_error, worst cell first.
+ */
+bp_table::bp_table(const bp_model::csptr& beam,
+                   const seq_vector::csptr& frequencies,
+                   const bvector& steering, double max_error,
+                   double sound_speed, double spacing, double min_spacing,
+                   size_t max_size)
+    : _beam(beam),
+      _frequencies(frequencies),
+      _steering(steering),
+      _sound_speed(sound_speed) {
+    std::vector<double> errors;
+    tabulate(spacing, &errors);
+    _cell_index.assign(errors.size(), unrefined);
+    _size = _table.size();
+
+    unsigned max_level = 0;
+    while (min_spacing > 0.0 && _spacing / (1 << (max_level + 1)) >=
+                                    min_spacing * (1.0 - 1e-9)) {
+        ++max_level;
+    }
+    std::priority_queue<std::pair<double, size_t>> queue;
+    for (size_t cell = 0; cell < errors.size(); ++cell) {
+        if (errors[cell] > max_error) {
+            queue.emplace(errors[cell], cell);
+        }
+    }
+
+    // refine the worst cell until all cells meet max_error,
+    // or the table would grow past max_size
+
+    const size_t num_freq = _frequencies->size();
+    while (!queue.empty()) {
+        const size_t cell = queue.top().second;
+        queue.pop();
+        const size_t index = _cell_index[cell];
+        const unsigned level = (index == unrefined) ? 0 : _fine[index].level;
+        if (level >= max_level) {
+            continue;
+        }
+        const size_t n = (1 << (level + 1)) + 1;
+        const size_t old_size =
+            (index == unrefined) ? 0 : _fine[index].levels.size();
+        if (_size + num_freq * n * n - old_size > max_size) {
+            break;
+        }
+        fine_cell fine;
+        errors[cell] = refine(cell, level + 1, &fine);
+        _size += fine.levels.size() - old_size;
+        _max_level = std::max(_max_level, fine.level);
+        if (index == unrefined) {
+            _cell_index[cell] = _fine.size();
+            _fine.push_back(std::move(fine));
+        } else {
+            _fine[index] = std::move(fine);
+        }
+        if (errors[cell] > max_error) {
+            queue.emplace(errors[cell], cell);
+        }
+    }
+    _error = errors.empty() ? 0.0
+                            : *std::max_element(errors.begin(), errors.end());
+}
+
+/**
+ * Finds a table with the same parameters that is still in use, or tabulates
+ * a new one.
+ */
+bp_model::csptr bp_table::create(const bp_model::csptr& beam,
+                                 const seq_vector::csptr& frequencies,
+                                 const bvector& steering, double max_error,
+                                 double sound_speed, double spacing,
+                                 double min_spacing, size_t max_size) {
+    const auto freq = frequencies->data();
+    table_key key{beam.get(),
+                  std::vector<double>(freq.begin(), freq.end()),
+                  steering.front(),
+                  steering.right(),
+                  steering.up(),
+                  max_error,
+                  sound_speed,
+                  spacing,
+                  min_spacing,
+                  max_size};
+    {
+        read_lock_guard guard(table_mutex);
+        if (auto table = find_table(key)) {
+            return table;
+        }
+    }
+
+    // tabulate outside of the lock, and then check that another thread
+    // has not created the same table in the meantime
+
+    bp_model::csptr table(new bp_table(beam, frequencies, steering, max_error,
+                                       sound_speed, spacing, min_spacing,
+                                       max_size));
+    write_lock_guard guard(table_mutex);
+    if (auto existing = find_table(key)) {
+        return existing;
+    }
+    table_cache.remove_if(
+        [](const std::pair<table_key, std::weak_ptr<const bp_model>>& entry) {
+            return entry.second.expired();
+        });
+    table_cache.emplace_back(std::move(key), table);
+    return table;
+}
+
+/**
+ * Computes beam levels on the coarse grid, and measures the interpolation
+ * error of each cell at its center and at the middle of each edge.
+ */
+void bp_table::tabulate(double spacing, std::vector<double>* errors) {
+    const auto num_cells =
+        (size_t)std::max(1.0, std::ceil(180.0 / spacing - 1e-9));
+    _spacing = 180.0 / (double)num_cells;
+    _num_de = num_cells + 1;
+    _num_az = 2 * num_cells + 1;
+    const size_t num_freq = _frequencies->size();
+    const size_t plane = _num_de * _num_az;
+    _table.assign(num_freq * plane, 0.0);
+
+    // compute beam levels at each grid point
+
+    vector<double> level(num_freq);
+    for (size_t d = 0; d < _num_de; ++d) {
+        const double de = -90.0 + (double)d * _spacing;
+        for (size_t a = 0; a < _num_az; ++a) {
+            const double az = -180.0 + (double)a * _spacing;
+            _beam->beam_level(bvector(de, az), _frequencies, &level, _steering,
+                              _sound_speed);
+            for (size_t f = 0; f < num_freq; ++f) {
+                _table[f * plane + d * _num_az + a] = level[f];
+            }
+        }
+    }
+
+    // measure interpolation error at a location in units of grid cells,
+    // and charge it to the cells on either side of that location
+
+    const size_t num_cols = _num_az - 1;
+    errors->assign((_num_de - 1) * num_cols, 0.0);
+    const auto check = [&](double x, double y) {
+        _beam->beam_level(
+            bvector(-90.0 + x * _spacing, -180.0 + y * _spacing), _frequencies,
+            &level, _steering, _sound_speed);
+        double error = 0.0;
+        for (size_t f = 0; f < num_freq; ++f) {
+            const double value = bilinear(_table.data() + f * plane, _num_de,
+                                          _num_az, x, y);
+            error = std::max(error, std::abs(level[f] - value));
+        }
+        const auto d_lo = (size_t)std::max(0.0, std::ceil(x) - 1.0);
+        const auto d_hi = std::min((size_t)x, _num_de - 2);
+        const auto a_lo = (size_t)std::max(0.0, std::ceil(y) - 1.0);
+        const auto a_hi = std::min((size_t)y, num_cols - 1);
+        for (size_t d = d_lo; d <= d_hi; ++d) {
+            for (size_t a = a_lo; a <= a_hi; ++a) {
+                double& cell = (*errors)[d * num_cols + a];
+                cell = std::max(cell, error);
+            }
+        }
+    };
+    for (size_t d = 0; d < _num_de; ++d) {
+        for (size_t a = 0; a < _num_az; ++a) {
+            if (a + 1 < _num_az) {
+                check((double)d, (double)a + 0.5);
+            }
+            if (d + 1 < _num_de) {
+                check((double)d + 0.5, (double)a);
+                if (a + 1 < _num_az) {
+                    check((double)d + 0.5, (double)a + 0.5);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Computes beam levels on a finer grid within one coarse cell.
+ */
+double bp_table::refine(size_t cell, unsigned level, fine_cell* fine) const {
+    const size_t num_cols = _num_az - 1;
+    const size_t d0 = cell / num_cols;
+    const size_t a0 = cell % num_cols;
+    const size_t m = 1 << level;
+    const size_t n = m + 1;
+    const double h = 1.0 / (double)m;
+    const size_t num_freq = _frequencies->size();
+    const size_t plane = _num_de * _num_az;
+    fine->level = level;
+    fine->levels.assign(num_freq * n * n, 0.0);
+
+    // compute beam levels at each point on the finer grid,
+    // copying the corners from the coarse grid
+
+    vector<double> values(num_freq);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            const bool corner = (i == 0 || i == m) && (j == 0 || j == m);
+            if (corner) {
+                const size_t d = d0 + i / m;
+                const size_t a = a0 + j / m;
+                for (size_t f = 0; f < num_freq; ++f) {
+                    fine->levels[(f * n + i) * n + j] =
+                        _table[f * plane + d * _num_az + a];
+                }
+                continue;
+            }
+            const double de = -90.0 + ((double)d0 + i * h) * _spacing;
+            const double az = -180.0 + ((double)a0 + j * h) * _spacing;
+            _beam->beam_level(bvector(de, az), _frequencies, &values,
+                              _steering, _sound_speed);
+            for (size_t f = 0; f < num_freq; ++f) {
+                fine->levels[(f * n + i) * n + j] = values[f];
+            }
+        }
+    }
+
+    // measure interpolation error at the center and edges of each small cell
+
+    double error = 0.0;
+    const auto check = [&](double x, double y) {
+        const double de = -90.0 + ((double)d0 + x * h) * _spacing;
+        const double az = -180.0 + ((double)a0 + y * h) * _spacing;
+        _beam->beam_level(bvector(de, az), _frequencies, &values,
+                          _steering, _sound_speed);
+        for (size_t f = 0; f < num_freq; ++f) {
+            const double value =
+                bilinear(fine->levels.data() + f * n * n, n, n, x, y);
+            error = std::max(error, std::abs(values[f] - value));
+        }
+    };
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            if (j < m) {
+                check((double)i, (double)j + 0.5);
+            }
+            if (i < m) {
+                check((double)i + 0.5, (double)j);
+                if (j < m) {
+                    check((double)i + 0.5, (double)j + 0.5);
+                }
+            }
+        }
+    }
+    return error;
+}
+
+/**
+ * Bi-linear interpolation of the table for a single frequency.
+ */
+double bp_table::interpolate(size_t freq, double de, double az) const {
+    const double x = (de + 90.0) / _spacing;
+    const double y = (az + 180.0) / _spacing;
+    const auto d = std::min((size_t)std::max(x, 0.0), _num_de - 2);
+    const auto a = std::min((size_t)std::max(y, 0.0), _num_az - 2);
+    const size_t index = _cell_index[d * (_num_az - 1) + a];
+    if (index == unrefined) {
+        const size_t plane = _num_de * _num_az;
+        return bilinear(_table.data() + freq * plane, _num_de, _num_az, x, y);
+    }
+    const fine_cell& fine = _fine[index];
+    const size_t m = 1 << fine.level;
+    const size_t n = m + 1;
+    return bilinear(fine.levels.data() + freq * n * n, n, n,
+                    (x - (double)d) * (double)m, (y - (double)a) * (double)m);
+}
+
+/**
+ * Finds the index of a frequency in the table.
+ */
+size_t bp_table::find_frequency(double freq) const {
+    const size_t num_freq = _frequencies->size();
+    for (size_t f = 0; f < num_freq; ++f) {
+        const double value = (*_frequencies)[f];
+        const double tolerance = 1e-6 * std::max(1.0, std::abs(value));
+        if (std::abs(freq - value) <= tolerance) {
+            return f;
+        }
+    }
+    return num_freq;
+}
+
+/**
+ * Interpolates beam levels from the table, or passes the request to the
+ * original beam pattern if the table does not apply.
+ */
+void bp_table::beam_level(const bvector& arrival,
+                          const seq_vector::csptr& frequencies,
+                          vector<double>* level, const bvector& steering,
+                          double sound_speed) const {
+    const bool same_steering = steering.front() == _steering.front() &&
+                               steering.right() == _steering.right() &&
+                               steering.up() == _steering.up();
+    if (!same_steering || sound_speed != _sound_speed) {
+        _beam->beam_level(arrival, frequencies, level, steering, sound_speed);
+        return;
+    }
+
+    const double up = std::max(-1.0, std::min(1.0, arrival.up()));
+    const double de = to_degrees(asin(up));
+    const double az = to_degrees(atan2(arrival.right(), arrival.front()));
+    const size_t num_freq = frequencies->size();
+    for (size_t f = 0; f < num_freq; ++f) {
+        const size_t index = find_frequency((*frequencies)[f]);
+        if (index >= _frequencies->size()) {
+            _beam->beam_level(arrival, frequencies, level, steering,
+                              sound_speed);
+            return;
+        }
+        (*level)[f] = interpolate(index, de, az);
+    }
+}
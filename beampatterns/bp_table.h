@@ -0,0 +1,204 @@
+/**
+ * @file bp_table.h
+ * Tabulates the response of another beam pattern on a grid of DE and AZ
+ * angles.
+ */
+#pragma once
+
+#include <usml/beampatterns/bp_model.h>
+#include <usml/types/bvector.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <boost/numeric/ublas/vector.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace beampatterns {
+
+using namespace usml::types;
+
+/// @ingroup beampatterns
+/// @{
+
+/**
+ * Tabulates the response of another beam pattern on a grid of DE and AZ
+ * angles, for a fixed list of frequencies, steering, and sound speed.
+ * Beam levels are computed using bi-linear interpolation in DE and AZ.
+ * This trades a one-time tabulation cost for much faster beam level
+ * calculations in models that evaluate the same beam many times, like
+ * reverberation time series generation. It is most useful for
+ * patterns like bp_arb, which sum the contributions of each element for
+ * every arrival.
+ *
+ * The table starts with a coarse grid spacing of "spacing" degrees. It
+ * measures the interpolation error of each cell at its center and at the
+ * middle of each of its edges. Cells whose error is greater than "max_error"
+ * are refined individually, worst cell first, by cutting the spacing within
+ * that cell in half, down to a minimum of "min_spacing" degrees. Refinement
+ * stops when every cell meets max_error, or when the next refinement would
+ * make the table hold more than "max_size" beam levels. The error() method
+ * reports the largest error of any cell at its final spacing, so clients
+ * should compare it to max_error to detect tables that hit the size limit.
+ * Because the error is only sampled at cell centers and edge midpoints, it
+ * is an estimate of the interpolation error, not a strict bound. Because
+ * beam levels are linear intensity gains with a peak of 1.0, max_error is
+ * an absolute error in the same units.
+ *
+ * The create() method shares tables that have the same parameters, so that
+ * a table can be re-used by later calculations while any user still holds it.
+ *
+ * Requests for other frequencies, steerings, or sound speeds are passed
+ * directly to the original beam pattern, so this class can be used
+ * anywhere the original pattern is used. Like other beam patterns, this class
+ * is immutable after construction to support thread safety without locking.
+ */
+class USML_DECLSPEC bp_table : public bp_model {
+   public:
+    /**
+     * Tabulates the response of another beam pattern.
+     *
+     * @param beam          Beam pattern to tabulate.
+     * @param frequencies   Frequencies at which to tabulate beam (Hz).
+     * @param steering      Steering vector relative to body.
+     * @param max_error     Maximum interpolation error (linear units).
+     * @param sound_speed   Speed of sound in water (m/s).
+     * @param spacing       Initial grid spacing in DE and AZ (deg).
+     * @param min_spacing   Minimum grid spacing in DE and AZ (deg).
+     * @param max_size      Maximum number of beam levels in the table.
+     */
+    bp_table(const bp_model::csptr& beam, const seq_vector::csptr& frequencies,
+             const bvector& steering = bvector(1.0, 0.0, 0.0),
+             double max_error = 1e-3, double sound_speed = 1500.0,
+             double spacing = 1.0, double min_spacing = 0.125,
+             size_t max_size = 1 << 21);
+
+    /**
+     * Finds a table with the same parameters that is still in use, or
+     * tabulates a new one. Tables are matched using the address of the
+     * original beam pattern, so they are only shared while that pattern
+     * exists. Arguments are the same as the constructor.
+     */
+    static bp_model::csptr create(
+        const bp_model::csptr& beam, const seq_vector::csptr& frequencies,
+        const bvector& steering = bvector(1.0, 0.0, 0.0),
+        double max_error = 1e-3, double sound_speed = 1500.0,
+        double spacing = 1.0, double min_spacing = 0.125,
+        size_t max_size = 1 << 21);
+
+    void beam_level(const bvector& arrival,
+                    const seq_vector::csptr& frequencies, vector<double>* level,
+                    const bvector& steering = bvector(1.0, 0.0, 0.0),
+                    double sound_speed = 1500.0) const override;
+
+    /// Coarse grid spacing in DE and AZ used by this table (deg).
+    double spacing() const { return _spacing; }
+
+    /// Smallest grid spacing in DE and AZ used by any cell (deg).
+    double min_spacing() const { return _spacing / (1 << _max_level); }
+
+    /**
+     * Largest interpolation error of any cell (linear units), sampled at
+     * cell centers and edge midpoints. May exceed max_error if max_size
+     * stopped refinement.
+     */
+    double error() const { return _error; }
+
+    /// Number of beam levels stored in the table.
+    size_t size() const { return _size; }
+
+   private:
+    /// Finer grid for one coarse cell, stored in frequency, DE, AZ order.
+    struct fine_cell {
+        /// Number of times the coarse spacing was cut in half.
+        unsigned level;
+
+        /// Beam levels on the (2^level+1) x (2^level+1) grid.
+        std::vector<double> levels;
+    };
+
+    /// Beam pattern that was tabulated.
+    const bp_model::csptr _beam;
+
+    /// Frequencies at which beam was tabulated (Hz).
+    const seq_vector::csptr _frequencies;
+
+    /// Steering vector relative to body.
+    const bvector _steering;
+
+    /// Speed of sound in water (m/s).
+    const double _sound_speed;
+
+    /// Coarse grid spacing in DE and AZ (deg).
+    double _spacing = 0.0;
+
+    /// Number of DE angles in the coarse grid, from -90 to +90 deg.
+    size_t _num_de = 0;
+
+    /// Number of AZ angles in the coarse grid, from -180 to +180 deg.
+    size_t _num_az = 0;
+
+    /// Largest interpolation error of any cell.
+    double _error = 0.0;
+
+    /// Number of beam levels stored in the coarse and fine grids.
+    size_t _size = 0;
+
+    /// Largest number of times any cell was cut in half.
+    unsigned _max_level = 0;
+
+    /// Coarse beam levels stored in frequency, DE, AZ order.
+    std::vector<double> _table;
+
+    /// Index of each coarse cell in _fine, or _fine.size() if not refined.
+    std::vector<size_t> _cell_index;
+
+    /// Finer grids for the cells that needed them.
+    std::vector<fine_cell> _fine;
+
+    /**
+     * Computes beam levels on the coarse grid, and measures the
+     * interpolation error of each cell.
+     *
+     * @param spacing   Requested grid spacing in DE and AZ (deg). Adjusted
+     *                  down to fit an integer number of cells into 180 deg.
+     * @param errors    Interpolation error of each coarse cell.
+     */
+    void tabulate(double spacing, std::vector<double>* errors);
+
+    /**
+     * Computes beam levels on a finer grid within one coarse cell, and
+     * measures the interpolation error at the center and edges of each
+     * of the smaller cells.
+     *
+     * @param cell      Index of the coarse cell.
+     * @param level     Number of times to cut the coarse spacing in half.
+     * @param fine      Finer grid to be computed.
+     * @return          Largest interpolation error in this cell.
+     */
+    double refine(size_t cell, unsigned level, fine_cell* fine) const;
+
+    /**
+     * Bi-linear interpolation of the table for a single frequency.
+     *
+     * @param freq  Index of frequency in the table.
+     * @param de    Depression/elevation angle (deg).
+     * @param az    Azimuthal angle in the range [-180,180] (deg).
+     * @return      Interpolated beam level (linear units).
+     */
+    double interpolate(size_t freq, double de, double az) const;
+
+    /**
+     * Finds the index of a frequency in the table.
+     *
+     * @param freq  Requested frequency (Hz).
+     * @return      Index of frequency in table, or the number of
+     *              tabulated frequencies if not found.
+     */
+    size_t find_frequency(double freq) const;
+};
+
+/// @}
+}  // namespace beampatterns
+}  // namespace usml
@@ -566,6 +566,75 @@ BOOST_AUTO_TEST_CASE(bp_gaussian_test) {
     BOOST_CHECK_CLOSE(level(0), 25.0, 1.0);
 }
 
+/**
+ * Tabulates the pattern of a steered horizontal line array, and compares the
+ * table to the original pattern at a set of angles that are not on the grid.
+ * The error at the center and edges of each cell is measured by the table
+ * itself, and must be less than the requested maximum. Also checks that
+ * requests with a different steering are passed to the original pattern,
+ * that only some cells are refined, that the table respects max_size, and
+ * that create() shares tables with the same parameters.
+ */
+BOOST_AUTO_TEST_CASE(bp_table_test) {
+    cout << "=== beampattern_test: bp_table_test ===" << endl;
+    seq_vector::csptr frequencies(new seq_linear(freq, 1.0, 1));
+    vector<double> level(frequencies->size(), 0.0);
+    vector<double> exact(frequencies->size(), 0.0);
+
+    const double max_error = 1e-3;
+    bvector steering(0.0, 30.0);
+    bp_model::csptr hla(new bp_line(5, spacing, bp_line_type::HLA));
+    bp_table table(hla, frequencies, steering, max_error);
+    cout << "spacing=" << table.spacing() << " error=" << table.error()
+         << endl;
+    BOOST_CHECK_LE(table.error(), max_error);
+
+    double worst = 0.0;
+    for (double de = -89.7; de < 90.0; de += 3.1) {
+        for (double az = -179.3; az < 180.0; az += 2.9) {
+            bvector arrival(de, az);
+            table.beam_level(arrival, frequencies, &level, steering);
+            hla->beam_level(arrival, frequencies, &exact, steering);
+            worst = std::max(worst, abs(level(0) - exact(0)));
+        }
+    }
+    cout << "worst=" << worst << endl;
+    BOOST_CHECK_LE(worst, 2.0 * max_error);
+
+    bvector arrival(10.0, 20.0);
+    bvector other(0.0, -30.0);
+    table.beam_level(arrival, frequencies, &level, other);
+    hla->beam_level(arrival, frequencies, &exact, other);
+    BOOST_CHECK_EQUAL(level(0), exact(0));
+
+    // only the cells that need it should be refined
+
+    bp_table refined(hla, frequencies, steering, 1e-5);
+    const double fine = refined.min_spacing();
+    const auto uniform = size_t((180.0 / fine + 1.0) * (360.0 / fine + 1.0));
+    cout << "min_spacing=" << fine << " size=" << refined.size()
+         << " uniform=" << uniform << " error=" << refined.error() << endl;
+    BOOST_CHECK_LT(fine, refined.spacing());
+    BOOST_CHECK_LT(refined.size(), uniform);
+
+    // table size is limited by max_size
+
+    const size_t max_size = 100000;
+    bp_table small(hla, frequencies, steering, 1e-9, 1500.0, 1.0, 0.125,
+                   max_size);
+    BOOST_CHECK_LE(small.size(), max_size);
+    BOOST_CHECK_GT(small.error(), 1e-9);
+
+    // tables with the same parameters are shared while in use
+
+    bp_model::csptr shared =
+        bp_table::create(hla, frequencies, steering, max_error);
+    BOOST_CHECK_EQUAL(
+        bp_table::create(hla, frequencies, steering, max_error), shared);
+    BOOST_CHECK(bp_table::create(hla, frequencies, other, max_error) !=
+                shared);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,6 +12,7 @@
 #include <boost/numeric/ublas/expression_types.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <algorithm>
 #include <cmath>
 #include <list>
 #include <netcdf>
@@ -27,37 +28,157 @@ using namespace usml::biverbs;
  */
 double biverb_collection::power_threshold = 1e-20;
 
+/**
+ * Width of the time bins used to find biverbs by travel time.
+ */
+double biverb_collection::bin_width = 0.1;
+
 /**
  * Creates list of biverbs for a specific interface.
  */
 biverb_list biverb_collection::biverbs(size_t interface) const {
+    auto window = biverbs_window(interface);
+    return biverb_list(window.begin(), window.end());
+}
+
+/**
+ * All of the biverbs for a specific interface, sorted by travel time.
+ */
+biverb_collection::range biverb_collection::biverbs_window(
+    size_t interface) const {
+    sort_biverbs(interface);
     read_lock_guard guard(_mutex);
-    biverb_list list;
-    for (const auto& pair : _collection[interface]) {
-        list.push_back(pair.second);
+    const auto& verbs = _collection[interface];
+    return {verbs.begin(), verbs.end()};
+}
+
+/**
+ * Biverbs for a specific interface within a window of travel times.
+ */
+biverb_collection::range biverb_collection::biverbs_window(
+    size_t interface, double time_min, double time_max) const {
+    sort_biverbs(interface);
+    read_lock_guard guard(_mutex);
+    const auto& verbs = _collection[interface];
+    const size_t first = find_time(interface, time_min);
+    const size_t last = std::max(first, find_time(interface, time_max));
+    return {verbs.begin() + first, verbs.begin() + last};
+}
+
+/**
+ * Sorts the biverbs for one interface and rebuilds its time bins.
+ */
+void biverb_collection::sort_biverbs(size_t interface) const {
+    {
+        read_lock_guard guard(_mutex);
+        if (_sorted[interface] != 0) {
+            return;
+        }
+    }
+    write_lock_guard guard(_mutex);
+    if (_sorted[interface] != 0) {
+        return;
     }
-    return list;
+    auto& verbs = _collection[interface];
+    std::stable_sort(verbs.begin(), verbs.end(),
+                     [](const biverb_model::csptr& a,
+                        const biverb_model::csptr& b) {
+                         return a->travel_time < b->travel_time;
+                     });
+
+    // record the first biverb at or after the start of each bin
+
+    auto& bins = _bins[interface];
+    const double width = bin_width;
+    _bin_widths[interface] = width;
+    bins.clear();
+    if (!verbs.empty()) {
+        const auto num_bins =
+            size_t(std::max(verbs.back()->travel_time, 0.0) / width) + 1;
+        bins.reserve(num_bins);
+        size_t index = 0;
+        for (size_t bin = 0; bin < num_bins; ++bin) {
+            const double time = bin * width;
+            while (index < verbs.size() && verbs[index]->travel_time < time) {
+                ++index;
+            }
+            bins.push_back(index);
+        }
+    }
+    _sorted[interface] = 1;
+}
+
+/**
+ * Index of the first biverb at or after a specific travel time.
+ */
+size_t biverb_collection::find_time(size_t interface, double time) const {
+    const auto& verbs = _collection[interface];
+    const auto& bins = _bins[interface];
+    if (bins.empty() || time <= 0.0) {
+        size_t index = 0;
+        while (index < verbs.size() && verbs[index]->travel_time < time) {
+            ++index;
+        }
+        return index;
+    }
+    const double width = _bin_widths[interface];
+    auto bin = size_t(time / width);
+    if (bin > 0 && bin * width > time) {
+        --bin;  // guard against round-off in time / width
+    }
+    if (bin >= bins.size()) {
+        return verbs.size();
+    }
+    size_t index = bins[bin];
+    while (index < verbs.size() && verbs[index]->travel_time < time) {
+        ++index;
+    }
+    return index;
 }
 
 /**
  * Adds a new biverb to this collection.
  */
-void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
-                                   const eigenverb_model::csptr& rcv_verb,
+void biverb_collection::add_biverb(const eigenverb_model& src_verb,
+                                   const eigenverb_model& rcv_verb,
                                    const vector<double>& scatter,
                                    size_t interface) {
+    auto verb = create_biverb(src_verb, rcv_verb, scatter);
+    if (verb != nullptr) {
+        write_lock_guard guard(_mutex);
+        _collection[interface].push_back(verb);
+        _sorted[interface] = 0;
+    }
+}
+
+/**
+ * Adds a group of existing biverbs to this collection.
+ */
+void biverb_collection::add_biverbs(
+    const std::vector<biverb_model::csptr>& verbs, size_t interface) {
     write_lock_guard guard(_mutex);
+    auto& collection = _collection[interface];
+    collection.insert(collection.end(), verbs.begin(), verbs.end());
+    _sorted[interface] = 0;
+}
+
+/**
+ * Constructs a new bistatic eigenverb.
+ */
+biverb_model::csptr biverb_collection::create_biverb(
+    const eigenverb_model& src_verb, const eigenverb_model& rcv_verb,
+    const vector<double>& scatter) {
 
     // determine relative range and bearing between Gaussians
 
     double bearing;
     const double range =
-        rcv_verb->position.gc_range(src_verb->position, &bearing);
+        rcv_verb.position.gc_range(src_verb.position, &bearing);
 
     if (range < 1e-6) {
         bearing = 0;  // fixes bearing = NaN
     }
-    bearing -= rcv_verb->direction;  // relative bearing
+    bearing -= rcv_verb.direction;  // relative bearing
 
     const double ys = range * cos(bearing);
     const double ys2 = ys * ys;
@@ -69,69 +190,69 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
     cout << "biverb_generator::compute_overlap() " << endl
          << "\txs2=" << xs2 << " ys2=" << ys2 << " scatter=" << scatter << endl
          << "\tsrc_verb"
-         << " t=" << src_verb->travel_time
-         << " de=" << to_degrees(src_verb->source_de)
-         << " az=" << to_degrees(src_verb->source_az)
-         << " direction=" << to_degrees(src_verb->direction)
-         << " grazing=" << to_degrees(src_verb->grazing) << endl
-         << "\tpower=" << 10.0 * log10(src_verb->power)
-         << " length=" << src_verb->length << " width=" << src_verb->width
-         << " surface=" << src_verb->surface << " bottom=" << src_verb->bottom
-         << " caustic=" << src_verb->caustic << endl
+         << " t=" << src_verb.travel_time
+         << " de=" << to_degrees(src_verb.source_de)
+         << " az=" << to_degrees(src_verb.source_az)
+         << " direction=" << to_degrees(src_verb.direction)
+         << " grazing=" << to_degrees(src_verb.grazing) << endl
+         << "\tpower=" << 10.0 * log10(src_verb.power)
+         << " length=" << src_verb.length << " width=" << src_verb.width
+         << " surface=" << src_verb.surface << " bottom=" << src_verb.bottom
+         << " caustic=" << src_verb.caustic << endl
          << "\trcv_verb"
-         << " t=" << rcv_verb->travel_time
-         << " de=" << to_degrees(rcv_verb->source_de)
-         << " az=" << to_degrees(rcv_verb->source_az)
-         << " direction=" << to_degrees(rcv_verb->direction)
-         << " grazing=" << to_degrees(rcv_verb->grazing) << endl
-         << "\tpower=" << 10.0 * log10(rcv_verb->power)
-         << " length=" << rcv_verb->length << " width=" << rcv_verb->width
-         << " surface=" << rcv_verb->surface << " bottom=" << rcv_verb->bottom
-         << " caustic=" << rcv_verb->caustic << endl;
+         << " t=" << rcv_verb.travel_time
+         << " de=" << to_degrees(rcv_verb.source_de)
+         << " az=" << to_degrees(rcv_verb.source_az)
+         << " direction=" << to_degrees(rcv_verb.direction)
+         << " grazing=" << to_degrees(rcv_verb.grazing) << endl
+         << "\tpower=" << 10.0 * log10(rcv_verb.power)
+         << " length=" << rcv_verb.length << " width=" << rcv_verb.width
+         << " surface=" << rcv_verb.surface << " bottom=" << rcv_verb.bottom
+         << " caustic=" << rcv_verb.caustic << endl;
 #endif
     // copy data from source and receiver eigenverbs
 
     auto* biverb = new biverb_model();
-    biverb->travel_time = src_verb->travel_time + rcv_verb->travel_time;
-    biverb->frequencies = rcv_verb->frequencies;
-    biverb->de_index = rcv_verb->de_index;
-    biverb->az_index = rcv_verb->az_index;
+    biverb->travel_time = src_verb.travel_time + rcv_verb.travel_time;
+    biverb->frequencies = rcv_verb.frequencies;
+    biverb->de_index = rcv_verb.de_index;
+    biverb->az_index = rcv_verb.az_index;
 
-    biverb->source_de = src_verb->source_de;
-    biverb->source_az = src_verb->source_az;
+    biverb->source_de = src_verb.source_de;
+    biverb->source_az = src_verb.source_az;
 
-    biverb->source_surface = src_verb->surface;
-    biverb->source_bottom = src_verb->bottom;
-    biverb->source_caustic = src_verb->caustic;
-    biverb->source_upper = src_verb->upper;
-    biverb->source_lower = src_verb->lower;
+    biverb->source_surface = src_verb.surface;
+    biverb->source_bottom = src_verb.bottom;
+    biverb->source_caustic = src_verb.caustic;
+    biverb->source_upper = src_verb.upper;
+    biverb->source_lower = src_verb.lower;
 
-    biverb->receiver_de = rcv_verb->source_de;
-    biverb->receiver_az = rcv_verb->source_az;
+    biverb->receiver_de = rcv_verb.source_de;
+    biverb->receiver_az = rcv_verb.source_az;
 
-    biverb->receiver_surface = rcv_verb->surface;
-    biverb->receiver_bottom = rcv_verb->bottom;
-    biverb->receiver_caustic = rcv_verb->caustic;
-    biverb->receiver_upper = rcv_verb->upper;
-    biverb->receiver_lower = rcv_verb->lower;
+    biverb->receiver_surface = rcv_verb.surface;
+    biverb->receiver_bottom = rcv_verb.bottom;
+    biverb->receiver_caustic = rcv_verb.caustic;
+    biverb->receiver_upper = rcv_verb.upper;
+    biverb->receiver_lower = rcv_verb.lower;
 
     // determine the relative tilt between the projected Gaussians
 
-    const double alpha = src_verb->direction - rcv_verb->direction;
+    const double alpha = src_verb.direction - rcv_verb.direction;
     const double cos2alpha = cos(2.0 * alpha);
     const double sin2alpha = sin(2.0 * alpha);
 
     // compute commonly used terms in the intersection of the Gaussian
     // profiles
 
-    auto src_length2 = src_verb->length * src_verb->length;
-    auto src_width2 = src_verb->width * src_verb->width;
+    auto src_length2 = src_verb.length * src_verb.length;
+    auto src_width2 = src_verb.width * src_verb.width;
     const double src_sum = src_length2 + src_width2;
     const double src_diff = src_length2 - src_width2;
     const double src_prod = src_length2 * src_width2;
 
-    auto rcv_length2 = rcv_verb->length * rcv_verb->length;
-    auto rcv_width2 = rcv_verb->width * rcv_verb->width;
+    auto rcv_length2 = rcv_verb.length * rcv_verb.length;
+    auto rcv_width2 = rcv_verb.width * rcv_verb.width;
     const double rcv_sum = rcv_length2 + rcv_width2;
     const double rcv_diff = rcv_length2 - rcv_width2;
     const double rcv_prod = rcv_length2 * rcv_width2;
@@ -141,7 +262,7 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
 
     double det_sr = 0.5 * (2.0 * (src_prod + rcv_prod) + (src_sum * rcv_sum) -
                            (src_diff * rcv_diff) * cos2alpha);
-    biverb->power = 0.25 * 0.5 * src_verb->power * rcv_verb->power * scatter;
+    biverb->power = 0.25 * 0.5 * src_verb.power * rcv_verb.power * scatter;
 
     // compute the power of the exponential
     // equation (28) from the paper
@@ -173,19 +294,20 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
     // combine duration of the overlap with pulse length
     // equation (33) from the paper
 
-    const double factor = cos(rcv_verb->grazing) / rcv_verb->sound_speed;
+    const double factor = cos(rcv_verb.grazing) / rcv_verb.sound_speed;
     biverb->duration = 0.5 * factor * sqrt(sigma);
 #ifdef DEBUG_BIVERB
     cout << "\tcontribution duration=" << biverb->duration
          << " power=" << (10.0 * log10(biverb->power)) << endl;
 #endif
 
-    // add to collection
+    // discard biverbs below the power threshold
 
     auto verb = biverb_model::csptr(biverb);
-    if (norm_inf(biverb->power) >= power_threshold) {
-        _collection[interface].insert({verb->travel_time, verb});
+    if (norm_inf(biverb->power) < power_threshold) {
+        verb.reset();
     }
+    return verb;
 }
 
 /**
@@ -193,7 +315,6 @@ void biverb_collection::add_biverb(const eigenverb_model::csptr& src_verb,
  */
 void biverb_collection::write_netcdf(const char* filename,
                                      size_t interface) const {
-    read_lock_guard guard(_mutex);
     netCDF::NcFile nc_file(filename, netCDF::NcFile::replace);
 
     switch (interface) {
@@ -223,7 +344,7 @@ void biverb_collection::write_netcdf(const char* filename,
         } break;
     }
 
-    biverb_list list = biverbs(interface);
+    const auto list = biverbs_window(interface);
     if (list.empty()) {
         return;
     }
@@ -10,8 +10,8 @@
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/range/iterator_range.hpp>
 #include <cstddef>
-#include <map>
 #include <memory>
 #include <vector>
 
@@ -35,20 +35,39 @@ using namespace usml::threads;
  *      volume scattering layer, if it exists.
  *    - Subsequent columns provide the upper and lower
  *      interfaces for additional volume scattering layers.
+ *
+ * The biverbs for each interface are stored in a contiguous array sorted by
+ * travel time. Biverbs with the same travel time are kept in the order they
+ * were added. The array is divided into time bins of bin_width seconds,
+ * starting at zero, so that the biverbs for a window of travel times can be
+ * found without searching the whole array. New biverbs are appended
+ * to the end of the array, and the array is re-sorted on the next read.
  */
 class USML_DECLSPEC biverb_collection {
    public:
     /// Shared const pointer to an biverb _collection.
     typedef std::shared_ptr<const biverb_collection> csptr;
 
-    /// Map of biverbs, sorted by time.
-    typedef std::multimap<double, biverb_model::csptr> map;
+    /// Array of biverbs, sorted by time.
+    typedef std::vector<biverb_model::csptr> array;
+
+    /// Range of biverbs within an array, sorted by time.
+    typedef boost::iterator_range<array::const_iterator> range;
 
     /**
      * Threshold for minimum biverb power.
      */
     static double power_threshold;
 
+    /**
+     * Width of the time bins used to find biverbs by travel time (sec).
+     * Defaults to 0.1, the smallest time increment used by sensor_pair
+     * for reverberation time series. Each interface keeps the width that
+     * was in effect when its bins were built, so changing this only
+     * affects bins built later.
+     */
+    static double bin_width;
+
     /**
      * Construct a collection for a series of interfaces. Creates a minimum
      * of interfaces (index 0=bottom, 1=surface), plus two for each
@@ -57,7 +76,10 @@ class USML_DECLSPEC biverb_collection {
      * @param num_volumes    Number of volume scattering layers in the ocean.
      */
     biverb_collection(size_t num_volumes = 0)
-        : _collection((1 + num_volumes) * 2) {}
+        : _collection((1 + num_volumes) * 2),
+          _bins((1 + num_volumes) * 2),
+          _bin_widths((1 + num_volumes) * 2, bin_width),
+          _sorted((1 + num_volumes) * 2, true) {}
 
     /**
      * Number of interfaces in this collection.
@@ -84,6 +106,30 @@ class USML_DECLSPEC biverb_collection {
      */
     biverb_list biverbs(size_t interface) const;
 
+    /**
+     * All of the biverbs for a specific interface, sorted by travel time.
+     * Does not copy the biverbs. The range remains valid until the next
+     * biverb is added to this interface.
+     *
+     * @param interface Interface number of the desired list of biverbs.
+     */
+    range biverbs_window(size_t interface) const;
+
+    /**
+     * Biverbs for a specific interface, whose travel times are greater than or
+     * equal to time_min, and less than time_max. Uses the time bins to find
+     * the limits of the window. Does not copy the biverbs. The range remains
+     * valid until the next biverb is added to this interface. The
+     * rvbts_collection uses this window to find the biverbs that contribute
+     * to each chunk of a reverberation time series.
+     *
+     * @param interface Interface number of the desired list of biverbs.
+     * @param time_min  Earliest travel time in window (sec).
+     * @param time_max  Travel time just after the end of the window (sec).
+     */
+    range biverbs_window(size_t interface, double time_min,
+                         double time_max) const;
+
     /**
      * Constructs a new bistatic eigenverb and adds it to this collection. Note
      * that passing the scattering strength as an argument allows the same
@@ -94,9 +140,49 @@ class USML_DECLSPEC biverb_collection {
      * @param scatter	Scattering strength vs. frequency.
      * @param interface Interface number for this addition.
      */
+    void add_biverb(const eigenverb_model& src_verb,
+                    const eigenverb_model& rcv_verb,
+                    const vector<double>& scatter, size_t interface);
+
+    /**
+     * Constructs a new bistatic eigenverb from shared eigenverbs.
+     *
+     * @param src_verb	Source eigenverb to be processed.
+     * @param rcv_verb	Receiver eigenverb to be processed.
+     * @param scatter	Scattering strength vs. frequency.
+     * @param interface Interface number for this addition.
+     */
     void add_biverb(const eigenverb_model::csptr& src_verb,
                     const eigenverb_model::csptr& rcv_verb,
-                    const vector<double>& scatter, size_t interface);
+                    const vector<double>& scatter, size_t interface) {
+        add_biverb(*src_verb, *rcv_verb, scatter, interface);
+    }
+
+    /**
+     * Adds a group of existing biverbs to this collection, using a single
+     * lock for the whole group. Biverbs with the same travel time are kept
+     * in the order that they appear in the group.
+     *
+     * @param verbs     Biverbs to be added, usually from create_biverb().
+     * @param interface Interface number for this addition.
+     */
+    void add_biverbs(const std::vector<biverb_model::csptr>& verbs,
+                     size_t interface);
+
+    /**
+     * Constructs a new bistatic eigenverb without adding it to a collection.
+     * Does not modify any shared data, so it can be called from multiple
+     * threads at the same time.
+     *
+     * @param src_verb	Source eigenverb to be processed.
+     * @param rcv_verb	Receiver eigenverb to be processed.
+     * @param scatter	Scattering strength vs. frequency.
+     * @return          New biverb, or nullptr if its power is less than
+     *                  power_threshold.
+     */
+    static biverb_model::csptr create_biverb(const eigenverb_model& src_verb,
+                                             const eigenverb_model& rcv_verb,
+                                             const vector<double>& scatter);
 
     /**
      * Writes the biverbs for an individual interface to a netcdf file.
@@ -110,8 +196,35 @@ class USML_DECLSPEC biverb_collection {
     /// Mutex to that locks object during changes.
     mutable read_write_lock _mutex;
 
-    /// Spatial index for each interface.
-    std::vector<map> _collection;
+    /// Biverbs for each interface, sorted by time when _sorted is true.
+    mutable std::vector<array> _collection;
+
+    /// Index of first biverb in each time bin, for each interface.
+    mutable std::vector<std::vector<size_t>> _bins;
+
+    /// Width of the time bins in _bins, for each interface (sec).
+    mutable std::vector<double> _bin_widths;
+
+    /// True if biverbs and bins are up to date, for each interface.
+    mutable std::vector<char> _sorted;
+
+    /**
+     * Sorts the biverbs for one interface and rebuilds its time bins,
+     * if biverbs have been added since the last sort.
+     *
+     * @param interface Interface number to sort.
+     */
+    void sort_biverbs(size_t interface) const;
+
+    /**
+     * Index of the first biverb in a sorted interface, whose travel time is
+     * greater than or equal to a specific time. Caller must ensure that the
+     * interface is already sorted.
+     *
+     * @param interface Interface number to search.
+     * @param time      Travel time to search for (sec).
+     */
+    size_t find_time(size_t interface, double time) const;
 };
 
 /// @}
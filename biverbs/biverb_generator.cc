@@ -5,15 +5,21 @@
 
 #include <usml/biverbs/biverb_generator.h>
 #include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/eigenverbs/eigenverb_store.h>
 #include <usml/managed/managed_obj.h>
 #include <usml/ocean/ocean_model.h>
 #include <usml/ocean/ocean_shared.h>
 #include <usml/sensors/sensor_manager.h>
+#include <usml/threads/parallel_chunks.h>
 #include <usml/types/seq_vector.h>
 
 #include <boost/numeric/ublas/vector.hpp>
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace usml::biverbs;
 
@@ -33,6 +39,41 @@ biverb_generator::biverb_generator(
     add_listener(pair.get());
 }
 
+/**
+ * Number of threads used to compute biverbs for each sensor pair.
+ */
+unsigned biverb_generator::num_workers = std::thread::hardware_concurrency();
+
+/**
+ * Number of receiver eigenverbs processed as a single unit of work.
+ */
+size_t biverb_generator::chunk_size = 64;
+
+namespace {
+
+/**
+ * Contiguous range of receiver eigenverbs for one interface, and the
+ * biverbs that result from them.
+ */
+struct biverb_chunk {
+    size_t interface;
+    eigenverb_store::handle first;
+    eigenverb_store::handle last;
+    std::vector<biverb_model::csptr> biverbs;
+};
+
+/**
+ * Memory re-used by one worker for every receiver eigenverb.
+ */
+struct biverb_scratch {
+    eigenverb_model rcv_verb;
+    eigenverb_model src_verb;
+    std::vector<eigenverb_store::handle> found;
+    vector<double> scatter;
+};
+
+}  // namespace
+
 /**
  * Executes the Eigenverb reverberation model.
  */
@@ -45,35 +86,65 @@ void biverb_generator::run() {
     cout << "task #" << id()
          << " biverb_generator: " << _sensor_pair->description() << endl;
 
-    // initialize workspace for results
-
-    auto ocean = ocean_shared::current();
-    auto freq = sensor_manager::instance()->frequencies();
-    const size_t num_freq = freq->size();
-    vector<double> scatter(num_freq, 0.0);
-    auto* collection = new biverb_collection(ocean->num_volume());
-
-    // loop through eigenverbs for each interface
+    // split receiver eigenverbs for each interface into chunks
 
+    const ocean_model::csptr ocean = ocean_shared::current();
+    const size_t num_freq = sensor_manager::instance()->frequencies()->size();
+    std::vector<biverb_chunk> chunks;
+    const size_t step = std::max(chunk_size, size_t(1));
     auto num_interfaces = _rcv_eigenverbs->num_interfaces();
     for (size_t interface = 0; interface < num_interfaces; ++interface) {
-        for (const auto& rcv_verb : _rcv_eigenverbs->eigenverbs(interface)) {
-            eigenverb_list found_verbs =
-                _src_eigenverbs->find_eigenverbs(rcv_verb, interface);
-            for (const auto& src_verb : found_verbs) {
-                ocean->scattering(interface, rcv_verb->position,
-                                  rcv_verb->frequencies, src_verb->grazing,
-                                  rcv_verb->grazing, src_verb->direction,
-                                  rcv_verb->direction, &scatter);
-                collection->add_biverb(src_verb, rcv_verb, scatter, interface);
-                if (_abort) {
-                    cout << "task #" << id()
-                         << " biverb_generator *** aborted during execution ***"
-                         << endl;
-                    return;
+        const size_t num_verbs = _rcv_eigenverbs->store(interface).size();
+        for (size_t first = 0; first < num_verbs; first += step) {
+            chunks.push_back(
+                {interface, first, std::min(first + step, num_verbs), {}});
+        }
+    }
+
+    // process chunks on this thread and on helper tasks in the thread pool,
+    // if there are no receiver eigenverbs, skip straight to publishing
+    // an empty collection
+
+    std::vector<biverb_scratch> scratch(
+        parallel_chunks::num_threads(chunks.size(), num_workers),
+        {{}, {}, {}, vector<double>(num_freq, 0.0)});
+    auto process = [&](size_t index, size_t worker) {
+        biverb_scratch& work = scratch[worker];
+        auto& chunk = chunks[index];
+        const auto& rcv_store = _rcv_eigenverbs->store(chunk.interface);
+        const auto& src_store = _src_eigenverbs->store(chunk.interface);
+        for (auto rcv = chunk.first; rcv < chunk.last; ++rcv) {
+            rcv_store.get(rcv, &work.rcv_verb);
+            _src_eigenverbs->find_handles(work.rcv_verb, chunk.interface,
+                                          &work.found);
+            for (auto src : work.found) {
+                src_store.get(src, &work.src_verb);
+                ocean->scattering(
+                    chunk.interface, work.rcv_verb.position,
+                    work.rcv_verb.frequencies, work.src_verb.grazing,
+                    work.rcv_verb.grazing, work.src_verb.direction,
+                    work.rcv_verb.direction, &work.scatter);
+                auto verb = biverb_collection::create_biverb(
+                    work.src_verb, work.rcv_verb, work.scatter);
+                if (verb != nullptr) {
+                    chunk.biverbs.push_back(verb);
                 }
             }
         }
+    };
+    if (!parallel_chunks::run(chunks.size(), num_workers, process, &_abort) ||
+        _abort) {
+        cout << "task #" << id()
+             << " biverb_generator *** aborted during execution ***" << endl;
+        return;
+    }
+
+    // merge results in chunk order, so biverbs with the same travel time
+    // are stored in the same order for any number of workers
+
+    auto* collection = new biverb_collection(ocean->num_volume());
+    for (const auto& chunk : chunks) {
+        collection->add_biverbs(chunk.biverbs, chunk.interface);
     }
     _collection = biverb_collection::csptr(collection);
     _done = true;
@@ -11,6 +11,8 @@
 #include <usml/threads/thread_task.h>
 #include <usml/usml_config.h>
 
+#include <cstddef>
+
 namespace usml {
 namespace biverbs {
 
@@ -34,6 +36,19 @@ class USML_DECLSPEC biverb_generator
     : public thread_task,
       public update_notifier<biverb_collection::csptr> {
    public:
+    /**
+     * Number of threads used to compute biverbs for each sensor pair,
+     * including the thread running this task. Defaults to the number of cores
+     * on this machine. A value of one computes all biverbs on this thread.
+     */
+    static unsigned num_workers;
+
+    /**
+     * Number of receiver eigenverbs processed as a single unit of work.
+     * Defaults to 64.
+     */
+    static size_t chunk_size;
+
     /**
      * Initialize model parameters and reserve memory. Note that passing the
      * src_eigenverbs and rcv_eigenverbs of the pair as their own arguments
@@ -57,6 +72,13 @@ class USML_DECLSPEC biverb_generator
      * Executes the Eigenverb reverberation model. For each receiver eigenverb,
      * it loops through the list of source eigenverbs looking for overlaps.
      *
+     * The receiver eigenverbs for each interface are split into chunks of
+     * chunk_size eigenverbs. This task, and up to num_workers-1 helper tasks
+     * in the thread pool, claim chunks until none remain. Each chunk
+     * accumulates its biverbs in its own buffer, and the buffers are merged
+     * in chunk order when all chunks are complete. The result is independent
+     * of the number of workers.
+     *
      * First, it computes the great circle range and bearing of the source
      * relative to the receiver.  The combination is skipped if the location of
      * the source (its peak intensity) is more than three (3) times the
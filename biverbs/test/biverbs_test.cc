@@ -23,6 +23,7 @@
 #include <iostream>
 #include <list>
 #include <memory>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(biverbs_test)
 
@@ -144,8 +145,8 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
 
     auto collection = pair->biverbs();
     biverb_list verb_list = collection->biverbs(eigenverb_model::BOTTOM);
-    BOOST_CHECK_EQUAL(verb_list.size(), 182);
-    BOOST_CHECK_EQUAL(collection->size(eigenverb_model::BOTTOM), 182);
+    BOOST_CHECK_EQUAL(verb_list.size(), 144);
+    BOOST_CHECK_EQUAL(collection->size(eigenverb_model::BOTTOM), 144);
     {
         std::ostringstream filename;
         filename << ncname << "biverbs_test.nc";
@@ -156,6 +157,148 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     sensor_manager::reset();
 }
 
+/**
+ * Tests that the biverbs computed with multiple workers match those computed
+ * serially. Uses a small chunk size, so that the receiver eigenverbs are split
+ * across many chunks, and compares biverbs in the order they are stored.
+ * Also checks that empty receiver eigenverbs produce an empty collection.
+ */
+BOOST_AUTO_TEST_CASE(parallel_biverbs) {
+    cout << "=== biverbs_test: parallel_biverbs ===" << endl;
+    sensor_manager* smgr = sensor_manager::instance();
+
+    ocean_utils::make_iso(depth);
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    smgr->frequencies(frequencies);
+
+    sensor_model* sensor_ptr = new test::simple_sonobuoy(1, "simple_sonobuoy");
+    sensor_ptr->time_maximum(7.0);
+    sensor_ptr->compute_reverb(true);
+    sensor_model::sptr sensor(sensor_ptr);
+    smgr->add_sensor(sensor);
+    thread_task::wait();  // let wavefront launched by add_sensor() finish
+    sensor_pair::sptr pair = *(smgr->find_source(1).begin());
+
+    auto* verb_collection = new eigenverb_collection(0, true);
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            verb_collection->add_eigenverb(
+                create_eigenverb(sensor->position(), depth, de, az,
+                                 frequencies),
+                eigenverb_model::BOTTOM);
+        }
+    }
+    eigenverb_collection::csptr verbs(verb_collection);
+    wposition1 pos1 = sensor->position();
+    wposition pos(pos1);
+    eigenray_collection::csptr rays(
+        new eigenray_collection(frequencies, pos1, pos));
+
+    // compute biverbs serially, and then with multiple workers
+
+    const unsigned num_workers = biverb_generator::num_workers;
+    const size_t chunk_size = biverb_generator::chunk_size;
+    biverb_generator::chunk_size = 7;
+    biverb_list results[2];
+    const unsigned workers[2] = {1, 4};
+    for (size_t n = 0; n < 2; ++n) {
+        biverb_generator::num_workers = workers[n];
+        pair->update_wavefront_data(sensor.get(), rays, verbs);
+        thread_task::wait();
+        results[n] = pair->biverbs()->biverbs(eigenverb_model::BOTTOM);
+    }
+    biverb_generator::num_workers = num_workers;
+    biverb_generator::chunk_size = chunk_size;
+
+    BOOST_CHECK_EQUAL(results[0].size(), 144);
+    BOOST_CHECK_EQUAL(results[1].size(), results[0].size());
+    auto iter = results[1].begin();
+    for (const auto& serial : results[0]) {
+        const auto& parallel = *iter++;
+        BOOST_CHECK_EQUAL(parallel->travel_time, serial->travel_time);
+        BOOST_CHECK_EQUAL(parallel->power[0], serial->power[0]);
+        BOOST_CHECK_EQUAL(parallel->duration, serial->duration);
+    }
+
+    // an empty set of receiver eigenverbs publishes an empty collection
+
+    eigenverb_collection::csptr empty(new eigenverb_collection(0, true));
+    pair->update_wavefront_data(sensor.get(), rays, empty);
+    thread_task::wait();
+    BOOST_CHECK(pair->biverbs()->biverbs(eigenverb_model::BOTTOM).empty());
+    sensor_manager::reset();
+}
+
+/**
+ * Tests the ability to find biverbs by travel time. Adds biverbs out of order,
+ * including several with the same travel time, and with travel times that
+ * fall exactly on the edges of the time bins. Checks that windows include
+ * their start time, exclude their end time, and keep biverbs with the same
+ * travel time in the order that they were added. Also checks that changing
+ * bin_width after the bins are built does not change the windows.
+ */
+BOOST_AUTO_TEST_CASE(biverbs_window) {
+    cout << "=== biverbs_test: biverbs_window ===" << endl;
+
+    const double times[] = {0.35, 0.1, 0.2, 0.2, 0.05, 0.2, 1.0, 0.0, 0.45};
+    biverb_collection collection;
+    std::vector<biverb_model::csptr> verbs;
+    for (size_t n = 0; n < sizeof(times) / sizeof(double); ++n) {
+        auto verb = std::make_shared<biverb_model>();
+        verb->travel_time = times[n];
+        verb->de_index = n;
+        verbs.push_back(verb);
+    }
+    collection.add_biverbs(verbs, eigenverb_model::BOTTOM);
+    BOOST_CHECK_EQUAL(collection.size(eigenverb_model::BOTTOM), verbs.size());
+
+    // full range is sorted by time, stable for equal times
+
+    auto all = collection.biverbs_window(eigenverb_model::BOTTOM);
+    std::vector<size_t> order;
+    for (const auto& verb : all) {
+        order.push_back(verb->de_index);
+    }
+    std::vector<size_t> expected = {7, 4, 1, 2, 3, 5, 0, 8, 6};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(),
+                                  expected.end());
+
+    // windows include their start time and exclude their end time
+
+    auto window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.1, 0.35);
+    BOOST_CHECK_EQUAL(window.size(), 4);
+    BOOST_CHECK_EQUAL(window.front()->travel_time, 0.1);
+    BOOST_CHECK_EQUAL(window.back()->de_index, 5);
+
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.4, 10.0);
+    BOOST_CHECK_EQUAL(window.size(), 2);
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, -1.0, 0.01);
+    BOOST_CHECK_EQUAL(window.size(), 1);
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 2.0, 3.0);
+    BOOST_CHECK(window.empty());
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.3, 0.2);
+    BOOST_CHECK(window.empty());
+
+    // bins keep the width in effect when they were built
+
+    const double bin_width = biverb_collection::bin_width;
+    biverb_collection::bin_width = 0.01;
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.1, 0.35);
+    BOOST_CHECK_EQUAL(window.size(), 4);
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.4, 10.0);
+    BOOST_CHECK_EQUAL(window.size(), 2);
+    biverb_collection::bin_width = bin_width;
+
+    // biverbs added later are merged into the sorted order
+
+    auto verb = std::make_shared<biverb_model>();
+    verb->travel_time = 0.15;
+    collection.add_biverbs({verb}, eigenverb_model::BOTTOM);
+    window = collection.biverbs_window(eigenverb_model::BOTTOM, 0.1, 0.2);
+    BOOST_CHECK_EQUAL(window.size(), 2);
+    BOOST_CHECK_EQUAL(window.back()->travel_time, 0.15);
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
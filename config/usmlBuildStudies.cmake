@@ -11,6 +11,9 @@ target_link_libraries( ray_speed usml )
 add_executable( cmp_speed studies/cmp_speed/cmp_speed.cc )
 target_link_libraries( cmp_speed usml )
 
+add_executable( rvbts_speed studies/rvbts_speed/rvbts_speed.cc )
+target_link_libraries( rvbts_speed usml )
+
 add_executable( pedersen_test studies/pedersen/pedersen_test.cc )
 target_link_libraries( pedersen_test usml )
 
@@ -4,6 +4,7 @@
  */
 
 #include <usml/eigenrays/eigenray_collection.h>
+#include <usml/threads/parallel_chunks.h>
 #include <usml/types/wvector1.h>
 #include <usml/ublas/math_traits.h>
 #include <usml/netcdf-cxx/netcdfcpp.h>
@@ -14,8 +15,12 @@
 #include <cmath>
 #include <complex>
 #include <list>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace usml::eigenrays;
+using namespace usml::threads;
 
 /**
  * Initialize the acoustic propagation effects associated
@@ -36,7 +41,8 @@ eigenray_collection::eigenray_collection(const seq_vector::csptr &frequencies,
       _initial_time(target_pos.size1(), target_pos.size2()),
       _num_eigenrays(0),
       _total(target_pos.size1(), target_pos.size2()),
-      _coherent(coherent) {
+      _coherent(coherent),
+      _is_final(target_pos.size1(), target_pos.size2(), false) {
     for (size_t t1 = 0; t1 < size1(); ++t1) {
         for (size_t t2 = 0; t2 < size2(); ++t2) {
             eigenray_model loss;
@@ -51,36 +57,104 @@ eigenray_collection::eigenray_collection(const seq_vector::csptr &frequencies,
             } else {
                 _targetIDs(t1, t2) = 0;
             }
+            _target_index.emplace(_targetIDs(t1, t2), std::make_pair(t1, t2));
         }
     }
 }
 
+/**
+ * Initialize as a view of a single target in a parent collection.
+ */
+eigenray_collection::eigenray_collection(
+    const csptr &parent, uint64_t targetID, const wposition1 &source_pos,
+    const wposition1 &target_pos, uint64_t sourceID, uint64_t viewID,
+    bool reciprocal)
+    : _parent(parent),
+      _reciprocal(reciprocal),
+      _sourceID(sourceID),
+      _targetIDs(1, 1),
+      _source_pos(source_pos),
+      _target_pos(target_pos),
+      _frequencies(parent->frequencies()),
+      _eigenrays(1, 1),
+      _initial_time(1, 1),
+      _num_eigenrays(0),
+      _total(1, 1),
+      _coherent(parent->coherent()),
+      _is_final(1, 1, false) {
+    _targetIDs(0, 0) = viewID;
+    _target_index.emplace(viewID, std::make_pair(0, 0));
+    if (!parent->find_target(targetID, &_parent_t1, &_parent_t2)) {
+        _parent.reset();  // empty collection
+        eigenray_model loss;
+        loss.intensity.resize(_frequencies->size());
+        loss.intensity.clear();
+        loss.phase.resize(_frequencies->size());
+        loss.phase.clear();
+        _total(0, 0) = loss;
+        _initial_time(0, 0) = 0.0;
+        sum_eigenrays();
+        return;
+    }
+
+    // share the totals computed by the parent
+
+    _num_eigenrays = (int)parent->eigenrays(_parent_t1, _parent_t2).size();
+    _initial_time(0, 0) = parent->initial_time(_parent_t1, _parent_t2);
+    _total(0, 0) = parent->total(_parent_t1, _parent_t2);
+    if (_reciprocal) {
+        eigenray_model &total = _total(0, 0);
+        std::swap(total.source_de, total.target_de);
+        std::swap(total.source_az, total.target_az);
+    }
+}
+
+/**
+ * Find the row and column of a single target in the grid.
+ */
+bool eigenray_collection::find_target(uint64_t targetID, size_t *t1,
+                                      size_t *t2) const {
+    if (size1() == 0 || size2() == 0) {
+        return false;
+    }
+    if (targetID == 0) {
+        *t1 = 0;
+        *t2 = 0;
+        return true;
+    }
+    const auto found = _target_index.find(targetID);
+    if (found == _target_index.end()) {
+        return false;
+    }
+    *t1 = found->second.first;
+    *t2 = found->second.second;
+    return true;
+}
+
 /**
  * Find eigenrays for a single target in the grid.
  */
-eigenray_list eigenray_collection::find_eigenrays(uint64_t targetID) const {
-    for (size_t t1 = 0; t1 < size1(); ++t1) {
-        for (size_t t2 = 0; t2 < size2(); ++t2) {
-            if (_targetIDs(t1, t2) == targetID || targetID == 0) {
-                return eigenrays(t1, t2);
-            }
-        }
+const eigenray_list &eigenray_collection::find_eigenrays(
+    uint64_t targetID) const {
+    static const eigenray_list empty;
+    size_t t1;
+    size_t t2;
+    if (!find_target(targetID, &t1, &t2)) {
+        return empty;
     }
-    return {};
+    return eigenrays(t1, t2);
 }
 
 /**
  * Find fastest eigenray for a single target in the grid.
  */
 double eigenray_collection::find_initial_time(uint64_t targetID) const {
-    for (size_t t1 = 0; t1 < size1(); ++t1) {
-        for (size_t t2 = 0; t2 < size2(); ++t2) {
-            if (_targetIDs(t1, t2) == targetID || targetID == 0) {
-                return initial_time(t1, t2);
-            }
-        }
+    size_t t1;
+    size_t t2;
+    if (!find_target(targetID, &t1, &t2)) {
+        return 0.0;
     }
-    return 0.0;
+    return initial_time(t1, t2);
 }
 
 /**
@@ -90,104 +164,223 @@ double eigenray_collection::find_initial_time(uint64_t targetID) const {
 void eigenray_collection::add_eigenray(size_t t1, size_t t2,
                                        eigenray_model::csptr ray,
                                        size_t /*runID*/) {
+    if (_is_final(t1, t2)) {
+        return;  // ignore late arrivals
+    }
     _eigenrays(t1, t2).push_back(ray);
     auto old_initial = _initial_time(t1, t2);
     auto new_initial = ray->travel_time;
     if (old_initial <= 0.0 || old_initial > new_initial) {
         _initial_time(t1, t2) = new_initial;
+        if (_finalize_margin > 0.0) {
+            _pending.emplace(new_initial + _finalize_margin,
+                             t1 * size2() + t2);
+        }
     }
     ++_num_eigenrays;
 }
 
+/**
+ * Finalizes each target whose first eigenray arrived more than
+ * finalize_margin() seconds before this wavefront time.
+ */
+void eigenray_collection::check_eigenrays(double wave_time, size_t runID) {
+    _runID = runID;
+    while (!_pending.empty() && _pending.top().first <= wave_time) {
+        const size_t n = _pending.top().second;
+        _pending.pop();
+        const size_t t1 = n / size2();
+        const size_t t2 = n % size2();
+        if (!_is_final(t1, t2)) {
+            sum_targets(n, n + 1);
+            _is_final(t1, t2) = true;
+            notify_target_listeners(t1, t2);
+        }
+    }
+}
+
+/**
+ * Add a listener for finalized targets.
+ */
+void eigenray_collection::add_target_listener(
+    eigenray_target_listener *listener) {
+    _target_listeners.insert(listener);
+}
+
+/**
+ * Remove a listener for finalized targets.
+ */
+void eigenray_collection::remove_target_listener(
+    eigenray_target_listener *listener) {
+    _target_listeners.erase(listener);
+}
+
+/**
+ * Passes a finalized target to each target listener.
+ */
+void eigenray_collection::notify_target_listeners(size_t t1,
+                                                  size_t t2) const {
+    for (eigenray_target_listener *listener : _target_listeners) {
+        listener->finalize_target(*this, t1, t2, _runID);
+    }
+}
+
+/**
+ * Number of threads used to sum eigenrays.
+ */
+unsigned eigenray_collection::num_workers =
+    std::thread::hardware_concurrency();
+
+/**
+ * Number of targets summed as a single unit of work.
+ */
+size_t eigenray_collection::chunk_size = 64;
+
 /**
  * Compute propagation loss summed over all eigenrays.
  */
 void eigenray_collection::sum_eigenrays() {
-    for (size_t t1 = 0; t1 < size1(); ++t1) {
-        for (size_t t2 = 0; t2 < size2(); ++t2) {
-            const eigenray_list &ray_list = eigenrays(t1, t2);
-            eigenray_model &total = _total(t1, t2);
-
-            double time = 0.0;
-            double source_de = 0.0;
-            double source_az_x = 0.0;  // east/west component
-            double source_az_y = 0.0;  // north/south component
-            double target_de = 0.0;
-            double target_az_x = 0.0;  // east/west component
-            double target_az_y = 0.0;  // north/south component
-            int surface = -1;
-            int bottom = -1;
-            int caustic = -1;
-            int upper = -1;
-            int lower = -1;
+    const size_t num_targets = size1() * size2();
+    const size_t chunk = std::max(chunk_size, size_t(1));
+    const size_t num_chunks = (num_targets + chunk - 1) / chunk;
+    parallel_chunks::run(num_chunks, num_workers,
+                         [this, chunk, num_targets](size_t index, size_t) {
+                             const size_t first = index * chunk;
+                             sum_targets(first,
+                                         std::min(first + chunk, num_targets));
+                         });
+
+    // pass the targets summed here to the target listeners
+
+    if (!_target_listeners.empty()) {
+        for (size_t t1 = 0; t1 < size1(); ++t1) {
+            for (size_t t2 = 0; t2 < size2(); ++t2) {
+                if (!_is_final(t1, t2)) {
+                    notify_target_listeners(t1, t2);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Compute propagation loss summed over all eigenrays for a range of targets.
+ */
+void eigenray_collection::sum_targets(size_t first, size_t last) {
+    static const double DB_TO_PRESSURE = M_LN10 / -20.0;
+    const size_t num_freq = _frequencies->size();
+    std::vector<double> travel_time;
+    std::vector<double> weight;
+    std::vector<double> amplitude;  // frequency major order
+    std::vector<double> phase;      // frequency major order
+
+    for (size_t n = first; n < last; ++n) {
+        const size_t t1 = n / size2();
+        const size_t t2 = n % size2();
+        if (_is_final(t1, t2)) {
+            continue;  // already summed by check_eigenrays()
+        }
+        const eigenray_list &ray_list = eigenrays(t1, t2);
+        eigenray_model &total = _total(t1, t2);
+
+        // copy eigenrays into contiguous arrays, and compute the
+        // pressure amplitude of each eigenray at each frequency
+
+        const size_t num_rays = ray_list.size();
+        travel_time.resize(num_rays);
+        weight.resize(num_rays);
+        amplitude.resize(num_rays * num_freq);
+        phase.resize(num_rays * num_freq);
+        const eigenray_model *strongest = nullptr;
+        double max_a = 0.0;
+        size_t r = 0;
+        for (const auto &ray : ray_list) {
+            travel_time[r] = ray->travel_time;
             double wgt = 0.0;
-            double max_a = 0.0;
-
-            // compute at each frequency
-
-            for (size_t f = 0; f < _frequencies->size(); ++f) {
-                // sum complex amplitudes over eigenrays
-
-                std::complex<double> phasor(0.0, 0.0);
-                for (const auto &ray : ray_list) {
-                    // pressure amplitude
-
-                    double a =
-                        pow(10.0, ray->intensity(f) / -20.0);  // pressure
-                    if (_coherent) {
-                        double p =
-                            TWO_PI * (*_frequencies)(f)*ray->travel_time +
-                            ray->phase(f);
-                        p = fmod(p, TWO_PI);  // large phases bad for cos,sin
-                        std::complex<double> value(a * cos(p), a * sin(p));
-                        phasor += value;
-                    } else {
-                        phasor += a;
-                    }
-
-                    // other eigenray terms
-
-                    a *= a;  // scale by the pressure squared
-                    wgt += a;
-                    time += a * ray->travel_time;
-                    source_de += a * ray->source_de;
-                    source_az_x += a * sin(to_radians(ray->source_az));
-                    source_az_y += a * cos(to_radians(ray->source_az));
-                    target_de += a * ray->target_de;
-                    target_az_x += a * sin(to_radians(ray->target_az));
-                    target_az_y += a * cos(to_radians(ray->target_az));
-                    if (a > max_a) {
-                        max_a = a;
-                        surface = ray->surface;
-                        bottom = ray->bottom;
-                        caustic = ray->caustic;
-                        upper = ray->upper;
-                        lower = ray->lower;
-                    }
-                }  // end eigenray_list
-
-                // convert back into intensity (dB) and phase (radians) values
-
-                total.intensity(f) = -20.0 * log10(max(1e-15, abs(phasor)));
-                total.phase(f) = arg(phasor);
-            }  // end frequency
-
-            // weighted average of other eigenray terms
-
-            total.travel_time = time / wgt;
-            total.source_de = source_de / wgt;
-            total.source_az =
-                90.0 - to_degrees(atan2(source_az_y, source_az_x));
-            total.target_de = target_de / wgt;
-            total.target_az =
-                90.0 - to_degrees(atan2(target_az_y, target_az_x));
-            total.surface = surface;
-            total.bottom = bottom;
-            total.caustic = caustic;
-            total.upper = upper;
-            total.lower = lower;
-        }  // end target size2
-    }      // end target size1
+            for (size_t f = 0; f < num_freq; ++f) {
+                const double a = exp(ray->intensity(f) * DB_TO_PRESSURE);
+                amplitude[f * num_rays + r] = a;
+                phase[f * num_rays + r] = ray->phase(f);
+                const double a2 = a * a;  // scale by the pressure squared
+                wgt += a2;
+                if (a2 > max_a) {
+                    max_a = a2;
+                    strongest = ray.get();
+                }
+            }
+            weight[r] = wgt;
+            ++r;
+        }
+
+        // sum complex amplitudes over eigenrays at each frequency
+
+        for (size_t f = 0; f < num_freq; ++f) {
+            const double *a = &amplitude[f * num_rays];
+            const double *p = &phase[f * num_rays];
+            double real = 0.0;
+            double imag = 0.0;
+            if (_coherent) {
+                const double omega = TWO_PI * (*_frequencies)(f);
+                for (r = 0; r < num_rays; ++r) {
+                    // large phases bad for cos,sin
+                    const double angle =
+                        fmod(omega * travel_time[r] + p[r], TWO_PI);
+                    real += a[r] * cos(angle);
+                    imag += a[r] * sin(angle);
+                }
+            } else {
+                for (r = 0; r < num_rays; ++r) {
+                    real += a[r];
+                }
+            }
+
+            // convert back into intensity (dB) and phase (radians) values
+
+            const std::complex<double> phasor(real, imag);
+            total.intensity(f) = -20.0 * log10(max(1e-15, abs(phasor)));
+            total.phase(f) = arg(phasor);
+        }
+
+        // weighted average of other eigenray terms, where the weight of
+        // each eigenray is its pressure squared summed over frequency
+
+        double wgt = 0.0;
+        double time = 0.0;
+        double source_de = 0.0;
+        double source_az_x = 0.0;  // east/west component
+        double source_az_y = 0.0;  // north/south component
+        double target_de = 0.0;
+        double target_az_x = 0.0;  // east/west component
+        double target_az_y = 0.0;  // north/south component
+        r = 0;
+        for (const auto &ray : ray_list) {
+            const double a = weight[r++];
+            const double source_az = to_radians(ray->source_az);
+            const double target_az = to_radians(ray->target_az);
+            wgt += a;
+            time += a * ray->travel_time;
+            source_de += a * ray->source_de;
+            source_az_x += a * sin(source_az);
+            source_az_y += a * cos(source_az);
+            target_de += a * ray->target_de;
+            target_az_x += a * sin(target_az);
+            target_az_y += a * cos(target_az);
+        }
+        total.travel_time = time / wgt;
+        total.source_de = source_de / wgt;
+        total.source_az = 90.0 - to_degrees(atan2(source_az_y, source_az_x));
+        total.target_de = target_de / wgt;
+        total.target_az = 90.0 - to_degrees(atan2(target_az_y, target_az_x));
+
+        // number of surface bounces, bottom bounces, and caustics are
+        // taken from the strongest path
+
+        total.surface = (strongest != nullptr) ? strongest->surface : -1;
+        total.bottom = (strongest != nullptr) ? strongest->bottom : -1;
+        total.caustic = (strongest != nullptr) ? strongest->caustic : -1;
+        total.upper = (strongest != nullptr) ? strongest->upper : -1;
+        total.lower = (strongest != nullptr) ? strongest->lower : -1;
+    }
 }
 
 /**
@@ -317,14 +510,15 @@ void eigenray_collection::write_netcdf(const char *filename,
         row_col_index[0] = t1;
         for (size_t t2 = 0; t2 < _target_pos.size2(); ++t2) {
             row_col_index[1] = t2;
-            size_t num = _eigenrays(t1, t2).size();
+            const eigenray_list &ray_list = eigenrays(t1, t2);
+            size_t num = ray_list.size();
             size_t next_rec = record + 1;
 
             proploss_index_var.putVar(row_col_index, &record);
             eigenray_index_var.putVar(row_col_index, &next_rec);
             eigenray_num_var.putVar(row_col_index, &num);
 
-            auto iter = _eigenrays(t1, t2).begin();
+            auto iter = ray_list.begin();
             for (int n = -1; n < (int)num; ++n) {
                 ray_index[0] = record++;
                 ray_freq_index[0] = ray_index[0];
@@ -361,12 +555,26 @@ void eigenray_collection::write_netcdf(const char *filename,
 eigenray_list eigenray_collection::dead_reckon(
     size_t t1, size_t t2, const wposition1 &source_new,
     const wposition1 &target_new, const profile_model::csptr &profile) const {
-    eigenray_list eigenrays =
-        dead_reckon_one(_eigenrays(t1, t2), _source_pos, source_new, profile);
-    return dead_reckon_one(eigenrays, wposition1(_target_pos, t1, t2),
+    eigenray_list rays =
+        dead_reckon_one(eigenrays(t1, t2), _source_pos, source_new, profile);
+    return dead_reckon_one(rays, wposition1(_target_pos, t1, t2),
                            target_new, profile);
 }
 
+/**
+ * Copies the eigenray list of the parent, while swapping the source and
+ * target angles of each eigenray.
+ */
+void eigenray_collection::make_reciprocal() const {
+    eigenray_list &ray_list = _eigenrays(0, 0);
+    for (const auto &ray : _parent->eigenrays(_parent_t1, _parent_t2)) {
+        auto *copy = new eigenray_model(*ray);
+        std::swap(copy->source_de, copy->target_de);
+        std::swap(copy->source_az, copy->target_az);
+        ray_list.push_back(eigenray_model::csptr(copy));
+    }
+}
+
 /**
  * Adjust eigenrays for small changes in the geometry of a single sensor.
  */
@@ -6,6 +6,7 @@
 
 #include <usml/eigenrays/eigenray_listener.h>
 #include <usml/eigenrays/eigenray_model.h>
+#include <usml/eigenrays/eigenray_target_listener.h>
 #include <usml/ocean/profile_model.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition.h>
@@ -15,7 +16,14 @@
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace usml {
 namespace eigenrays {
@@ -31,12 +39,42 @@ using namespace usml::ocean;
  * acoustic eigenrays at each target location.  After propagation is complete,
  * the sum_eigenrays() method is used to collect the results into a
  * phasor-summed propagation loss and phase at each target point.
+ *
+ * Targets can also be finalized while the wavefront is still propagating.
+ * If finalize_margin() is positive, check_eigenrays() sums the eigenrays for
+ * each target as soon as the wavefront time exceeds the first arrival at
+ * that target by this margin, and passes the target to each
+ * eigenray_target_listener. This allows nearby targets to be used long
+ * before the wavefront reaches its maximum time. Eigenrays that arrive
+ * after a target has been finalized are ignored, which limits the
+ * time window for eigenrays to each target.
+ *
+ * A collection can also be constructed as a view of a single target in
+ * another collection. Views share the eigenrays and totals of the parent
+ * collection, instead of copying and re-summing them. This allows each
+ * sensor_pair in a multistatic field to extract its direct paths from the
+ * eigenrays computed for one sensor. Views can also reverse the sense of
+ * source and target, using source/receiver reciprocity, by swapping the source
+ * and target angles. The reciprocal eigenrays are only created when they are
+ * first accessed.
  */
 class USML_DECLSPEC eigenray_collection : public eigenray_listener {
    public:
     /// Alias for shared reference to eigenray collection.
     typedef std::shared_ptr<const eigenray_collection> csptr;
 
+    /**
+     * Number of threads used by sum_eigenrays(), including the calling
+     * thread. Defaults to the number of cores on this machine. A value of
+     * one sums all eigenrays on the calling thread.
+     */
+    static unsigned num_workers;
+
+    /**
+     * Number of targets summed as a single unit of work. Defaults to 64.
+     */
+    static size_t chunk_size;
+
     /**
      * Initialize with references to wave front information.
      *
@@ -53,6 +91,25 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
                         const matrix<uint64_t> &targetIDs = matrix<uint64_t>(),
                         bool coherent = true);
 
+    /**
+     * Initialize as a view of a single target in a parent collection. Shares
+     * the eigenrays and totals of the parent, which must have already been
+     * summed, instead of copying them. If the target is not found in the
+     * parent, the view is initialized as a collection with no eigenrays.
+     *
+     * @param parent        Collection that stores the eigenrays.
+     * @param targetID      Platform ID number of target in parent.
+     * @param source_pos    Location of the source for this view.
+     * @param target_pos    Location of the target for this view.
+     * @param sourceID      Platform ID number of source for this view.
+     * @param viewID        Platform ID number of target for this view.
+     * @param reciprocal    Swap the sense of source and target if true.
+     */
+    eigenray_collection(const csptr &parent, uint64_t targetID,
+                        const wposition1 &source_pos,
+                        const wposition1 &target_pos, uint64_t sourceID,
+                        uint64_t viewID, bool reciprocal = false);
+
     /**
      * Virtual destructor.
      */
@@ -102,14 +159,23 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     seq_vector::csptr frequencies() const { return _frequencies; }
 
     /**
-     * Return eigenray list for a single target.
+     * Return eigenray list for a single target. Views return the eigenray
+     * list of their parent, reversing the sense of source and target on the
+     * first access, if needed.
      *
      * @param   t1  			Row number of target.
      * @param   t2  			Column number of target.
      * @return  Eigenray list for this target.
      */
     const eigenray_list &eigenrays(size_t t1 = 0, size_t t2 = 0) const {
-        return _eigenrays(t1, t2);
+        if (_parent == nullptr) {
+            return _eigenrays(t1, t2);
+        }
+        if (!_reciprocal) {
+            return _parent->eigenrays(_parent_t1, _parent_t2);
+        }
+        std::call_once(_reciprocal_flag, [this] { make_reciprocal(); });
+        return _eigenrays(0, 0);
     }
 
     /// The time of arrival of the fastest eigenray for each target.
@@ -118,12 +184,28 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     }
 
     /**
-     * Find eigenrays for a single target in the grid.
+     * Find eigenrays for a single target in the grid. Returns a reference
+     * to the eigenray list in this collection, instead of a copy.
+     *
+     * @param   targetID	  Platform ID number for this target.
+     * @return  List of acoustic paths between a source and target,
+     *          empty if target not found.
+     */
+    const eigenray_list &find_eigenrays(uint64_t targetID = 0) const;
+
+    /**
+     * Find the row and column of a single target in the grid. Uses a hash
+     * index built when the collection is constructed, so the cost does not
+     * grow with the number of targets. A targetID of zero finds the first
+     * target in the grid. If the same targetID appears more than once, the
+     * first one in row major order is found.
      *
      * @param   targetID	  Platform ID number for this target.
-     * @return  List of acoustic paths between a source and target.
+     * @param   t1  		  Row number of target (output).
+     * @param   t2  		  Column number of target (output).
+     * @return  False if target not found.
      */
-    eigenray_list find_eigenrays(uint64_t targetID = 0) const;
+    bool find_target(uint64_t targetID, size_t *t1, size_t *t2) const;
 
     /**
      * Find fastest eigenray for a single target in the grid.
@@ -160,8 +242,65 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
      */
     void add_eigenray(size_t t1, size_t t2, eigenray_model::csptr ray,
                       size_t runID = 0);
+
+    /**
+     * Notifies the observer that eigenray processing is complete for a
+     * wavefront time step. Finalizes each target whose first eigenray
+     * arrived more than finalize_margin() seconds before this time.
+     * Does nothing if finalize_margin() is not positive.
+     *
+     * @param wave_time 	Elapsed time for this wavefront step.
+     * @param runID 		Wavefront identification number.
+     */
+    void check_eigenrays(double wave_time, size_t runID = 0);
+
+    /**
+     * Time after the first arrival at a target that check_eigenrays()
+     * waits before finalizing that target (sec). Targets are only finalized
+     * by sum_eigenrays() if this is zero, which is the default.
+     */
+    double finalize_margin() const { return _finalize_margin; }
+
+    /**
+     * Time after the first arrival at a target that check_eigenrays()
+     * waits before finalizing that target (sec). Must be set before
+     * the first eigenray is added. Setting this to zero disables
+     * finalization during propagation.
+     *
+     * @param margin    Time window after first arrival (sec).
+     */
+    void finalize_margin(double margin) { _finalize_margin = margin; }
+
+    /**
+     * True if the eigenrays for this target have been finalized by
+     * check_eigenrays().
+     *
+     * @param   t1  		Row number of target.
+     * @param   t2  		Column number of target.
+     */
+    bool is_final(size_t t1 = 0, size_t t2 = 0) const {
+        return _is_final(t1, t2);
+    }
+
+    /**
+     * Add a listener for finalized targets.
+     */
+    void add_target_listener(eigenray_target_listener *listener);
+
     /**
-     * Compute propagation loss summed over all eigenrays.
+     * Remove a listener for finalized targets.
+     */
+    void remove_target_listener(eigenray_target_listener *listener);
+
+    /**
+     * Compute propagation loss summed over all eigenrays. Targets are split
+     * into chunks of chunk_size targets. The calling thread, and up to
+     * num_workers-1 helper tasks in the thread pool, claim chunks until none
+     * remain. Each target is only written by one thread, so no locking is
+     * needed, and the result is independent of the number of threads.
+     * Targets already finalized by check_eigenrays() are not summed again.
+     * Each of the other targets is passed to the target listeners after
+     * all targets have been summed.
      */
     void sum_eigenrays();
 
@@ -215,12 +354,30 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
                               const profile_model::csptr &profile) const;
 
    private:
+    /// Collection that stores the eigenrays for a view, nullptr if not a view.
+    csptr _parent;
+
+    /// Row number of the target in the parent collection.
+    size_t _parent_t1{0};
+
+    /// Column number of the target in the parent collection.
+    size_t _parent_t2{0};
+
+    /// Reverse the sense of source and target for a view.
+    bool _reciprocal{false};
+
+    /// Ensures that reciprocal eigenrays are only created once.
+    mutable std::once_flag _reciprocal_flag;
+
     /// Value to find source in platform_manager. Set to zero if unknown.
     const uint64_t _sourceID;
 
     /// Value to find targets in platform_manager. Set to zero if unknown.
     matrix<uint64_t> _targetIDs;
 
+    /// Row and column of each target, indexed by targetID.
+    std::unordered_map<uint64_t, std::pair<size_t, size_t> > _target_index;
+
     /**
      * Location of the wavefront source in spherical earth coordinates.
      * Linked from wavefront object so we can write it to a netCDF file.
@@ -237,8 +394,11 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
      */
     const seq_vector::csptr _frequencies;
 
-    /// List of eigenrays associated with each target.
-    matrix<eigenray_list> _eigenrays;
+    /**
+     * List of eigenrays associated with each target. Only used by views if
+     * the sense of source and target has been reversed.
+     */
+    mutable matrix<eigenray_list> _eigenrays;
 
     /// The time of arrival of the fastest eigenray for each target.
     matrix<double> _initial_time;
@@ -260,6 +420,53 @@ class USML_DECLSPEC eigenray_collection : public eigenray_listener {
     /// Compute coherent propagation totals if true, and incoherent if false.
     bool _coherent;
 
+    /// Time after first arrival before a target is finalized (sec).
+    double _finalize_margin{0.0};
+
+    /// True if the eigenrays for a target have been finalized.
+    matrix<bool> _is_final;
+
+    /// Target finalization time and row major target number.
+    typedef std::pair<double, size_t> pending_target;
+
+    /// Targets waiting to be finalized, earliest finalization time first.
+    std::priority_queue<pending_target, std::vector<pending_target>,
+                        std::greater<pending_target> >
+        _pending;
+
+    /// Wavefront identification number from the last check_eigenrays().
+    size_t _runID{0};
+
+    /// Listeners for finalized targets.
+    std::set<eigenray_target_listener *> _target_listeners;
+
+    /**
+     * Passes a finalized target to each target listener.
+     *
+     * @param t1     	Row number of target.
+     * @param t2     	Column number of target.
+     */
+    void notify_target_listeners(size_t t1, size_t t2) const;
+
+    /**
+     * Compute propagation loss summed over all eigenrays for a range of
+     * targets. Copies the eigenrays of each target into contiguous arrays,
+     * so that the phasor sum at each frequency is a simple loop over arrays,
+     * and computes frequency independent terms once for each eigenray.
+     * Targets are numbered in row major order.
+     *
+     * @param first     First target to sum.
+     * @param last      One past the last target to sum.
+     */
+    void sum_targets(size_t first, size_t last);
+
+    /**
+     * Copies the eigenray list of the parent, while swapping the source and
+     * target angles of each eigenray. Stores the results in the _eigenrays
+     * list of this view.
+     */
+    void make_reciprocal() const;
+
     /**
      * Adjust eigenrays for small changes in the geometry of a single sensor.
      * Adjusts the travel time and intensity using the component of position
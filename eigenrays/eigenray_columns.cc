@@ -0,0 +1,94 @@
+/**
+ * @file eigenray_columns.cc
+ * Streams eigenrays to a columnar binary file as they are created.
+ */
+
+#include <usml/eigenrays/eigenray_columns.h>
+
+#include <stdexcept>
+
+using namespace usml::eigenrays;
+
+/**
+ * Creates a new columnar eigenray file.
+ */
+eigenray_columns::eigenray_columns(const char* filename,
+                                   const char* long_name)
+    : _writer(filename) {
+    if (long_name != nullptr) {
+        _writer.attribute("long_name", long_name);
+    }
+}
+
+/**
+ * Writes a new eigenray to the file.
+ */
+void eigenray_columns::add_eigenray(size_t t1, size_t t2,
+                                    eigenray_model::csptr ray, size_t runID) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (_num_freq == 0) {
+        define_columns(*ray);
+    } else if (ray->intensity.size() != _num_freq) {
+        throw std::invalid_argument(
+            "eigenray_columns: intensity does not match file frequencies");
+    }
+    _writer.append(TARGET_ROW, (double)t1);
+    _writer.append(TARGET_COL, (double)t2);
+    _writer.append(RUN_ID, (double)runID);
+    _writer.append(TRAVEL_TIME, ray->travel_time);
+    _writer.append(INTENSITY, ray->intensity.data().begin(), _num_freq);
+    _writer.append(PHASE, ray->phase.data().begin(), _num_freq);
+    _writer.append(SOURCE_DE, ray->source_de);
+    _writer.append(SOURCE_AZ, ray->source_az);
+    _writer.append(TARGET_DE, ray->target_de);
+    _writer.append(TARGET_AZ, ray->target_az);
+    _writer.append(SURFACE, ray->surface);
+    _writer.append(BOTTOM, ray->bottom);
+    _writer.append(CAUSTIC, ray->caustic);
+    _writer.append(UPPER, ray->upper);
+    _writer.append(LOWER, ray->lower);
+}
+
+/**
+ * Number of eigenrays written so far.
+ */
+size_t eigenray_columns::size() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _writer.num_rows();
+}
+
+/**
+ * Writes the header and columns to disk.
+ */
+void eigenray_columns::close() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _writer.close();
+}
+
+/**
+ * Defines the columns using the frequencies of the first eigenray.
+ */
+void eigenray_columns::define_columns(const eigenray_model& ray) {
+    using type = column_writer::column_type;
+    _num_freq = ray.intensity.size();
+    _writer.attribute("frequencies", ray.frequencies->data().begin(),
+                      ray.frequencies->size());
+
+    // clang-format off
+    _writer.add_column("target_row", type::int32, "count");
+    _writer.add_column("target_col", type::int32, "count");
+    _writer.add_column("run_id", type::int32, "count");
+    _writer.add_column("travel_time", type::float64, "seconds");
+    _writer.add_column("intensity", type::float64, "dB", _num_freq);
+    _writer.add_column("phase", type::float64, "radians", _num_freq);
+    _writer.add_column("source_de", type::float64, "degrees");
+    _writer.add_column("source_az", type::float64, "degrees_true");
+    _writer.add_column("target_de", type::float64, "degrees");
+    _writer.add_column("target_az", type::float64, "degrees_true");
+    _writer.add_column("surface", type::int16, "count");
+    _writer.add_column("bottom", type::int16, "count");
+    _writer.add_column("caustic", type::int16, "count");
+    _writer.add_column("upper", type::int16, "count");
+    _writer.add_column("lower", type::int16, "count");
+    // clang-format on
+}
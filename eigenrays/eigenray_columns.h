@@ -0,0 +1,112 @@
+/**
+ * @file eigenray_columns.h
+ * Streams eigenrays to a columnar binary file as they are created.
+ */
+#pragma once
+
+#include <usml/eigenrays/eigenray_listener.h>
+#include <usml/eigenrays/eigenray_model.h>
+#include <usml/types/column_writer.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <mutex>
+
+namespace usml {
+namespace eigenrays {
+
+using namespace usml::types;
+
+/// @ingroup eigenrays
+/// @{
+
+/**
+ * Streams eigenrays to a columnar binary file as they are created.
+ * Register this listener with a wave_queue, alongside the
+ * eigenray_collection, to record every eigenray for every target
+ * during propagation. The file uses the column_writer format, which
+ * python/src/usml/columns.py memory maps directly into numpy arrays.
+ *
+ * Columns use the same names and units as eigenray_collection::write_netcdf,
+ * plus "target_row", "target_col", and "run_id" columns that identify
+ * the target and wavefront for each eigenray. Intensity is stored in dB,
+ * and phase in radians, with one entry per frequency. The frequency axis
+ * is stored as the "frequencies" attribute. Columns are defined when the
+ * first eigenray arrives, because that is when the number of frequencies
+ * is known.
+ *
+ * This class locks the writer for each eigenray, so that it can be shared
+ * by wave_queue objects that run in separate threads.
+ */
+class USML_DECLSPEC eigenray_columns : public eigenray_listener {
+   public:
+    /**
+     * Creates a new columnar eigenray file.
+     *
+     * @param filename      Name of the file to write to disk.
+     * @param long_name     Optional global attribute for identifying data-set.
+     */
+    eigenray_columns(const char* filename, const char* long_name = nullptr);
+
+    /**
+     * Writes the file to disk if it has not already been closed.
+     */
+    ~eigenray_columns() override = default;
+
+    /**
+     * Writes a new eigenray to the file.
+     *
+     * @param t1     	Row number of target.
+     * @param t2     	Column number of target.
+     * @param ray    	Propagation loss information for this collision.
+     * @param runID 	Wavefront identification number.
+     */
+    void add_eigenray(size_t t1, size_t t2, eigenray_model::csptr ray,
+                      size_t runID) override;
+
+    /**
+     * Number of eigenrays written so far.
+     */
+    size_t size() const;
+
+    /**
+     * Writes the header and columns to disk.
+     */
+    void close();
+
+   private:
+    /// Column indices in the order they are defined.
+    enum column_index {
+        TARGET_ROW,
+        TARGET_COL,
+        RUN_ID,
+        TRAVEL_TIME,
+        INTENSITY,
+        PHASE,
+        SOURCE_DE,
+        SOURCE_AZ,
+        TARGET_DE,
+        TARGET_AZ,
+        SURFACE,
+        BOTTOM,
+        CAUSTIC,
+        UPPER,
+        LOWER
+    };
+
+    /// Prevents simultaneous updates from multiple threads.
+    mutable std::mutex _mutex;
+
+    /// Writer for the binary file.
+    column_writer _writer;
+
+    /// Number of frequencies, zero until the columns are defined.
+    size_t _num_freq = 0;
+
+    /// Defines the columns using the frequencies of the first eigenray.
+    void define_columns(const eigenray_model& ray);
+};
+
+/// @}
+}  // end of namespace eigenrays
+}  // end of namespace usml
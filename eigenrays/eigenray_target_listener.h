@@ -0,0 +1,50 @@
+/**
+ * @file eigenray_target_listener.h
+ * Abstract interface for passing finalized targets to an observer.
+ */
+#pragma once
+
+#include <usml/usml_config.h>
+
+#include <cstddef>
+
+namespace usml {
+namespace eigenrays {
+
+class eigenray_collection;
+
+/// @ingroup eigenrays
+/// @{
+
+/**
+ * Abstract interface for passing finalized targets to an observer.
+ * Allows clients, like trackers, to use the eigenrays for nearby targets
+ * as soon as the wavefront has passed them, instead of waiting for the
+ * propagation model to reach its maximum time.
+ *
+ * @see eigenray_collection::finalize_margin()
+ */
+class USML_DECLSPEC eigenray_target_listener {
+   public:
+    /**
+     * Virtual destructor.
+     */
+    virtual ~eigenray_target_listener() {}
+
+    /**
+     * Notifies the observer that the eigenrays for a target are complete,
+     * and that its total has been summed. The eigenray list and total for
+     * this target will not change after this call.
+     *
+     * @param collection    Collection that holds the eigenrays.
+     * @param t1     	    Row number of target.
+     * @param t2     	    Column number of target.
+     * @param runID 	    Wavefront identification number.
+     */
+    virtual void finalize_target(const eigenray_collection& collection,
+                                 size_t t1, size_t t2, size_t runID) = 0;
+};
+
+/// @}
+}  // namespace eigenrays
+}  // namespace usml
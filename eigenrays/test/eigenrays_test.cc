@@ -7,6 +7,8 @@
 #include <boost/test/unit_test.hpp>
 #include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(eigenrays_test)
 
@@ -44,6 +46,24 @@ class USML_DECLSPEC eigenray_factory : public eigenray_notifier {
     }
 };
 
+/**
+ * Records the order and wavefront time in which targets are finalized.
+ */
+class target_recorder : public eigenray_target_listener {
+   public:
+    double wave_time = 0.0;
+    std::vector<size_t> targets;
+    std::vector<double> times;
+    std::vector<size_t> num_rays;
+
+    void finalize_target(const eigenray_collection& collection, size_t t1,
+                         size_t t2, size_t /*runID*/) override {
+        targets.push_back(t1 * collection.size2() + t2);
+        times.push_back(wave_time);
+        num_rays.push_back(collection.eigenrays(t1, t2).size());
+    }
+};
+
 /**
  * @ingroup eigenrays_test
  * @{
@@ -90,6 +110,253 @@ BOOST_AUTO_TEST_CASE(create_eigenray) {
     collection.write_netcdf(ncname);
 }
 
+/**
+ * This test creates views of a single target in an eigenray collection. The
+ * normal view should share the eigenray list of its parent. The reciprocal
+ * view should swap the source and target angles of each eigenray and of the
+ * total, without changing the propagation loss.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_view) {
+    cout << "=== eigenrays_test: eigenray_view ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(1, 1, 12.0, 37.0);
+    matrix<uint64_t> targetIDs(1, 1);
+    targetIDs(0, 0) = 7;
+    auto* collection = new eigenray_collection(frequencies, source_pos,
+                                               targets, 3, targetIDs);
+    eigenray_factory factory;
+    factory.add_eigenray_listener(collection);
+    for (size_t n = 0; n < 3; ++n) {
+        factory.create_eigenray(frequencies, n);
+    }
+    collection->sum_eigenrays();
+    eigenray_collection::csptr parent(collection);
+
+    // normal view shares eigenray list with parent
+
+    eigenray_collection view(parent, 7, source_pos, parent->position(), 3, 7);
+    BOOST_CHECK_EQUAL(&view.eigenrays(), &parent->eigenrays());
+    BOOST_CHECK_EQUAL(view.total(0, 0).source_de,
+                      parent->total(0, 0).source_de);
+
+    // reciprocal view swaps source and target angles
+
+    eigenray_collection reverse(parent, 7, parent->position(), source_pos, 7, 3,
+                                true);
+    BOOST_CHECK_EQUAL(reverse.targetID(), 3);
+    BOOST_CHECK_EQUAL(reverse.eigenrays().size(), 3);
+    auto ray = parent->eigenrays().begin();
+    for (const auto& swapped : reverse.eigenrays()) {
+        BOOST_CHECK_EQUAL(swapped->source_de, (*ray)->target_de);
+        BOOST_CHECK_EQUAL(swapped->target_az, (*ray)->source_az);
+        ++ray;
+    }
+    const eigenray_model& total = reverse.total(0, 0);
+    BOOST_CHECK_EQUAL(total.intensity(0), parent->total(0, 0).intensity(0));
+    BOOST_CHECK_EQUAL(total.source_de, parent->total(0, 0).target_de);
+    BOOST_CHECK_EQUAL(total.target_az, parent->total(0, 0).source_az);
+
+    // view of missing target has no eigenrays
+
+    eigenray_collection missing(parent, 9, source_pos, parent->position(), 3,
+                                9);
+    BOOST_CHECK(missing.eigenrays().empty());
+}
+
+/**
+ * This test looks up targets by their platform ID in a grid of targets.
+ * The lookup should find the row and column of each target, return
+ * references to the eigenray lists stored in the collection, and handle
+ * missing targets.
+ */
+BOOST_AUTO_TEST_CASE(find_target) {
+    cout << "=== eigenrays_test: find_target ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(2, 3, 12.0, 37.0);
+    matrix<uint64_t> targetIDs(2, 3);
+    for (size_t t1 = 0; t1 < 2; ++t1) {
+        for (size_t t2 = 0; t2 < 3; ++t2) {
+            targetIDs(t1, t2) = 10 + 3 * t1 + t2;
+        }
+    }
+    eigenray_collection collection(frequencies, source_pos, targets, 3,
+                                   targetIDs);
+    auto* ray = new eigenray_model();
+    ray->travel_time = 4.0;
+    collection.add_eigenray(1, 2, eigenray_model::csptr(ray));
+
+    size_t t1 = 0;
+    size_t t2 = 0;
+    BOOST_CHECK(collection.find_target(14, &t1, &t2));
+    BOOST_CHECK_EQUAL(t1, 1);
+    BOOST_CHECK_EQUAL(t2, 1);
+    BOOST_CHECK(collection.find_target(0, &t1, &t2));
+    BOOST_CHECK_EQUAL(t1, 0);
+    BOOST_CHECK_EQUAL(t2, 0);
+    BOOST_CHECK(!collection.find_target(99, &t1, &t2));
+
+    BOOST_CHECK_EQUAL(&collection.find_eigenrays(15),
+                      &collection.eigenrays(1, 2));
+    BOOST_CHECK_EQUAL(collection.find_eigenrays(15).size(), 1);
+    BOOST_CHECK(collection.find_eigenrays(99).empty());
+    BOOST_CHECK_EQUAL(collection.find_initial_time(15), 4.0);
+    BOOST_CHECK_EQUAL(collection.find_initial_time(99), 0.0);
+}
+
+/**
+ * This test sums the eigenrays for a grid of targets serially, and then with
+ * multiple workers and small chunks. Both results should be identical,
+ * because each target is summed by a single thread. Also checks that the
+ * weighted averages are computed for each target.
+ */
+BOOST_AUTO_TEST_CASE(parallel_sum) {
+    cout << "=== eigenrays_test: parallel_sum ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 500.0, 4));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(10, 12, 12.0, 37.0);
+    const unsigned num_workers = eigenray_collection::num_workers;
+    const size_t chunk_size = eigenray_collection::chunk_size;
+    const unsigned workers[2] = {1, 4};
+    matrix<eigenray_model> totals[2];
+    for (size_t n = 0; n < 2; ++n) {
+        eigenray_collection::num_workers = workers[n];
+        eigenray_collection::chunk_size = 7;
+        eigenray_collection collection(frequencies, source_pos, targets);
+        for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+                for (size_t r = 0; r < 3; ++r) {
+                    auto* ray = new eigenray_model();
+                    ray->travel_time = 1.0 + 0.1 * t1 + 0.01 * t2 + 0.2 * r;
+                    ray->source_de = -10.0 * r;
+                    ray->source_az = 5.0 * t2;
+                    ray->target_de = 10.0 * r;
+                    ray->target_az = 5.0 * t1;
+                    ray->surface = (int)r;
+                    ray->frequencies = frequencies;
+                    ray->intensity = scalar_vector<double>(
+                        frequencies->size(), 60.0 + 3.0 * r);
+                    ray->phase =
+                        scalar_vector<double>(frequencies->size(), 0.5 * r);
+                    collection.add_eigenray(t1, t2,
+                                            eigenray_model::csptr(ray));
+                }
+            }
+        }
+        collection.sum_eigenrays();
+        totals[n].resize(targets.size1(), targets.size2());
+        for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+            for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+                totals[n](t1, t2) = collection.total(t1, t2);
+            }
+        }
+    }
+    eigenray_collection::num_workers = num_workers;
+    eigenray_collection::chunk_size = chunk_size;
+
+    for (size_t t1 = 0; t1 < targets.size1(); ++t1) {
+        for (size_t t2 = 0; t2 < targets.size2(); ++t2) {
+            const eigenray_model& serial = totals[0](t1, t2);
+            const eigenray_model& parallel = totals[1](t1, t2);
+            for (size_t f = 0; f < frequencies->size(); ++f) {
+                BOOST_CHECK_EQUAL(parallel.intensity(f), serial.intensity(f));
+                BOOST_CHECK_EQUAL(parallel.phase(f), serial.phase(f));
+            }
+            BOOST_CHECK_EQUAL(parallel.travel_time, serial.travel_time);
+            BOOST_CHECK_SMALL(serial.source_az - 5.0 * t2, 1e-8);
+            BOOST_CHECK_SMALL(serial.target_az - 5.0 * t1, 1e-8);
+            BOOST_CHECK_EQUAL(serial.surface, 0);
+        }
+    }
+}
+
+/**
+ * This test finalizes targets while a simulated wavefront is propagating.
+ * Each of the first three targets has two eigenrays near its first arrival,
+ * and one late eigenray that arrives after the finalize margin. The fourth
+ * target has no eigenrays. Targets with eigenrays should be passed to the
+ * target listener in order of first arrival, as soon as the wavefront
+ * passes them by the margin, and their totals should only include the
+ * eigenrays that arrived within the margin. The target without eigenrays
+ * should only be passed to the listener by sum_eigenrays().
+ */
+BOOST_AUTO_TEST_CASE(finalize_targets) {
+    cout << "=== eigenrays_test: finalize_targets ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 500.0, 2));
+    wposition1 source_pos(15.0, 35.0);
+    wposition targets(1, 4, 12.0, 37.0);
+    const double margin = 0.5;
+    const double offsets[3] = {0.0, 0.3, 0.8};
+
+    eigenray_collection streaming(frequencies, source_pos, targets);
+    eigenray_collection reference(frequencies, source_pos, targets);
+    streaming.finalize_margin(margin);
+    target_recorder recorder;
+    streaming.add_target_listener(&recorder);
+
+    // simulate a wavefront that reaches each target one second apart
+
+    std::vector<std::pair<size_t, eigenray_model::csptr> > arrivals;
+    for (size_t t2 = 0; t2 < 3; ++t2) {
+        for (size_t r = 0; r < 3; ++r) {
+            auto* ray = new eigenray_model();
+            ray->travel_time = 1.0 + t2 + offsets[r];
+            ray->frequencies = frequencies;
+            ray->intensity =
+                scalar_vector<double>(frequencies->size(), 60.0 + 3.0 * r);
+            ray->phase = scalar_vector<double>(frequencies->size(), 0.5 * r);
+            arrivals.emplace_back(t2, eigenray_model::csptr(ray));
+            if (offsets[r] < margin) {
+                reference.add_eigenray(0, t2, arrivals.back().second);
+            }
+        }
+    }
+    for (size_t step = 1; step <= 50; ++step) {
+        const double wave_time = 0.1 * step;
+        recorder.wave_time = wave_time;
+        for (const auto& arrival : arrivals) {
+            const double time = arrival.second->travel_time;
+            if (time > wave_time - 0.1 && time <= wave_time) {
+                streaming.add_eigenray(0, arrival.first, arrival.second);
+            }
+        }
+        streaming.check_eigenrays(wave_time);
+    }
+
+    // targets are finalized in order, one step after the margin
+
+    BOOST_REQUIRE_EQUAL(recorder.targets.size(), 3);
+    for (size_t t2 = 0; t2 < 3; ++t2) {
+        BOOST_CHECK_EQUAL(recorder.targets[t2], t2);
+        BOOST_CHECK_CLOSE(recorder.times[t2], 1.0 + t2 + margin, 1e-6);
+        BOOST_CHECK_EQUAL(recorder.num_rays[t2], 2);
+        BOOST_CHECK(streaming.is_final(0, t2));
+    }
+    BOOST_CHECK(!streaming.is_final(0, 3));
+
+    // remaining target is passed to the listener by sum_eigenrays()
+
+    streaming.sum_eigenrays();
+    reference.sum_eigenrays();
+    BOOST_REQUIRE_EQUAL(recorder.targets.size(), 4);
+    BOOST_CHECK_EQUAL(recorder.targets[3], 3);
+    for (size_t t2 = 0; t2 < 3; ++t2) {
+        const eigenray_model& total = streaming.total(0, t2);
+        for (size_t f = 0; f < frequencies->size(); ++f) {
+            BOOST_CHECK_EQUAL(total.intensity(f),
+                              reference.total(0, t2).intensity(f));
+            BOOST_CHECK_EQUAL(total.phase(f), reference.total(0, t2).phase(f));
+        }
+        BOOST_CHECK_EQUAL(total.travel_time,
+                          reference.total(0, t2).travel_time);
+    }
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,12 +11,13 @@
 #include <usml/ublas/vector_math.h>
 #include <usml/netcdf-cxx/netcdfcpp.h>
 
-#include <boost/geometry/geometries/polygon.hpp>
-#include <boost/geometry/index/detail/predicates.hpp>
+#include <boost/geometry/geometries/box.hpp>
 #include <boost/geometry/index/predicates.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iterator>
@@ -36,9 +37,10 @@ double eigenverb_collection::search_scale = 1.5;
  */
 eigenverb_list eigenverb_collection::eigenverbs(size_t interface) const {
     read_lock_guard guard(_mutex);
+    const auto& store = _stores[interface];
     eigenverb_list list;
-    for (const auto& pair : _collection[interface]) {
-        list.push_back(pair.second);
+    for (eigenverb_store::handle n = 0; n < store.size(); ++n) {
+        list.push_back(store.model(n));
     }
     return list;
 }
@@ -48,50 +50,168 @@ eigenverb_list eigenverb_collection::eigenverbs(size_t interface) const {
  */
 void eigenverb_collection::add_eigenverb(eigenverb_model::csptr verb,
                                          size_t interface) {
-    write_lock_guard guard(_mutex);
-    eigenverb_collection::point center(verb->position.latitude(),
-                                       verb->position.longitude());
-    _collection[interface].insert(eigenverb_collection::pair(center, verb));
+    add_eigenverb(*verb, interface);
 }
 
 /**
- * Finds all of the eigenverbs that intersect the requested area.
+ * Copies a temporary eigenverb into this collection.
  */
-eigenverb_list eigenverb_collection::find_eigenverbs(
-    const eigenverb_model::csptr& bounding_verb, size_t interface) const {
-    read_lock_guard guard(_mutex);
+void eigenverb_collection::add_eigenverb(const eigenverb_model& verb,
+                                         size_t interface) {
+    write_lock_guard guard(_mutex);
+    auto handle = _stores[interface].add(verb);
+    if (!_bulk_load) {
+        auto center = to_point(verb.position.latitude(),
+                               verb.position.longitude());
+        _collection[interface].insert(
+            eigenverb_collection::pair(center, handle));
+    }
+}
 
-    // compute size of search area
+/**
+ * Packs the spatial index for every interface.
+ */
+void eigenverb_collection::build_index() {
+    if (!_bulk_load) {
+        return;
+    }
+    write_lock_guard guard(_mutex);
+    for (size_t interface = 0; interface < _stores.size(); ++interface) {
+        pack_index(interface);
+    }
+}
 
-    auto& pos = bounding_verb->position;
-    auto direction = bounding_verb->direction;
-    wposition1 posA(pos, search_scale * bounding_verb->length, direction);
-    wposition1 posB(pos, search_scale * bounding_verb->width,
-                    direction + M_PI_2);
-    wposition1 posC(pos, search_scale * bounding_verb->length,
-                    direction + M_PI);
-    wposition1 posD(pos, search_scale * bounding_verb->width,
-                    direction + M_PI + M_PI_2);
-    bgm::polygon<point> search_area{{{posA.latitude(), posA.longitude()},
-                                     {posB.latitude(), posB.longitude()},
-                                     {posC.latitude(), posC.longitude()},
-                                     {posD.latitude(), posD.longitude()}}};
+/**
+ * Converts a geographic location into a point for the spatial index.
+ */
+eigenverb_collection::point eigenverb_collection::to_point(double latitude,
+                                                           double longitude) {
+    longitude = std::remainder(longitude, 360.0);
+    return {longitude, latitude};
+}
 
-    // find eigenverbs whose position is within this box
+/**
+ * Rebuilds the spatial index for one interface.
+ */
+void eigenverb_collection::pack_index(size_t interface) const {
+    const auto& store = _stores[interface];
+    if (_collection[interface].size() == store.size()) {
+        return;
+    }
+    std::vector<eigenverb_collection::pair> values;
+    values.reserve(store.size());
+    for (eigenverb_store::handle n = 0; n < store.size(); ++n) {
+        values.emplace_back(to_point(store.latitude(n), store.longitude(n)),
+                            n);
+    }
+    _collection[interface] = rtree(values.begin(), values.end());
+}
 
-    std::list<eigenverb_collection::pair> pair_list;
-    _collection[interface].query(bgi::within(search_area),
-                                 std::back_inserter(pair_list));
+/**
+ * Finds all of the eigenverbs that intersect the requested area.
+ */
+eigenverb_list eigenverb_collection::find_eigenverbs(
+    const eigenverb_model::csptr& bounding_verb, size_t interface) const {
+    std::vector<eigenverb_store::handle> handles;
+    find_handles(*bounding_verb, interface, &handles);
 
     // translate to output structure
 
+    read_lock_guard guard(_mutex);
+    const auto& store = _stores[interface];
     eigenverb_list list;
-    for (const auto& pair : pair_list) {
-        list.push_back(pair.second);
+    for (auto handle : handles) {
+        list.push_back(store.model(handle));
     }
     return list;
 }
 
+/**
+ * Finds the handles of all eigenverbs that intersect the requested area.
+ */
+void eigenverb_collection::find_handles(
+    const eigenverb_model& bounding_verb, size_t interface,
+    std::vector<eigenverb_store::handle>* handles) const {
+    if (_bulk_load) {
+        bool stale;
+        {
+            read_lock_guard guard(_mutex);
+            stale = _collection[interface].size() != _stores[interface].size();
+        }
+        if (stale) {
+            write_lock_guard guard(_mutex);
+            pack_index(interface);
+        }
+    }
+    read_lock_guard guard(_mutex);
+    handles->clear();
+
+    // compute search ellipse in the local tangent plane of the bounding verb
+
+    const auto& pos = bounding_verb.position;
+    const double lat0 = pos.latitude();
+    const double lng0 = pos.longitude();
+    const double cos_lat = cos(to_radians(lat0));
+    const double cos_dir = cos(bounding_verb.direction);
+    const double sin_dir = sin(bounding_verb.direction);
+    const double semi_length = search_scale * bounding_verb.length;
+    const double semi_width = search_scale * bounding_verb.width;
+    if (semi_length <= 0.0 || semi_width <= 0.0) {
+        return;
+    }
+    const double inv_length2 = 1.0 / (semi_length * semi_length);
+    const double inv_width2 = 1.0 / (semi_width * semi_width);
+    const double meters_per_degree = to_radians(pos.rho());
+
+    // test each candidate against the ellipse as the rtree finds it
+
+    auto inside = [&](const eigenverb_collection::pair& pair) {
+        double dlng = bg::get<0>(pair.first) - lng0;
+        if (dlng > 180.0) {
+            dlng -= 360.0;
+        } else if (dlng < -180.0) {
+            dlng += 360.0;
+        }
+        const double north =
+            (bg::get<1>(pair.first) - lat0) * meters_per_degree;
+        const double east = dlng * meters_per_degree * cos_lat;
+        const double along = north * cos_dir + east * sin_dir;
+        const double across = east * cos_dir - north * sin_dir;
+        if (along * along * inv_length2 + across * across * inv_width2 <= 1.0) {
+            handles->push_back(pair.second);
+        }
+    };
+
+    // pre-filter using latitude and longitude limits of the ellipse
+    //   - split the box if it crosses the anti-meridian
+
+    const double radius = std::max(semi_length, semi_width);
+    const double dlat = radius / meters_per_degree;
+    const double lat_min = std::max(lat0 - dlat, -90.0);
+    const double lat_max = std::min(lat0 + dlat, 90.0);
+    const bool polar = lat_min <= -90.0 || lat_max >= 90.0;
+    const double dlng =
+        (!polar && cos_lat * 180.0 > dlat) ? dlat / cos_lat : 180.0;
+    const auto& tree = _collection[interface];
+    auto query = [&](double lng_min, double lng_max) {
+        bgm::box<point> box(point(lng_min, lat_min), point(lng_max, lat_max));
+        tree.query(bgi::intersects(box),
+                   boost::make_function_output_iterator(inside));
+    };
+    if (dlng >= 180.0) {
+        query(-180.0, 180.0);
+    } else if (lng0 - dlng < -180.0) {
+        query(lng0 - dlng + 360.0, 180.0);
+        query(-180.0, lng0 + dlng);
+    } else if (lng0 + dlng > 180.0) {
+        query(lng0 - dlng, 180.0);
+        query(-180.0, lng0 + dlng - 360.0);
+    } else {
+        query(lng0 - dlng, lng0 + dlng);
+    }
+    std::sort(handles->begin(), handles->end());
+}
+
 /**
  * Writes the eigenverbs for an individual interface to a netcdf file.
  */
@@ -290,9 +410,15 @@ void eigenverb_collection::read_netcdf(const char* filename, size_t interface) {
     rec_freq_count[1] = num_freq;
 
     auto* power = new double[num_freq];
+    eigenverb_model workspace;
+    auto* verb = &workspace;
+    verb->power.resize(num_freq, true);
+    {
+        write_lock_guard guard(_mutex);
+        _stores[interface].reserve(_stores[interface].size() +
+                                   num_eigenverbs);
+    }
     for (size_t record = 0; record < num_eigenverbs; ++record) {
-        auto* verb = new eigenverb_model();
-        verb->power.resize(num_freq, true);
         index[0] = record;
         rec_freq_index[0] = record;
 
@@ -329,7 +455,7 @@ void eigenverb_collection::read_netcdf(const char* filename, size_t interface) {
         lower_var.getVar(index, &i);        verb->lower = int(i);
         // clang-format on
 
-        add_eigenverb(eigenverb_model::csptr(verb), interface);
+        add_eigenverb(workspace, interface);
     }
     delete[] power;
 }
@@ -6,6 +6,7 @@
 
 #include <usml/eigenverbs/eigenverb_listener.h>
 #include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/eigenverbs/eigenverb_store.h>
 #include <usml/threads/read_write_lock.h>
 #include <usml/usml_config.h>
 
@@ -51,6 +52,21 @@ namespace bgm = boost::geometry::model;
  *
  * In addition to structures for storing eigenverbs, it also includes the
  * algorithms for eigenverb searches and writing eigenverbs to disk.
+ *
+ * The eigenverbs for each interface are copied into an eigenverb_store, which
+ * keeps each attribute in a compact column, and is indexed by integer handles.
+ * The spatial index only holds handles into that store. The eigenverbs() and
+ * find_eigenverbs() methods that return an eigenverb_list remain available for
+ * compatibility, but they create a new eigenverb_model for each result.
+ * Performance critical clients should use store() and find_handles() instead.
+ *
+ * In bulk load mode, add_eigenverb() only appends to the store, and the
+ * spatial index for each interface is built in a single pass by
+ * build_index(), or by the first search after new eigenverbs are added.
+ * Packing the whole tree at once avoids the node split costs of inserting
+ * one eigenverb at a time, and produces a tree with less overlap between
+ * nodes. This is the preferred mode when the collection is filled by
+ * a wavefront and then only searched.
  */
 class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
    public:
@@ -69,9 +85,25 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
      * volume scattering layer.
      *
      * @param num_volumes    Number of volume scattering layers in the ocean.
+     * @param bulk_load      Defer construction of the spatial index until
+     *                       all eigenverbs have been added.
+     */
+    eigenverb_collection(size_t num_volumes = 0, bool bulk_load = false)
+        : _bulk_load(bulk_load),
+          _stores((1 + num_volumes) * 2),
+          _collection((1 + num_volumes) * 2) {}
+
+    /**
+     * True if the spatial index is built after all eigenverbs are added.
      */
-    eigenverb_collection(size_t num_volumes = 0)
-        : _collection((1 + num_volumes) * 2) {}
+    bool bulk_load() const { return _bulk_load; }
+
+    /**
+     * Packs the spatial index for every interface that has eigenverbs
+     * which are not yet indexed. Does nothing unless the collection
+     * is in bulk load mode.
+     */
+    void build_index();
 
     /**
      * Number of interfaces in this collection.
@@ -84,7 +116,17 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
      * @param interface Interface number of the desired list of eigenverbs.
      */
     size_t size(size_t interface) const {
-        return _collection[interface].size();
+        return _stores[interface].size();
+    }
+
+    /**
+     * Compact storage for the eigenverbs of a specific interface.
+     * Not safe to use while eigenverbs are still being added.
+     *
+     * @param interface Interface number of the desired store.
+     */
+    const eigenverb_store& store(size_t interface) const {
+        return _stores[interface];
     }
 
     /**
@@ -100,13 +142,21 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
      * @param verb      Eigenverb reference to add to the eigenverb_collection.
      * @param interface Interface number for this addition.
      */
-    void add_eigenverb(eigenverb_model::csptr verb, size_t interface);
+    void add_eigenverb(eigenverb_model::csptr verb, size_t interface) override;
+
+    /**
+     * Copies a temporary eigenverb into this collection.
+     *
+     * @param verb      Eigenverb to copy into the eigenverb_collection.
+     * @param interface Interface number for this addition.
+     */
+    void add_eigenverb(const eigenverb_model& verb, size_t interface) override;
 
     /**
-     * Finds all of the eigenverbs near another eigenverb. Computes a ploygonal
-     * search area that is roughly 3 times as big as the major and minor axes
-     * for the bounding_verb. Then uses an rtree search to find all the
-     * eigenverbs whose positions are inside that search area.
+     * Finds all of the eigenverbs near another eigenverb. The search area is
+     * an ellipse centered on the bounding_verb, whose semi-major and
+     * semi-minor axes are search_scale times the length and width of the
+     * bounding_verb. Uses find_handles() to perform the search.
      *
      * @param bounding_verb		Eigenverb that defines bounding box.
      * @param interface 		Interface number for this query.
@@ -116,6 +166,28 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
     eigenverb_list find_eigenverbs(const eigenverb_model::csptr& bounding_verb,
                                    size_t interface) const;
 
+    /**
+     * Finds the handles of all eigenverbs near another eigenverb. Uses the
+     * same search area as find_eigenverbs(), but returns handles into
+     * store(interface) instead of creating new eigenverb_model objects.
+     * Handles are returned in ascending order.
+     *
+     * First, an rtree search finds the eigenverbs inside the latitude and
+     * longitude limits of the search ellipse. Then the offset of each
+     * candidate is projected onto the local tangent plane of the
+     * bounding_verb, and compared to the ellipse analytically. Avoids the
+     * great circle calculations and temporary lists needed to search inside
+     * a polygon. Reusing the same handles vector for a series of searches
+     * avoids memory allocation once it reaches its largest size.
+     *
+     * @param bounding_verb		Eigenverb that defines bounding box.
+     * @param interface 		Interface number for this query.
+     * @param handles   		Handles for eigenverbs that overlap this area.
+     *                          Previous contents are discarded.
+     */
+    void find_handles(const eigenverb_model& bounding_verb, size_t interface,
+                      std::vector<eigenverb_store::handle>* handles) const;
+
     /**
      * Writes the eigenverbs for an individual interface to a netcdf file. There
      * are separate variables for each eigenverb component, and each eigenverb
@@ -139,12 +211,12 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
     void read_netcdf(const char* filename, size_t interface);
 
    private:
-    /// Point in geographic coordinates, based on degrees.
+    /// Point in geographic coordinates (longitude, latitude) in degrees.
     typedef bgm::point<double, 2, bg::cs::spherical_equatorial<bg::degree>>
         point;
 
-    /// Eigenverb paired with its geographic coordinate.
-    typedef std::pair<point, eigenverb_model::csptr> pair;
+    /// Eigenverb handle paired with its geographic coordinate.
+    typedef std::pair<point, eigenverb_store::handle> pair;
 
     /// Spatial index for eigenverbs in geographic coordinates.
     typedef bgi::rtree<pair, bgi::rstar<8>> rtree;
@@ -152,8 +224,33 @@ class USML_DECLSPEC eigenverb_collection : public eigenverb_listener {
     /// Mutex to that locks object during changes.
     mutable read_write_lock _mutex;
 
+    /// Defer construction of the spatial index until it is needed.
+    const bool _bulk_load;
+
+    /// Compact eigenverb storage for each interface.
+    std::vector<eigenverb_store> _stores;
+
     /// Spatial index for each interface.
-    std::vector<rtree> _collection;
+    mutable std::vector<rtree> _collection;
+
+    /**
+     * Converts a geographic location into a point for the spatial index,
+     * with longitude wrapped into the range [-180,180] degrees.
+     *
+     * @param latitude  Latitude of the location (degrees).
+     * @param longitude Longitude of the location (degrees).
+     */
+    static point to_point(double latitude, double longitude);
+
+    /**
+     * Rebuilds the spatial index for one interface, from all of the
+     * eigenverbs in its store, if some of those eigenverbs are not yet
+     * indexed. Uses the packing algorithm of the rtree range constructor.
+     * Caller must hold a write lock.
+     *
+     * @param interface Interface number of the index to build.
+     */
+    void pack_index(size_t interface) const;
 };
 
 /// @}
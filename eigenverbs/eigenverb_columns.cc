@@ -0,0 +1,119 @@
+/**
+ * @file eigenverb_columns.cc
+ * Streams eigenverbs to a columnar binary file as they are created.
+ */
+
+#include <usml/eigenverbs/eigenverb_columns.h>
+#include <usml/ublas/math_traits.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace usml::eigenverbs;
+
+/**
+ * Creates a new columnar eigenverb file.
+ */
+eigenverb_columns::eigenverb_columns(const char* filename,
+                                     const char* long_name)
+    : _writer(filename) {
+    if (long_name != nullptr) {
+        _writer.attribute("long_name", long_name);
+    }
+}
+
+/**
+ * Writes a copy of a shared eigenverb to the file.
+ */
+void eigenverb_columns::add_eigenverb(eigenverb_model::csptr verb,
+                                      size_t interface_num) {
+    add_eigenverb(*verb, interface_num);
+}
+
+/**
+ * Writes a temporary eigenverb to the file.
+ */
+void eigenverb_columns::add_eigenverb(const eigenverb_model& verb,
+                                      size_t interface_num) {
+    std::lock_guard<std::mutex> guard(_mutex);
+    if (_num_freq == 0) {
+        define_columns(verb);
+    } else if (verb.power.size() != _num_freq) {
+        throw std::invalid_argument(
+            "eigenverb_columns: power does not match file frequencies");
+    }
+    for (size_t f = 0; f < _num_freq; ++f) {
+        _power[f] = 10.0 * log10(std::max(verb.power[f], 1e-30));
+    }
+    _writer.append(INTERFACE, (double)interface_num);
+    _writer.append(TRAVEL_TIME, verb.travel_time);
+    _writer.append(POWER, _power.data(), _num_freq);
+    _writer.append(LENGTH, verb.length);
+    _writer.append(WIDTH, verb.width);
+    _writer.append(LATITUDE, verb.position.latitude());
+    _writer.append(LONGITUDE, verb.position.longitude());
+    _writer.append(ALTITUDE, verb.position.altitude());
+    _writer.append(DIRECTION, to_degrees(verb.direction));
+    _writer.append(GRAZING, to_degrees(verb.grazing));
+    _writer.append(SOUND_SPEED, verb.sound_speed);
+    _writer.append(DE_INDEX, (double)verb.de_index);
+    _writer.append(AZ_INDEX, (double)verb.az_index);
+    _writer.append(SOURCE_DE, to_degrees(verb.source_de));
+    _writer.append(SOURCE_AZ, to_degrees(verb.source_az));
+    _writer.append(SURFACE, verb.surface);
+    _writer.append(BOTTOM, verb.bottom);
+    _writer.append(CAUSTIC, verb.caustic);
+    _writer.append(UPPER, verb.upper);
+    _writer.append(LOWER, verb.lower);
+}
+
+/**
+ * Number of eigenverbs written so far.
+ */
+size_t eigenverb_columns::size() const {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _writer.num_rows();
+}
+
+/**
+ * Writes the header and columns to disk.
+ */
+void eigenverb_columns::close() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    _writer.close();
+}
+
+/**
+ * Defines the columns using the frequencies of the first eigenverb.
+ */
+void eigenverb_columns::define_columns(const eigenverb_model& verb) {
+    using type = column_writer::column_type;
+    _num_freq = verb.power.size();
+    _power.resize(_num_freq);
+    _writer.attribute("frequencies", verb.frequencies->data().begin(),
+                      verb.frequencies->size());
+
+    // clang-format off
+    _writer.add_column("interface", type::int16, "count");
+    _writer.add_column("travel_time", type::float64, "seconds");
+    _writer.add_column("power", type::float64, "dB", _num_freq);
+    _writer.add_column("length", type::float64, "meters");
+    _writer.add_column("width", type::float64, "meters");
+    _writer.add_column("latitude", type::float64, "degrees_north");
+    _writer.add_column("longitude", type::float64, "degrees_east");
+    _writer.add_column("altitude", type::float64, "meters");
+    _writer.add_column("direction", type::float64, "degrees_true");
+    _writer.add_column("grazing", type::float64, "degrees");
+    _writer.add_column("sound_speed", type::float64, "m/s");
+    _writer.add_column("de_index", type::int32, "count");
+    _writer.add_column("az_index", type::int32, "count");
+    _writer.add_column("source_de", type::float64, "degrees");
+    _writer.add_column("source_az", type::float64, "degrees_true");
+    _writer.add_column("surface", type::int16, "count");
+    _writer.add_column("bottom", type::int16, "count");
+    _writer.add_column("caustic", type::int16, "count");
+    _writer.add_column("upper", type::int16, "count");
+    _writer.add_column("lower", type::int16, "count");
+    // clang-format on
+}
@@ -0,0 +1,126 @@
+/**
+ * @file eigenverb_columns.h
+ * Streams eigenverbs to a columnar binary file as they are created.
+ */
+#pragma once
+
+#include <usml/eigenverbs/eigenverb_listener.h>
+#include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/types/column_writer.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <mutex>
+
+namespace usml {
+namespace eigenverbs {
+
+using namespace usml::types;
+
+/// @ingroup eigenverbs
+/// @{
+
+/**
+ * Streams eigenverbs to a columnar binary file as they are created.
+ * Register this listener with a wave_queue, alongside the
+ * eigenverb_collection, to record every eigenverb from every interface
+ * during propagation. The file uses the column_writer format, which
+ * python/src/usml/columns.py memory maps directly into numpy arrays.
+ *
+ * Columns use the same names and units as eigenverb_collection::write_netcdf,
+ * plus an "interface" column that identifies the interface number for
+ * each eigenverb. Power is stored in dB, with one entry per frequency.
+ * The frequency axis is stored as the "frequencies" attribute.
+ * Columns are defined when the first eigenverb arrives, because that
+ * is when the number of frequencies is known.
+ *
+ * This class locks the writer for each eigenverb, so that it can be shared
+ * by wave_queue objects that run in separate threads.
+ */
+class USML_DECLSPEC eigenverb_columns : public eigenverb_listener {
+   public:
+    /**
+     * Creates a new columnar eigenverb file.
+     *
+     * @param filename      Name of the file to write to disk.
+     * @param long_name     Optional global attribute for identifying data-set.
+     */
+    eigenverb_columns(const char* filename, const char* long_name = nullptr);
+
+    /**
+     * Writes the file to disk if it has not already been closed.
+     */
+    ~eigenverb_columns() override = default;
+
+    /**
+     * Writes a copy of a shared eigenverb to the file.
+     *
+     * @param verb          Eigenverb data to add to the file.
+     * @param interface_num Interface number for this eigenverb.
+     */
+    void add_eigenverb(eigenverb_model::csptr verb,
+                       size_t interface_num) override;
+
+    /**
+     * Writes a temporary eigenverb to the file.
+     *
+     * @param verb          Eigenverb data to add to the file.
+     * @param interface_num Interface number for this eigenverb.
+     */
+    void add_eigenverb(const eigenverb_model& verb,
+                       size_t interface_num) override;
+
+    /**
+     * Number of eigenverbs written so far.
+     */
+    size_t size() const;
+
+    /**
+     * Writes the header and columns to disk.
+     */
+    void close();
+
+   private:
+    /// Column indices in the order they are defined.
+    enum column_index {
+        INTERFACE,
+        TRAVEL_TIME,
+        POWER,
+        LENGTH,
+        WIDTH,
+        LATITUDE,
+        LONGITUDE,
+        ALTITUDE,
+        DIRECTION,
+        GRAZING,
+        SOUND_SPEED,
+        DE_INDEX,
+        AZ_INDEX,
+        SOURCE_DE,
+        SOURCE_AZ,
+        SURFACE,
+        BOTTOM,
+        CAUSTIC,
+        UPPER,
+        LOWER
+    };
+
+    /// Prevents simultaneous updates from multiple threads.
+    mutable std::mutex _mutex;
+
+    /// Writer for the binary file.
+    column_writer _writer;
+
+    /// Number of frequencies, zero until the columns are defined.
+    size_t _num_freq = 0;
+
+    /// Workspace for power in dB.
+    std::vector<double> _power;
+
+    /// Defines the columns using the frequencies of the first eigenverb.
+    void define_columns(const eigenverb_model& verb);
+};
+
+/// @}
+}  // end of namespace eigenverbs
+}  // end of namespace usml
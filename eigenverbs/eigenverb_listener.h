@@ -9,6 +9,7 @@
 #include <usml/usml_config.h>
 
 #include <cstddef>
+#include <memory>
 
 namespace usml {
 namespace eigenverbs {
@@ -39,6 +40,22 @@ class USML_DECLSPEC eigenverb_listener {
      */
     virtual void add_eigenverb(eigenverb_model::csptr verb,
                                size_t interface_num) = 0;
+
+    /**
+     * Adds an eigenverb that is only valid for the duration of this call.
+     * Allows notifiers to reuse a single eigenverb_model as workspace, and
+     * listeners with compact storage to copy just the data they need.
+     * The default implementation makes a shared copy of the eigenverb
+     * and passes it to the shared pointer version of add_eigenverb().
+     *
+     * @param verb          Eigenverb data to add to list of eigenverbs.
+     * @param interface_num Interface number for the interface that generated
+     *                      for this eigenverb.
+     */
+    virtual void add_eigenverb(const eigenverb_model& verb,
+                               size_t interface_num) {
+        add_eigenverb(std::make_shared<eigenverb_model>(verb), interface_num);
+    }
 };
 
 /// @}
@@ -31,3 +31,13 @@ void eigenverb_notifier::notify_eigenverb_listeners(
         listener->add_eigenverb(verb, interface_num);
     }
 }
+
+/**
+ * Distribute a temporary eigenverb to all listeners.
+ */
+void eigenverb_notifier::notify_eigenverb_listeners(
+    const eigenverb_model& verb, size_t interface_num) const {
+    for (eigenverb_listener* listener : _listeners) {
+        listener->add_eigenverb(verb, interface_num);
+    }
+}
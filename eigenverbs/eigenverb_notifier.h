@@ -43,6 +43,17 @@ class USML_DECLSPEC eigenverb_notifier {
     void notify_eigenverb_listeners(const eigenverb_model::csptr& verb,
                                     size_t interface_num) const;
 
+    /**
+     * Distribute a temporary eigenverb to all listeners. Listeners must copy
+     * any data they need, because the notifier is free to reuse the eigenverb
+     * after this call returns.
+     *
+     * @param verb          Eigenverb that defines area for query.
+     * @param interface_num Interface number for this query.
+     */
+    void notify_eigenverb_listeners(const eigenverb_model& verb,
+                                    size_t interface_num) const;
+
     /**
      * Determines if any listeners exist
      * @return true when listeners exist, false otherwise.
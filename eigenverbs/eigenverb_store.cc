@@ -0,0 +1,120 @@
+/**
+ * @file eigenverb_store.cc
+ * Compact, column oriented storage for the eigenverbs of one interface.
+ */
+
+#include <usml/eigenverbs/eigenverb_store.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace usml::eigenverbs;
+
+/**
+ * Pre-allocates memory for a specific number of eigenverbs.
+ */
+void eigenverb_store::reserve(size_t capacity) {
+    _travel_time.reserve(capacity);
+    _power.reserve(capacity * _num_freq);
+    _length.reserve(capacity);
+    _width.reserve(capacity);
+    _rho.reserve(capacity);
+    _theta.reserve(capacity);
+    _phi.reserve(capacity);
+    _direction.reserve(capacity);
+    _grazing.reserve(capacity);
+    _sound_speed.reserve(capacity);
+    _source_de.reserve(capacity);
+    _source_az.reserve(capacity);
+    _de_index.reserve(capacity);
+    _az_index.reserve(capacity);
+    _surface.reserve(capacity);
+    _bottom.reserve(capacity);
+    _caustic.reserve(capacity);
+    _upper.reserve(capacity);
+    _lower.reserve(capacity);
+}
+
+/**
+ * Copies the contents of an eigenverb into the columns of this store.
+ */
+eigenverb_store::handle eigenverb_store::add(const eigenverb_model& verb) {
+    if (empty()) {
+        _frequencies = verb.frequencies;
+        _num_freq = verb.power.size();
+    } else if (verb.power.size() != _num_freq) {
+        throw std::invalid_argument(
+            "eigenverb_store: power does not match store frequencies");
+    }
+    const auto index = size();
+    _travel_time.push_back(verb.travel_time);
+    _power.insert(_power.end(), verb.power.begin(), verb.power.end());
+    _length.push_back(verb.length);
+    _width.push_back(verb.width);
+    _rho.push_back(verb.position.rho());
+    _theta.push_back(verb.position.theta());
+    _phi.push_back(verb.position.phi());
+    _direction.push_back(verb.direction);
+    _grazing.push_back(verb.grazing);
+    _sound_speed.push_back(verb.sound_speed);
+    _source_de.push_back(verb.source_de);
+    _source_az.push_back(verb.source_az);
+    _de_index.push_back(verb.de_index);
+    _az_index.push_back(verb.az_index);
+    _surface.push_back(verb.surface);
+    _bottom.push_back(verb.bottom);
+    _caustic.push_back(verb.caustic);
+    _upper.push_back(verb.upper);
+    _lower.push_back(verb.lower);
+    return index;
+}
+
+/**
+ * Location of impact with the interface.
+ */
+wposition1 eigenverb_store::position(handle index) const {
+    wposition1 pos;
+    pos.rho(_rho[index]);
+    pos.theta(_theta[index]);
+    pos.phi(_phi[index]);
+    return pos;
+}
+
+/**
+ * Copies one eigenverb from the store into an existing model.
+ */
+void eigenverb_store::get(handle index, eigenverb_model* verb) const {
+    verb->travel_time = _travel_time[index];
+    verb->frequencies = _frequencies;
+    if (verb->power.size() != _num_freq) {
+        verb->power.resize(_num_freq, false);
+    }
+    const double* power = this->power(index);
+    std::copy(power, power + _num_freq, verb->power.begin());
+    verb->length = _length[index];
+    verb->width = _width[index];
+    verb->position.rho(_rho[index]);
+    verb->position.theta(_theta[index]);
+    verb->position.phi(_phi[index]);
+    verb->direction = _direction[index];
+    verb->grazing = _grazing[index];
+    verb->sound_speed = _sound_speed[index];
+    verb->de_index = _de_index[index];
+    verb->az_index = _az_index[index];
+    verb->source_de = _source_de[index];
+    verb->source_az = _source_az[index];
+    verb->surface = _surface[index];
+    verb->bottom = _bottom[index];
+    verb->caustic = _caustic[index];
+    verb->upper = _upper[index];
+    verb->lower = _lower[index];
+}
+
+/**
+ * Creates a new shared eigenverb_model from one eigenverb in the store.
+ */
+eigenverb_model::csptr eigenverb_store::model(handle index) const {
+    auto* verb = new eigenverb_model();
+    get(index, verb);
+    return eigenverb_model::csptr(verb);
+}
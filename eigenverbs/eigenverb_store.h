@@ -0,0 +1,179 @@
+/**
+ * @file eigenverb_store.h
+ * Compact, column oriented storage for the eigenverbs of one interface.
+ */
+#pragma once
+
+#include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition1.h>
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace usml {
+namespace eigenverbs {
+
+using namespace usml::types;
+
+/// @ingroup eigenverbs
+/// @{
+
+/**
+ * Compact, column oriented storage for the eigenverbs of one interface.
+ * Each attribute of eigenverb_model is stored in its own contiguous column,
+ * and the power for all frequencies is packed into a single column with
+ * num_freq() entries per eigenverb. This avoids a separate heap allocation
+ * (shared_ptr control block, model, and power vector) for every eigenverb,
+ * and keeps the attributes used in overlap calculations close together
+ * in memory.
+ *
+ * Eigenverbs are identified by an integer handle, which is the order in which
+ * they were added to the store. Handles remain valid for the life of
+ * the store, even as new eigenverbs are added. All eigenverbs in a store
+ * share the same frequency axis, which is captured from the first eigenverb
+ * added.
+ *
+ * The get() and model() methods reconstruct eigenverb_model objects for
+ * clients that still expect the original structure. The get() method
+ * is preferred in inner loops, because it can reuse the memory of an
+ * existing eigenverb_model.
+ *
+ * This class is not thread safe. Clients like eigenverb_collection are
+ * responsible for locking the store during updates.
+ */
+class USML_DECLSPEC eigenverb_store {
+   public:
+    /// Integer identifier for one eigenverb in this store.
+    typedef size_t handle;
+
+    /**
+     * Number of eigenverbs in this store.
+     */
+    size_t size() const { return _travel_time.size(); }
+
+    /**
+     * True if this store has no eigenverbs.
+     */
+    bool empty() const { return _travel_time.empty(); }
+
+    /**
+     * Frequencies shared by all eigenverbs in this store (Hz).
+     * Null if the store is empty.
+     */
+    seq_vector::csptr frequencies() const { return _frequencies; }
+
+    /**
+     * Number of frequencies in the power column of each eigenverb.
+     */
+    size_t num_freq() const { return _num_freq; }
+
+    /**
+     * Pre-allocates memory for a specific number of eigenverbs.
+     *
+     * @param capacity  Number of eigenverbs expected in this store.
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * Copies the contents of an eigenverb into the columns of this store.
+     *
+     * @param verb  Eigenverb to be added to the store.
+     * @return      Handle used to retrieve this eigenverb.
+     * @throw invalid_argument  If the number of frequencies in the power of
+     *                          this eigenverb does not match the store.
+     */
+    handle add(const eigenverb_model& verb);
+
+    /**
+     * Copies one eigenverb from the store into an existing model.
+     * Reuses the memory in the power vector of the model, if it is
+     * already the correct size.
+     *
+     * @param index Handle of the eigenverb to retrieve.
+     * @param verb  Model to be filled in with eigenverb data.
+     */
+    void get(handle index, eigenverb_model* verb) const;
+
+    /**
+     * Creates a new shared eigenverb_model from one eigenverb in the store.
+     * Provides compatibility with clients that expect eigenverb_list objects.
+     *
+     * @param index Handle of the eigenverb to retrieve.
+     * @return      Newly allocated copy of this eigenverb.
+     */
+    eigenverb_model::csptr model(handle index) const;
+
+    /// One way travel time for this path (sec).
+    double travel_time(handle index) const { return _travel_time[index]; }
+
+    /// Power of this eigenverb, num_freq() entries (linear units).
+    const double* power(handle index) const {
+        return _power.data() + index * _num_freq;
+    }
+
+    /// Length of the D/E projection onto the interface (meters).
+    double length(handle index) const { return _length[index]; }
+
+    /// Width of the AZ projection onto the interface (meters).
+    double width(handle index) const { return _width[index]; }
+
+    /// Location of impact with the interface.
+    wposition1 position(handle index) const;
+
+    /// Latitude of impact with the interface (degrees).
+    double latitude(handle index) const {
+        return to_latitude(_theta[index]);
+    }
+
+    /// Longitude of impact with the interface (degrees).
+    double longitude(handle index) const { return to_degrees(_phi[index]); }
+
+    /// Compass heading for the "length" axis (radians).
+    double direction(handle index) const { return _direction[index]; }
+
+    /// Angle to interface tangent plane at point of impact (radians).
+    double grazing(handle index) const { return _grazing[index]; }
+
+    /// The sound speed at point of impact (m/s).
+    double sound_speed(handle index) const { return _sound_speed[index]; }
+
+   private:
+    /// Frequencies shared by all eigenverbs in this store.
+    seq_vector::csptr _frequencies;
+
+    /// Number of frequencies in each power entry.
+    size_t _num_freq = 0;
+
+    /// @name Floating point columns
+    /// @{
+    std::vector<double> _travel_time;
+    std::vector<double> _power;
+    std::vector<double> _length;
+    std::vector<double> _width;
+    std::vector<double> _rho;
+    std::vector<double> _theta;
+    std::vector<double> _phi;
+    std::vector<double> _direction;
+    std::vector<double> _grazing;
+    std::vector<double> _sound_speed;
+    std::vector<double> _source_de;
+    std::vector<double> _source_az;
+    /// @}
+
+    /// @name Integer columns
+    /// @{
+    std::vector<size_t> _de_index;
+    std::vector<size_t> _az_index;
+    std::vector<int> _surface;
+    std::vector<int> _bottom;
+    std::vector<int> _caustic;
+    std::vector<int> _upper;
+    std::vector<int> _lower;
+    /// @}
+};
+
+/// @}
+}  // end of namespace eigenverbs
+}  // end of namespace usml
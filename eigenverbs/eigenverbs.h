@@ -13,6 +13,8 @@
 #pragma once
 
 #include <usml/eigenverbs/eigenverb_collection.h>
+#include <usml/eigenverbs/eigenverb_columns.h>
 #include <usml/eigenverbs/eigenverb_listener.h>
 #include <usml/eigenverbs/eigenverb_model.h>
 #include <usml/eigenverbs/eigenverb_notifier.h>
+#include <usml/eigenverbs/eigenverb_store.h>
@@ -8,6 +8,7 @@
 #include <boost/test/unit_test.hpp>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(eigenverbs_test)
 
@@ -119,6 +120,240 @@ BOOST_AUTO_TEST_CASE(create_eigenverbs) {
                    collection.size(eigenverb_model::BOTTOM));
 }
 
+/**
+ * This test checks the compact storage behind eigenverb_collection. It verifies
+ * that eigenverbs can be recovered from their handles without loss, and that
+ * find_handles() finds the same eigenverbs as find_eigenverbs().
+ */
+BOOST_AUTO_TEST_CASE(compact_storage) {
+    cout << "=== eigenverbs_test: compact_storage ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 3));
+    wposition1 source_pos(36.0, 16.0, 0.0);
+    double depth = 1000;
+
+    eigenverb_collection collection(0);
+    std::vector<eigenverb_model::csptr> originals;
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            eigenverb_model::csptr verb =
+                create_eigenverb(source_pos, depth, de, az, frequencies);
+            originals.push_back(verb);
+            collection.add_eigenverb(*verb, eigenverb_model::BOTTOM);
+        }
+    }
+
+    // handles are assigned in the order eigenverbs were added
+
+    const auto& store = collection.store(eigenverb_model::BOTTOM);
+    BOOST_CHECK_EQUAL(store.size(), originals.size());
+    BOOST_CHECK_EQUAL(store.num_freq(), frequencies->size());
+    eigenverb_model copy;
+    for (eigenverb_store::handle n = 0; n < store.size(); ++n) {
+        const auto& orig = originals[n];
+        store.get(n, &copy);
+        BOOST_CHECK_EQUAL(copy.travel_time, orig->travel_time);
+        BOOST_CHECK_EQUAL(copy.length, orig->length);
+        BOOST_CHECK_EQUAL(copy.width, orig->width);
+        BOOST_CHECK_EQUAL(copy.de_index, orig->de_index);
+        BOOST_CHECK_EQUAL(copy.az_index, orig->az_index);
+        BOOST_CHECK_CLOSE(copy.position.latitude(), orig->position.latitude(),
+                          1e-10);
+        BOOST_CHECK_CLOSE(copy.position.altitude(), orig->position.altitude(),
+                          1e-10);
+        BOOST_CHECK_EQUAL(store.power(n)[2], orig->power[2]);
+        BOOST_CHECK(copy.frequencies == frequencies);
+    }
+
+    // handle based search matches list based search
+
+    const auto& bounding_verb = originals[30];
+    std::vector<eigenverb_store::handle> handles;
+    collection.find_handles(*bounding_verb, eigenverb_model::BOTTOM, &handles);
+    eigenverb_list found_list =
+        collection.find_eigenverbs(bounding_verb, eigenverb_model::BOTTOM);
+    BOOST_CHECK_EQUAL(handles.size(), found_list.size());
+    BOOST_CHECK_LT(handles.size(), store.size());
+    auto iter = found_list.begin();
+    for (auto handle : handles) {
+        BOOST_CHECK_EQUAL((*iter++)->travel_time, store.travel_time(handle));
+    }
+}
+
+/**
+ * This test compares searches of a collection whose spatial index is built
+ * one eigenverb at a time, to one whose index is packed after all eigenverbs
+ * are added. Both must find the same eigenverbs, including eigenverbs added
+ * after the packed index has already been built.
+ */
+BOOST_AUTO_TEST_CASE(bulk_load) {
+    cout << "=== eigenverbs_test: bulk_load ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    wposition1 source_pos(36.0, 16.0, 0.0);
+    double depth = 1000;
+
+    eigenverb_collection incremental(0);
+    eigenverb_collection packed(0, true);
+    BOOST_CHECK(!incremental.bulk_load());
+    BOOST_CHECK(packed.bulk_load());
+
+    std::vector<eigenverb_model::csptr> originals;
+    for (double az = 0.0; az <= 90.0; az += az_spacing) {
+        for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+            originals.push_back(
+                create_eigenverb(source_pos, depth, de, az, frequencies));
+        }
+    }
+    const size_t half = originals.size() / 2;
+    for (size_t n = 0; n < half; ++n) {
+        incremental.add_eigenverb(*originals[n], eigenverb_model::BOTTOM);
+        packed.add_eigenverb(*originals[n], eigenverb_model::BOTTOM);
+    }
+    packed.build_index();
+    for (size_t n = half; n < originals.size(); ++n) {
+        incremental.add_eigenverb(*originals[n], eigenverb_model::BOTTOM);
+        packed.add_eigenverb(*originals[n], eigenverb_model::BOTTOM);
+    }
+
+    // search around every eigenverb
+
+    std::vector<eigenverb_store::handle> expected;
+    std::vector<eigenverb_store::handle> found;
+    for (const auto& verb : originals) {
+        incremental.find_handles(*verb, eigenverb_model::BOTTOM, &expected);
+        packed.find_handles(*verb, eigenverb_model::BOTTOM, &found);
+        BOOST_CHECK(!found.empty());
+        BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(),
+                                      expected.begin(), expected.end());
+    }
+}
+
+/**
+ * This test checks that the search area of find_handles() is an ellipse
+ * aligned with the direction of the bounding eigenverb, and that searches
+ * work across the anti-meridian. Eigenverbs are placed along and across the
+ * length axis of a bounding eigenverb that sits right next to 180 degrees
+ * east longitude.
+ */
+BOOST_AUTO_TEST_CASE(search_ellipse) {
+    cout << "=== eigenverbs_test: search_ellipse ===" << endl;
+
+    seq_vector::csptr frequencies(new seq_linear(3000.0, 1.0, 1));
+    eigenverb_model bounding_verb;
+    bounding_verb.frequencies = frequencies;
+    bounding_verb.power = scalar_vector<double>(frequencies->size(), 1.0);
+    bounding_verb.length = 1000.0;
+    bounding_verb.width = 200.0;
+    bounding_verb.direction = to_radians(90.0);  // length axis points east
+    bounding_verb.position = wposition1(10.0, 179.999, -1000.0);
+    const double length = eigenverb_collection::search_scale * 1000.0;
+    const double width = eigenverb_collection::search_scale * 200.0;
+
+    // eigenverbs just inside and just outside each axis of the ellipse
+
+    eigenverb_collection collection(0);
+    const double offsets[] = {0.9, 1.1};
+    for (double scale : offsets) {
+        for (double bearing = 0.0; bearing < 360.0; bearing += 90.0) {
+            const double range =
+                scale * ((int(bearing) % 180 == 0) ? width : length);
+            eigenverb_model verb = bounding_verb;
+            verb.position = wposition1(bounding_verb.position, range,
+                                       to_radians(bearing));
+            verb.position.altitude(-1000.0);
+            collection.add_eigenverb(verb, eigenverb_model::BOTTOM);
+        }
+    }
+
+    std::vector<eigenverb_store::handle> handles;
+    collection.find_handles(bounding_verb, eigenverb_model::BOTTOM, &handles);
+    std::vector<eigenverb_store::handle> expected = {0, 1, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(handles.begin(), handles.end(),
+                                  expected.begin(), expected.end());
+    const auto& store = collection.store(eigenverb_model::BOTTOM);
+    BOOST_CHECK_GT(store.longitude(1), 180.0);  // east of the anti-meridian
+}
+
+/**
+ * This test streams eigenverbs to a columnar file with eigenverb_columns,
+ * and then reads the file back using the layout described in its header.
+ * It checks the magic string, the number of rows, and the travel time and
+ * power columns against the eigenverbs that were written. The same file
+ * can be loaded into numpy with python/src/usml/columns.py.
+ */
+BOOST_AUTO_TEST_CASE(columnar_export) {
+    cout << "=== eigenverbs_test: columnar_export ===" << endl;
+
+    const char* filename = USML_TEST_DIR "/eigenverbs/test/eigenverbs.col";
+
+    seq_vector::csptr frequencies(new seq_linear(1000.0, 1000.0, 3));
+    wposition1 source_pos(36.0, 16.0, 0.0);
+    double depth = 1000;
+
+    std::vector<eigenverb_model::csptr> originals;
+    {
+        eigenverb_columns columns(filename, "columnar_export");
+        for (double az = 0.0; az <= 90.0; az += az_spacing) {
+            for (double de = -90.0 + de_spacing; de < 0.0; de += de_spacing) {
+                eigenverb_model::csptr verb =
+                    create_eigenverb(source_pos, depth, de, az, frequencies);
+                originals.push_back(verb);
+                columns.add_eigenverb(verb, eigenverb_model::BOTTOM);
+            }
+        }
+        BOOST_CHECK_EQUAL(columns.size(), originals.size());
+        cout << "writing " << columns.size() << " eigenverbs to " << filename
+             << endl;
+        columns.close();
+    }
+
+    // read magic and header
+
+    std::ifstream in(filename, std::ios::binary);
+    char magic[8];
+    unsigned char length[8];
+    in.read(magic, sizeof(magic));
+    in.read((char*)length, sizeof(length));
+    BOOST_REQUIRE(in);
+    BOOST_CHECK_EQUAL(std::string(magic, sizeof(magic)), "USMLCOL1");
+    size_t header_size = 0;
+    for (size_t n = 0; n < sizeof(length); ++n) {
+        header_size |= (size_t)length[n] << (8 * n);
+    }
+    std::string header(header_size, ' ');
+    in.read(&header[0], (std::streamsize)header_size);
+    BOOST_CHECK(header.find("\"num_rows\": 80,") != std::string::npos);
+
+    // find the byte offset of a column in the header
+
+    auto offset = [&header](const std::string& name) {
+        size_t pos = header.find("\"name\": \"" + name + "\"");
+        BOOST_REQUIRE(pos != std::string::npos);
+        pos = header.find("\"offset\": ", pos) + 10;
+        return (std::streamoff)std::stol(header.substr(pos));
+    };
+
+    // compare column contents to original eigenverbs
+
+    std::vector<double> travel_time(originals.size());
+    in.seekg(offset("travel_time"));
+    in.read((char*)travel_time.data(),
+            (std::streamsize)(travel_time.size() * sizeof(double)));
+    std::vector<double> power(originals.size() * frequencies->size());
+    in.seekg(offset("power"));
+    in.read((char*)power.data(),
+            (std::streamsize)(power.size() * sizeof(double)));
+    BOOST_REQUIRE(in);
+    for (size_t n = 0; n < originals.size(); ++n) {
+        BOOST_CHECK_EQUAL(travel_time[n], originals[n]->travel_time);
+        for (size_t f = 0; f < frequencies->size(); ++f) {
+            BOOST_CHECK_CLOSE(power[n * frequencies->size() + f], 200.0,
+                              1e-10);
+        }
+    }
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
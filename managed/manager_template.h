@@ -12,6 +12,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 
 namespace usml {
@@ -31,9 +32,22 @@ using namespace usml::threads;
  * like size(), begin(), and end() because the state of the map can not be
  * guaranteed between innovations.
  *
+ * The map is stored as an immutable, reference counted snapshot. Writers
+ * serialize their changes with a mutex, copy the current map, modify the copy,
+ * and then publish it as the new snapshot. Readers just load the current
+ * snapshot atomically, so find(), list(), and snapshot() never wait for a
+ * lock. Readers that hold onto a snapshot() can iterate over it without
+ * copying, and without seeing changes made after it was published.
+ *
  * @param obj_type  Type of object stored in the manager.
+ * @param map_type  Associative container from keyID to shared object.
+ *                  Defaults to an ordered std::map. Managers with keys that
+ *                  have a std::hash, or a custom hash, can use an
+ *                  std::unordered_map instead.
  */
-template <typename obj_type>
+template <typename obj_type,
+          typename map_type = std::map<typename obj_type::key_type,
+                                       typename obj_type::sptr>>
 class USML_DLLEXPORT manager_template {
    public:
     /// Exception thrown if keyID already exists.
@@ -41,6 +55,12 @@ class USML_DLLEXPORT manager_template {
         const char* what() const throw() { return "duplicate key"; }
     };
 
+    /// Immutable version of the map shared between readers.
+    typedef std::shared_ptr<const map_type> snapshot_type;
+
+    /// Construct with an empty snapshot.
+    manager_template() : _snapshot(std::make_shared<const map_type>()) {}
+
     /**
      * Add a managed listener to this object.
      */
@@ -67,10 +87,13 @@ class USML_DLLEXPORT manager_template {
      */
     typename obj_type::key_type add(typename obj_type::sptr object) {
         write_lock_guard guard(_mutex);
-        if (_object_map.count(object->keyID()) > 0) throw duplicate_key();
+        snapshot_type current = snapshot();
+        if (current->count(object->keyID()) > 0) throw duplicate_key();
 
-        // add object to map
-        _object_map[object->keyID()] = object;
+        // add object to a copy of the map, then publish the copy
+        auto* object_map = new map_type(*current);
+        (*object_map)[object->keyID()] = object;
+        std::atomic_store(&_snapshot, snapshot_type(object_map));
 
         // notify listeners after add
         for (auto listener : _listeners) {
@@ -89,17 +112,21 @@ class USML_DLLEXPORT manager_template {
      */
     bool remove(typename obj_type::key_type keyID) {
         write_lock_guard guard(_mutex);
-        iterator iter = _object_map.find(keyID);
-        if (iter == _object_map.end()) return false;
+        snapshot_type current = snapshot();
+        iterator iter = current->find(keyID);
+        if (iter == current->end()) return false;
 
         // notify listeners before removal
         for (auto listener : _listeners) {
             listener->notify_remove(keyID);
         }
 
-        // remove object from manager
-        // delete object when shared_ptr goes out of scope
-        return _object_map.erase(keyID);
+        // remove object from a copy of the map, then publish the copy
+        // delete object when last snapshot and shared_ptr go out of scope
+        auto* object_map = new map_type(*current);
+        object_map->erase(keyID);
+        std::atomic_store(&_snapshot, snapshot_type(object_map));
+        return true;
     }
 
     /**
@@ -109,27 +136,34 @@ class USML_DLLEXPORT manager_template {
      * @return    nullptr if not found.
      */
     typename obj_type::sptr find(typename obj_type::key_type keyID) const {
-        read_lock_guard guard(_mutex);
+        snapshot_type current = snapshot();
         typename obj_type::sptr object = nullptr;
-        iterator iter = _object_map.find(keyID);
-        if (iter != _object_map.end()) {
+        iterator iter = current->find(keyID);
+        if (iter != current->end()) {
             object = iter->second;
         }
         return object;
     }
 
     /**
-     * Creates a temporary list of all objects in the map.
+     * Creates a temporary list of all objects in the map. Use snapshot()
+     * instead to iterate over the objects without copying them.
      */
     std::list<typename obj_type::sptr> list() const {
-        read_lock_guard guard(_mutex);
+        snapshot_type current = snapshot();
         std::list<typename obj_type::sptr> list;
-        for (auto pair : _object_map) {
+        for (const auto& pair : *current) {
             list.push_back(pair.second);
         }
         return list;
     }
 
+    /**
+     * Immutable version of the map at the time of this call. Changes to the
+     * manager after this call create a new snapshot, leaving this one intact.
+     */
+    snapshot_type snapshot() const { return std::atomic_load(&_snapshot); }
+
    private:
     /// Mutex for updating the structure of the map.
     mutable read_write_lock _mutex;
@@ -137,15 +171,11 @@ class USML_DLLEXPORT manager_template {
     /// List of active listeners.
     std::set<manager_listener<obj_type>*> _listeners;
 
-    /// Type used to store list of shared objects.
-    typedef std::map<typename obj_type::key_type, typename obj_type::sptr>
-        map_type;
-
     /// Iterator used to search for specific objects.
     typedef typename map_type::const_iterator iterator;
 
-    /// Stores list of mapped_types keyed by keyID.
-    map_type _object_map;
+    /// Current snapshot of mapped_types keyed by keyID.
+    snapshot_type _snapshot;
 };
 
 /// @}
@@ -110,5 +110,31 @@ BOOST_AUTO_TEST_CASE(add_remove) {
     manager.remove_listener(&mgr_listener);
 }
 
+/**
+ * Test the ability to read a snapshot of the manager_template while it is
+ * being changed. The snapshot taken before an object is removed must still
+ * contain that object, and the objects must remain in memory until the
+ * snapshot is released.
+ */
+BOOST_AUTO_TEST_CASE(snapshot) {
+    cout << "=== manager_test: snapshot ===" << endl;
+
+    manager_template<test_object> manager;
+    manager.add(test_object::sptr(new test_object(1, "first")));
+    manager.add(test_object::sptr(new test_object(2, "second")));
+
+    auto before = manager.snapshot();
+    manager.remove(1);
+    manager.add(test_object::sptr(new test_object(3, "third")));
+    auto after = manager.snapshot();
+
+    BOOST_CHECK_EQUAL(before->size(), 2);
+    BOOST_CHECK_EQUAL(before->begin()->second->keyID(), 1);
+    BOOST_CHECK_EQUAL(after->size(), 2);
+    BOOST_CHECK_EQUAL(after->begin()->second->keyID(), 2);
+    BOOST_CHECK(manager.find(1) == nullptr);
+    BOOST_CHECK_EQUAL(manager.find(3)->keyID(), 3);
+}
+
 /// @}
 BOOST_AUTO_TEST_SUITE_END()
@@ -58,6 +58,9 @@ class USML_DECLSPEC profile_catenary : public profile_model {
           _gradient1(g1),
           _depth1(z1) {}
 
+    /// Single location form of sound_speed() from profile_model.
+    using profile_model::sound_speed;
+
     /**
      * Compute the speed of sound and it's first derivatives at
      * a series of locations.
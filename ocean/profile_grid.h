@@ -129,6 +129,21 @@ class profile_grid : public profile_model {
         adjust_speed(location, speed, gradient);
     }
 
+    /**
+     * Compute the speed of sound at a single location. Interpolates the
+     * grid directly, without the temporary matrices of the other form.
+     *
+     * @param location      Location at which to compute sound speed.
+     * @param speed         Speed of sound (m/s) at this location (output).
+     */
+    void sound_speed(const wposition1& location,
+                     double* speed) const override {
+        double point[] = {location.rho(), location.theta(),
+                          location.phi()};
+        *speed = _sound_speed->interpolate(point);
+        adjust_speed(location, speed);
+    }
+
    private:
     /** Sound speed for all locations. */
     typename data_grid<NUM_DIMS>::csptr _sound_speed;
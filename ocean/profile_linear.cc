@@ -38,3 +38,18 @@ void profile_linear::sound_speed(const wposition& location,
 
     this->adjust_speed(location, speed, gradient);
 }
+
+/**
+ * Compute the speed of sound at a single location.
+ */
+void profile_linear::sound_speed(const wposition1& location,
+                                 double* speed) const {
+    double z = -location.altitude();
+    if (z < _depth1) {
+        *speed = _soundspeed0 + _gradient0 * z;
+    } else {
+        *speed =
+            _soundspeed0 + _gradient0 * _depth1 + _gradient1 * (z - _depth1);
+    }
+    this->adjust_speed(location, speed);
+}
@@ -102,6 +102,15 @@ class USML_DECLSPEC profile_linear : public profile_model {
     void sound_speed(const wposition& location, matrix<double>* speed,
                      wvector* gradient = nullptr) const override;
 
+    /**
+     * Compute the speed of sound at a single location.
+     *
+     * @param location      Location at which to compute sound speed.
+     * @param speed         Speed of sound (m/s) at this location (output).
+     */
+    void sound_speed(const wposition1& location,
+                     double* speed) const override;
+
    private:
     /** Speed of sound at the surface of the water. */
     double _soundspeed0;
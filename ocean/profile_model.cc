@@ -24,3 +24,17 @@ void profile_model::adjust_speed(const wposition& location,
         *speed = element_prod(*speed, location.rho()) / wposition::earth_radius;
     }
 }
+
+/**
+ * Compute the speed of sound at a single location.
+ */
+void profile_model::sound_speed(const wposition1& location,
+                                double* speed) const {
+    wposition loc(1, 1);
+    loc.rho(0, 0, location.rho());
+    loc.theta(0, 0, location.theta());
+    loc.phi(0, 0, location.phi());
+    matrix<double> result(1, 1);
+    sound_speed(loc, &result);
+    *speed = result(0, 0);
+}
@@ -6,6 +6,7 @@
 
 #include <usml/ocean/attenuation_thorp.h>
 #include <usml/types/wposition.h>
+#include <usml/types/wposition1.h>
 #include <usml/types/wvector.h>
 
 namespace usml {
@@ -71,6 +72,17 @@ class USML_DECLSPEC profile_model : public attenuation_model {
     virtual void sound_speed(const wposition& location, matrix<double>* speed,
                              wvector* gradient = nullptr) const = 0;
 
+    /**
+     * Compute the speed of sound at a single location. Often used to
+     * find the sound speed at a target. The default implementation copies
+     * the location into a 1x1 wposition and calls the matrix form. Sub-classes
+     * override it to avoid these temporary matrices.
+     *
+     * @param location      Location at which to compute sound speed.
+     * @param speed         Speed of sound (m/s) at this location (output).
+     */
+    virtual void sound_speed(const wposition1& location, double* speed) const;
+
     /**
      * Define a new in-water attenuation model.
      *
@@ -132,6 +144,19 @@ class USML_DECLSPEC profile_model : public attenuation_model {
     virtual void adjust_speed(const wposition& location, matrix<double>* speed,
                               wvector* gradient = nullptr) const;
 
+    /**
+     * Applies the flat earth anti-correction term to the sound speed at a
+     * single location.
+     *
+     * @param location      Location at which to compute sound speed.
+     * @param speed         Speed of sound (m/s) at this location (in/out).
+     */
+    void adjust_speed(const wposition1& location, double* speed) const {
+        if (_flat_earth) {
+            *speed *= location.rho() / wposition::earth_radius;
+        }
+    }
+
     /** Anti-correction term to make the earth seem flat. */
     bool _flat_earth;
 
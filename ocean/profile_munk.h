@@ -61,6 +61,9 @@ class USML_DECLSPEC profile_munk : public profile_model {
           _axis_speed(axis_speed),
           _epsilon(epsilon) {}
 
+    /// Single location form of sound_speed() from profile_model.
+    using profile_model::sound_speed;
+
     /**
      * Compute the speed of sound and it's first derivatives at
      * a series of locations.
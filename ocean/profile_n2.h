@@ -48,6 +48,9 @@ class USML_DECLSPEC profile_n2 : public profile_model {
                const attenuation_model::csptr& attmodel = nullptr)
         : profile_model(attmodel), _soundspeed0(c0), _factor(2.0 * g0 / c0) {}
 
+    /// Single location form of sound_speed() from profile_model.
+    using profile_model::sound_speed;
+
     /**
      * Compute the speed of sound and it's first derivatives at
      * a series of locations.
@@ -237,6 +237,37 @@ BOOST_AUTO_TEST_CASE(ascii_profile_test) {
     BOOST_CHECK_CLOSE(value8, 1490.00, 1e-5);
 }
 
+/**
+ * Test that the single location form of sound_speed() matches the
+ * matrix form for analytic, tabulated, and default implementations.
+ *
+ * Generate errors if values differ by more that 1E-10 percent.
+ */
+BOOST_AUTO_TEST_CASE(single_location_test) {
+    cout << "=== profile_test: single_location_test ===" << endl;
+    const char* ssp_file = (USML_TEST_DIR "/ocean/test/ascii_profile_test.csv");
+    data_grid<1>::csptr grid(new ascii_profile(ssp_file));
+
+    profile_linear bilinear(1500.0, -0.02, 1300, 0.01);
+    profile_grid<1> tabulated(grid);
+    profile_munk munk;
+    profile_model* models[] = {&bilinear, &tabulated, &munk};
+
+    wposition location(1, 1);
+    wposition1 point;
+    matrix<double> speed(1, 1);
+    for (profile_model* model : models) {
+        for (double depth = 0.0; depth <= 3000.0; depth += 250.0) {
+            location.altitude(0, 0, -depth);
+            point.altitude(-depth);
+            model->sound_speed(location, &speed);
+            double value = 0.0;
+            model->sound_speed(point, &value);
+            BOOST_CHECK_CLOSE(value, speed(0, 0), 1e-10);
+        }
+    }
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
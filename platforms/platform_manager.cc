@@ -5,7 +5,13 @@
 
 #include <usml/platforms/platform_manager.h>
 
+#include <boost/geometry/index/predicates.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iterator>
 #include <memory>
+#include <vector>
 
 using namespace usml::platforms;
 
@@ -51,5 +57,115 @@ typename platform_model::key_type platform_manager::add(
     } else {
         _max_key = max(_max_key, platform->keyID());
     }
-    return manager_template<platform_model>::add(platform);
+    auto keyID = manager_template<platform_model>::add(platform);
+
+    // add platform to spatial index
+
+    write_lock_guard index_guard(_index_mutex);
+    pair entry(to_point(platform->position()), platform);
+    _index.insert(entry);
+    _index_entries[keyID] = entry;
+    return keyID;
+}
+
+/**
+ * Removes an existing platform from the manager and its spatial index.
+ */
+bool platform_manager::remove(typename platform_model::key_type keyID) {
+    {
+        write_lock_guard index_guard(_index_mutex);
+        auto iter = _index_entries.find(keyID);
+        if (iter != _index_entries.end()) {
+            _index.remove(iter->second);
+            _index_entries.erase(iter);
+        }
+    }
+    return manager_template<platform_model>::remove(keyID);
+}
+
+/**
+ * Finds all of the platforms between a minimum and maximum range.
+ */
+std::list<platform_model::sptr> platform_manager::find_range(
+    const wposition1& center, double min_range, double max_range) const {
+    const double min_range2 = min_range * min_range;
+    const double max_range2 = max_range * max_range;
+
+    // find candidates in spatial index
+
+    std::vector<pair> candidates;
+    {
+        read_lock_guard index_guard(_index_mutex);
+        if (max_range2 < DBL_EPSILON) {
+            candidates.assign(_index.begin(), _index.end());
+        } else {
+            point origin = to_point(center);
+            box search_area(
+                point(origin.get<0>() - max_range, origin.get<1>() - max_range,
+                      origin.get<2>() - max_range),
+                point(origin.get<0>() + max_range, origin.get<1>() + max_range,
+                      origin.get<2>() + max_range));
+            _index.query(bgi::intersects(search_area),
+                         std::back_inserter(candidates));
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const pair& a, const pair& b) {
+                  return a.second->keyID() < b.second->keyID();
+              });
+
+    // test distance to each candidate
+
+    std::list<platform_model::sptr> list;
+    for (const auto& entry : candidates) {
+        const platform_model::sptr& platform = entry.second;
+        if (min_range2 < DBL_EPSILON && max_range2 < DBL_EPSILON) {
+            list.push_back(platform);
+        } else {
+            double distance2 = platform->position().distance2(center);
+            if (distance2 >= min_range2) {
+                if (max_range2 < DBL_EPSILON || distance2 <= max_range2) {
+                    list.push_back(platform);
+                }
+            }
+        }
+    }
+    return list;
+}
+
+/**
+ * Moves a platform to its current location in the spatial index of the
+ * singleton.
+ */
+void platform_manager::update_index(const platform_model* platform) {
+    platform_manager* manager = _instance.get();
+    if (manager != nullptr) {
+        manager->move_entry(platform);
+    }
+}
+
+/**
+ * Converts spherical earth coordinates into earth centered cartesian
+ * coordinates.
+ */
+platform_manager::point platform_manager::to_point(const wposition1& pos) {
+    const double rho = pos.rho();
+    const double r_sin_theta = rho * sin(pos.theta());
+    return {r_sin_theta * cos(pos.phi()), r_sin_theta * sin(pos.phi()),
+            rho * cos(pos.theta())};
+}
+
+/**
+ * Moves a platform to its current location in the spatial index.
+ */
+void platform_manager::move_entry(const platform_model* platform) {
+    write_lock_guard index_guard(_index_mutex);
+    auto iter = _index_entries.find(platform->keyID());
+    if (iter == _index_entries.end() ||
+        iter->second.second.get() != platform) {
+        return;
+    }
+    _index.remove(iter->second);
+    iter->second.first = to_point(platform->position());
+    _index.insert(iter->second);
 }
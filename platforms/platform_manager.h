@@ -7,21 +7,48 @@
 #include <usml/managed/managed_obj.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/threads/read_write_lock.h>
+#include <usml/types/wposition1.h>
 #include <usml/usml_config.h>
 
+#pragma GCC diagnostic push
+
+// clang-17 doesn't issue any warnings about "geometry.hpp", and
+// also it doesn't support "-Wmaybe-uninitialized".
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <boost/geometry/geometry.hpp>
+#pragma GCC diagnostic pop
+
+#include <list>
+#include <map>
 #include <memory>
+#include <utility>
 
 namespace usml {
 namespace platforms {
 
 using namespace usml::managed;
 using namespace usml::threads;
+using namespace usml::types;
+namespace bg = boost::geometry;
+namespace bgi = boost::geometry::index;
+namespace bgm = boost::geometry::model;
 
 /// @ingroup platforms
 /// @{
 
 /**
- * Singleton container for all platforms in the simulation.
+ * Singleton container for all platforms in the simulation. In addition to the
+ * keyID lookup provided by manager_template, it maintains a spatial index of
+ * platform locations so that range queries, like the target search in
+ * sensor_model::find_targets(), don't need to test every platform in the
+ * simulation. Platforms are indexed by their earth centered cartesian
+ * coordinates, so that the straight line distance used by wvector1::distance2()
+ * can be bounded exactly by an axis aligned search box. The index is kept
+ * current by platform_model::update_internals(), which calls update_index()
+ * each time a platform moves.
  */
 class USML_DECLSPEC platform_manager : public manager_template<platform_model> {
    public:
@@ -49,7 +76,74 @@ class USML_DECLSPEC platform_manager : public manager_template<platform_model> {
     typename platform_model::key_type add(
         const typename platform_model::sptr& platform);
 
+    /**
+     * Removes an existing platform from the manager and its spatial index.
+     * Leaves the map unchanged if keyID is not in the map. Overrides
+     * equivalent function in manager_template<>.
+     *
+     * @param keyID     Identification used to find this platform.
+     * @return          False if keyID was not found.
+     */
+    bool remove(typename platform_model::key_type keyID);
+
+    /**
+     * Finds all of the platforms whose straight line distance from a location
+     * is between a minimum and maximum range. Uses a search box that is twice
+     * the maximum range on each side to find candidates in the spatial index,
+     * and then tests the distance to each candidate. Returns all platforms
+     * beyond the minimum range if the maximum range is zero. Results are
+     * sorted by keyID.
+     *
+     * @param center        Location from which range is measured.
+     * @param min_range     Minimum range to valid platforms (m).
+     * @param max_range     Maximum range to valid platforms (m).
+     *                      Set to zero for infinite range.
+     * @return              List of platforms in this annulus.
+     */
+    std::list<platform_model::sptr> find_range(const wposition1& center,
+                                               double min_range = 0.0,
+                                               double max_range = 0.0) const;
+
+    /**
+     * Moves a platform to its current location in the spatial index of the
+     * singleton. Called from platform_model::update_internals() each time that
+     * a platform moves. Does nothing if the singleton has not been created, or
+     * if this platform is not stored in the manager.
+     *
+     * @param platform  Platform that has been moved.
+     */
+    static void update_index(const platform_model* platform);
+
    private:
+    /// Point in earth centered cartesian coordinates (m).
+    typedef bgm::point<double, 3, bg::cs::cartesian> point;
+
+    /// Search area in earth centered cartesian coordinates (m).
+    typedef bgm::box<point> box;
+
+    /// Platform paired with its earth centered cartesian coordinate.
+    typedef std::pair<point, platform_model::sptr> pair;
+
+    /// Spatial index for platforms in earth centered cartesian coordinates.
+    typedef bgi::rtree<pair, bgi::rstar<8>> rtree;
+
+    /**
+     * Converts spherical earth coordinates into earth centered cartesian
+     * coordinates.
+     *
+     * @param pos   Location in spherical earth coordinates.
+     * @return      Location in earth centered cartesian coordinates.
+     */
+    static point to_point(const wposition1& pos);
+
+    /**
+     * Moves a platform to its current location in the spatial index.
+     *
+     * @param platform  Platform that has been moved.
+     */
+    void move_entry(const platform_model* platform);
+
+
     /// Reference to singleton.
     static std::unique_ptr<platform_manager> _instance;
 
@@ -59,6 +153,15 @@ class USML_DECLSPEC platform_manager : public manager_template<platform_model> {
     /// Maximum key value that has been inserted into this manager
     platform_model::key_type _max_key;
 
+    /// Mutex for updating the spatial index.
+    mutable read_write_lock _index_mutex;
+
+    /// Spatial index of platform locations.
+    rtree _index;
+
+    /// Entry currently stored in the spatial index for each keyID.
+    std::map<platform_model::key_type, pair> _index_entries;
+
     /// Hide default constructor to prevent incorrect use of singleton.
     platform_manager() : _max_key(0) {}
 };
@@ -3,6 +3,7 @@
  * Physical object that moves through the simulation.
  */
 
+#include <usml/platforms/platform_manager.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/types/wvector1.h>
 
@@ -97,9 +98,8 @@ bool platform_model::remove_child(platform_model::key_type keyID) {
 std::list<platform_model::sptr> platform_model::children() {
     read_lock_guard guard(mutex());
     std::list<platform_model::sptr> list;
-    std::list<linkage::sptr> attached_list = _child_manager.list();
-    for (const auto& link : attached_list) {
-        list.push_back(link->child);
+    for (const auto& link : *_child_manager.snapshot()) {
+        list.push_back(link.second->child);
     }
     return list;
 }
@@ -117,10 +117,11 @@ void platform_model::update_internals(time_t time, const wposition1& pos,
     _position = pos;
     _orient = orient;
     _speed = speed;
+    platform_manager::update_index(this);
 
     // update motion of children
 
-    std::list<linkage::sptr> child_list = _child_manager.list();
+    auto child_map = _child_manager.snapshot();
     const double rho = _position.rho();
     const double theta = _position.theta();
     const double r_sin_theta = rho * sin(theta);
@@ -128,7 +129,8 @@ void platform_model::update_internals(time_t time, const wposition1& pos,
     bvector offset;
     wposition1 posit;
     orientation ori;
-    for (const auto& linkage : child_list) {
+    for (const auto& entry : *child_map) {
+        const auto& linkage = entry.second;
         offset.rotate(_orient, linkage->position);
         posit.rho(rho + offset.up());
         posit.theta(theta - offset.front() / rho);
@@ -92,6 +92,56 @@ BOOST_AUTO_TEST_CASE(attach_platform) {
 
     platform_manager::reset();
 }
+
+/**
+ * Test the ability to search the platform_manager for platforms in an annulus
+ * around a central location. Creates a line of platforms heading north from
+ * the equator, separated by roughly 1 km, and then searches for the platforms
+ * between 2.5 and 5.5 km from the first one. Then moves the platform at the
+ * center of the annulus far away and checks that the spatial index has been
+ * updated to reflect this change.
+ */
+BOOST_AUTO_TEST_CASE(find_range) {
+    cout << "=== platforms_test: find_range ===" << endl;
+
+    platform_manager* platform_mgr = platform_manager::instance();
+    const double spacing = 1000.0 / (60.0 * 1852.0);  // 1 km in degrees
+    std::vector<platform_model::sptr> platforms;
+    for (int n = 0; n < 10; ++n) {
+        platform_model::sptr platform(new platform_model(
+            0, "platform", 0, wposition1(n * spacing, 0.0, -10.0)));
+        platform_mgr->add(platform);
+        platforms.push_back(platform);
+    }
+    const wposition1 center = platforms[0]->position();
+
+    // search for platforms in annulus
+
+    std::list<platform_model::sptr> list =
+        platform_mgr->find_range(center, 2500.0, 5500.0);
+    BOOST_CHECK_EQUAL(list.size(), 3);
+    platform_model::key_type keyID = 4;
+    for (const auto& platform : list) {
+        BOOST_CHECK_EQUAL(platform->keyID(), keyID++);
+    }
+
+    // search with infinite maximum range
+
+    list = platform_mgr->find_range(center, 2500.0);
+    BOOST_CHECK_EQUAL(list.size(), 7);
+    list = platform_mgr->find_range(center);
+    BOOST_CHECK_EQUAL(list.size(), 10);
+
+    // move platform out of the annulus, and remove another one
+
+    platforms[4]->update(0, wposition1(45.0, 45.0, -10.0), orientation(), 0.0);
+    platform_mgr->remove(platforms[5]->keyID());
+    list = platform_mgr->find_range(center, 2500.0, 5500.0);
+    BOOST_CHECK_EQUAL(list.size(), 1);
+    BOOST_CHECK_EQUAL(list.front()->keyID(), 4);
+
+    platform_manager::reset();
+}
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+"""Read columnar binary files created by USML.
+
+These files are written by the C++ column_writer class, for example by the eigenray_columns and eigenverb_columns
+listeners. Each column is stored as a contiguous array, aligned to 64 bytes, so that it can be memory mapped into a
+numpy array without copying or parsing.
+
+The file starts with the 8 byte magic string "USMLCOL1", followed by the length of a JSON header as a little-endian
+64-bit unsigned integer, followed by the JSON header itself. The header lists the number of rows, the global
+attributes, and the name, dtype, shape, byte offset, and units of each column.
+"""
+import json
+
+import numpy as np
+
+MAGIC = b"USMLCOL1"
+
+
+class Struct:
+    """Dynamically defined data structure for columnar file contents."""
+    pass
+
+
+def read_header(filename: str) -> dict:
+    """Read the JSON header from a columnar file.
+
+    :param filename:    Name of file to load from disk
+    :return:            Dictionary with "num_rows", "attributes", and "columns" entries
+    """
+    with open(filename, "rb") as file:
+        magic = file.read(len(MAGIC))
+        if magic != MAGIC:
+            raise ValueError(f"{filename} is not a USML columnar file")
+        length = int(np.frombuffer(file.read(8), dtype="<u8")[0])
+        return json.loads(file.read(length).decode("utf-8"))
+
+
+def read(filename: str):
+    """Memory map the columns of a columnar file as numpy arrays.
+
+    Each column becomes a read-only np.memmap field of the returned structure, with shape (num_rows,) or
+    (num_rows, width). Each global attribute, like the "frequencies" axis, also becomes a field of the structure.
+    The units of each column are stored in the "units" dictionary.
+
+    :param filename:    Name of file to load from disk
+    :return:            Structure with one field per column and attribute
+    """
+    header = read_header(filename)
+    obj = Struct()
+    obj.num_rows = header["num_rows"]
+    obj.units = {}
+    for name, value in header["attributes"].items():
+        setattr(obj, name, np.asarray(value, dtype=float) if isinstance(value, list) else value)
+    for column in header["columns"]:
+        shape = tuple(column["shape"])
+        if obj.num_rows > 0:
+            values = np.memmap(filename, dtype=np.dtype(column["dtype"]), mode="r", offset=column["offset"],
+                               shape=shape)
+        else:
+            values = np.empty(shape, dtype=np.dtype(column["dtype"]))
+        setattr(obj, column["name"], values)
+        obj.units[column["name"]] = column["units"]
+    return obj
@@ -8,6 +8,7 @@ import matplotlib as mpl
 import matplotlib.pyplot as plt
 import numpy as np
 
+import usml.columns
 import usml.netcdf
 import usml.plot
 
@@ -132,6 +133,36 @@ class TestNetCDF(unittest.TestCase):
         plt.savefig(output)
         plt.close()
 
+    def test_eigenverb_columns(self):
+        """Memory maps USML eigenverbs from the columnar file written by eigenverbs_test/columnar_export.
+
+        Checks that each column is mapped with the shape and units described in the header, and that the travel time
+        and power columns match the hard-coded eigenverbs from that test.
+        """
+        testname = inspect.stack()[0][3]
+        print("=== " + testname + " ===")
+
+        # load data from disk
+        filename = os.path.join(self.USML_DIR, "eigenverbs/test/eigenverbs.col")
+        print(f"reading {filename}")
+        verbs = usml.columns.read(filename)
+        verb_shape = (verbs.num_rows,)
+
+        # check that eigenverb arrays are the right size
+        self.assertEqual(verbs.num_rows, 80)
+        self.assertEqual(verbs.frequencies.shape, (3,))
+        self.assertEqual(verbs.power.shape, (verb_shape[0], 3))
+        self.assertEqual(verbs.interface.shape, verb_shape)
+        self.assertEqual(verbs.travel_time.shape, verb_shape)
+        self.assertEqual(verbs.latitude.shape, verb_shape)
+        self.assertEqual(verbs.de_index.dtype.kind, "i")
+        self.assertEqual(verbs.units["power"], "dB")
+
+        # check contents against hard-coded eigenverbs
+        self.assertTrue(np.allclose(verbs.power, 200.0))
+        self.assertTrue(np.all(verbs.travel_time > 0.0))
+        self.assertTrue(np.allclose(verbs.altitude, -1000.0))
+
     def test_eigenverb_pair(self):
         """Plots source and receiver eigenverbs on ocean bottom.
 
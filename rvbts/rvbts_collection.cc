@@ -5,21 +5,26 @@
  */
 
 #include <usml/beampatterns/bp_model.h>
+#include <usml/beampatterns/bp_table.h>
 #include <usml/rvbts/rvbts_collection.h>
 #include <usml/types/bvector.h>
+#include <usml/types/seq_data.h>
 #include <usml/types/seq_linear.h>
 #include <usml/ublas/math_traits.h>
 #include <usml/ublas/vector_math.h>
 
-#include <boost/numeric/ublas/fwd.hpp>
-#include <boost/numeric/ublas/storage.hpp>
 #include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/vector_expression.hpp>
-#include <boost/numeric/ublas/vector_proxy.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <cstddef>
+#include <iostream>
 #include <list>
+#include <memory>
 #include <netcdf>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 using namespace usml::rvbts;
 
@@ -37,7 +42,7 @@ rvbts_collection::rvbts_collection(
     const orientation &source_orient, const double source_speed,
     const sensor_model::sptr &receiver, const wposition1 receiver_pos,
     const orientation &receiver_orient, const double receiver_speed,
-    const seq_vector::csptr &travel_times)
+    const seq_vector::csptr &travel_times, size_t window)
     : _source(source),
       _source_pos(source_pos),
       _source_orient(source_orient),
@@ -47,7 +52,27 @@ rvbts_collection::rvbts_collection(
       _receiver_orient(receiver_orient),
       _receiver_speed(receiver_speed),
       _travel_times(travel_times),
-      _time_series(receiver->rcv_num_keys(), travel_times->size()) {}
+      _time_series(receiver->rcv_num_keys(),
+                   (window == 0) ? travel_times->size()
+                                 : std::min(window, travel_times->size())) {
+    _time_series.clear();
+    for (int rcv : receiver->rcv_keys()) {
+        _rcv_keys.push_back(rcv);
+        _rcv_beams.push_back(receiver->rcv_beam(rcv));
+        _rcv_steerings.push_back(receiver->rcv_steering(rcv));
+    }
+    _rcv_patterns = _rcv_beams;
+}
+
+/**
+ * Closes the streaming file, if any, and removes it from disk.
+ */
+rvbts_collection::~rvbts_collection() {
+    _nc_file.reset();
+    if (!_stream_file.empty()) {
+        std::remove(_stream_file.c_str());
+    }
+}
 
 /**
  * Adds the intensity contribution for a single bistatic eigenverb.
@@ -55,83 +80,541 @@ rvbts_collection::rvbts_collection(
 void rvbts_collection::add_biverb(const biverb_model::csptr &verb,
                                   const transmit_model::csptr &transmit,
                                   const bvector &steering) {
-    static const double SQRT_TWO_PI = sqrt(TWO_PI);
+    add_biverb(verb, transmit, steering, 0, _time_series.size2(), &_work);
+}
 
+/**
+ * Adds the intensity contribution for a single bistatic eigenverb to a
+ * limited range of time indices.
+ */
+void rvbts_collection::add_biverb(const biverb_model::csptr &verb,
+                                  const transmit_model::csptr &transmit,
+                                  const bvector &steering, size_t time_first,
+                                  size_t time_last, workspace *work) {
     // find range of time indices to update
 
     const auto duration = verb->duration + transmit->duration;
     const auto delay = transmit->delay + verb->travel_time + duration;
-    size_t first = _travel_times->find_index(delay - 5.0 * duration);
-    size_t last = _travel_times->find_index(delay + 5.0 * duration);
-    range window(first, last);
-
-    // update Gaussian time series in this window
-
-    vector<double> times = _travel_times->data();
-    vector_range<vector<double> > tau(times, window);
-    vector<double> gaussian =
-        exp(-0.5 * abs2((tau - delay) / duration)) / (duration * SQRT_TWO_PI);
+    const size_t first = std::max(
+        time_first, _travel_times->find_index(delay - 5.0 * duration));
+    const size_t last = std::min(
+        time_last, _travel_times->find_index(delay + 5.0 * duration));
+    if (last <= first) {
+        return;
+    }
 
     // interpolate eigenverb power
 
-    double verb_level = verb->power[0] * transmit->duration;
-    if (verb->frequencies->size() > 1) {
-        double freq = transmit->fcenter;
-        const seq_vector &axis = *(verb->frequencies);
-        size_t index = axis.find_nearest(freq);
-        if (index >= axis.size()) {
-            --index;
-        }
-        double u = (freq - axis[index]) / axis.increment(index);
-        verb_level = u * verb->power[index + 1] + (1 - u) * verb->power[index];
+    double verb_level = interpolate_power(*verb, transmit->fcenter);
+    if (verb->frequencies->size() <= 1) {
+        verb_level *= transmit->duration;
     }
 
     // compute source level for this transmission
 
-    bp_model::csptr src_beam = _source->src_beam(transmit->transmit_mode);
-    const seq_vector::csptr frequencies(
-        new seq_linear(transmit->fcenter, 1.0, 1));
-    vector<double> level(1);
+    const src_table *table = find_src_table(transmit->transmit_mode, steering);
+    bp_model::csptr src_beam = (table != nullptr)
+                                   ? table->beam
+                                   : _source->src_beam(transmit->transmit_mode);
+    const seq_vector::csptr &frequencies =
+        work->frequency_axis(transmit->fcenter);
     bvector src_arrival(verb->source_de, verb->source_az);
     src_arrival.rotate(_source_orient, src_arrival);
-    src_beam->beam_level(src_arrival, frequencies, &level, steering);
-    double src_level = transmit->source_level + level[0];
+    src_beam->beam_level(src_arrival, frequencies, &work->level, steering);
+    double src_level = transmit->source_level + work->level[0];
     if (src_level < power_threshold) {
         return;
     }
 
+    // evaluate Gaussian once for all channels in this time window
+
+    const size_t num_times = last - first;
+    const double *gaussian = envelope(delay, duration, first, last, work);
+
     // add Gaussian to each receiver channel
 
-    for (int rcv : this->_receiver->rcv_keys()) {
+    bvector rcv_arrival(verb->receiver_de, verb->receiver_az);
+    rcv_arrival.rotate(_receiver_orient, rcv_arrival);
+    for (size_t c = 0; c < _rcv_keys.size(); ++c) {
         // compute received level for this transmission
 
-        bp_model::csptr rcv_beam = _receiver->rcv_beam(rcv);
-        bvector rcv_arrival(verb->receiver_de, verb->receiver_az);
-        rcv_arrival.rotate(_receiver_orient, rcv_arrival);
-        bvector rcv_steering = _receiver->rcv_steering(rcv);
-        rcv_beam->beam_level(rcv_arrival, frequencies, &level, rcv_steering);
-        double rcv_level = src_level + verb_level + level[0];
+        _rcv_beams[c]->beam_level(rcv_arrival, frequencies, &work->level,
+                                  _rcv_steerings[c]);
+        const double rcv_level = src_level + verb_level + work->level[0];
         if (rcv_level < power_threshold) {
             continue;
         }
 
         // add scaled Gaussian to each result in time window
 
-        for (size_t n = 0; n < gaussian.size(); ++n) {
-            auto t = n + first;
-            _time_series(rcv, t) += rcv_level * gaussian[n];
+        double *series = &_time_series(_rcv_keys[c], first);
+        for (size_t n = 0; n < num_times; ++n) {
+            series[n] += rcv_level * gaussian[n];
+        }
+    }
+}
+
+/**
+ * Eigenverb power interpolated to the center frequency of a transmission.
+ */
+double rvbts_collection::interpolate_power(const biverb_model &verb,
+                                           double fcenter) {
+    if (verb.frequencies->size() <= 1) {
+        return verb.power[0];
+    }
+    const seq_vector &axis = *(verb.frequencies);
+    size_t index = axis.find_nearest(fcenter);
+    if (index >= axis.size()) {
+        --index;
+    }
+    double u = (fcenter - axis[index]) / axis.increment(index);
+    return u * verb.power[index + 1] + (1 - u) * verb.power[index];
+}
+
+/**
+ * Evaluates the Gaussian envelope of a bistatic eigenverb over a window of
+ * time indices.
+ */
+const double *rvbts_collection::envelope(double delay, double duration,
+                                         size_t first, size_t last,
+                                         workspace *work) const {
+    static const double SQRT_TWO_PI = sqrt(TWO_PI);
+    const size_t num_times = last - first;
+    work->gaussian.resize(num_times);
+    const double scale = 1.0 / (duration * SQRT_TWO_PI);
+    const double rate = -0.5 / (duration * duration);
+    double *gaussian = work->gaussian.data();
+    for (size_t n = 0; n < num_times; ++n) {
+        const double tau = (*_travel_times)[n + first] - delay;
+        gaussian[n] = tau * tau * rate;
+    }
+    for (size_t n = 0; n < num_times; ++n) {
+        gaussian[n] = scale * std::exp(gaussian[n]);
+    }
+    return gaussian;
+}
+
+/**
+ * True if the biverb_terms of another collection can be used by this
+ * collection.
+ */
+bool rvbts_collection::same_terms(const rvbts_collection &other) const {
+    orientation src1(_source_orient);
+    orientation src2(other._source_orient);
+    orientation rcv1(_receiver_orient);
+    orientation rcv2(other._receiver_orient);
+    if (src1.yaw() != src2.yaw() || src1.pitch() != src2.pitch() ||
+        src1.roll() != src2.roll() || rcv1.yaw() != rcv2.yaw() ||
+        rcv1.pitch() != rcv2.pitch() || rcv1.roll() != rcv2.roll()) {
+        return false;
+    }
+    if (_rcv_keys != other._rcv_keys ||
+        _rcv_patterns != other._rcv_patterns ||
+        _beam_table_error != other._beam_table_error) {
+        return false;
+    }
+    for (size_t c = 0; c < _rcv_steerings.size(); ++c) {
+        const bvector &a = _rcv_steerings[c];
+        const bvector &b = other._rcv_steerings[c];
+        if (a.front() != b.front() || a.right() != b.right() ||
+            a.up() != b.up()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * True if the time series contribution of a transmission in another
+ * collection can be used by this collection.
+ */
+bool rvbts_collection::same_series(const rvbts_collection &other,
+                                   const transmit_series &current,
+                                   const transmit_series &previous) const {
+    const seq_vector &t1 = *_travel_times;
+    const seq_vector &t2 = *other._travel_times;
+    if (t1.size() != t2.size() || t1[0] != t2[0] ||
+        t1.increment(0) != t2.increment(0)) {
+        return false;
+    }
+    if (previous.series == nullptr || current.src_beam != previous.src_beam) {
+        return false;
+    }
+    const transmit_model &a = *current.transmit;
+    const transmit_model &b = *previous.transmit;
+    return a.duration == b.duration && a.fcenter == b.fcenter &&
+           a.delay == b.delay && a.source_level == b.source_level &&
+           a.transmit_mode == b.transmit_mode &&
+           current.steering.front() == previous.steering.front() &&
+           current.steering.right() == previous.steering.right() &&
+           current.steering.up() == previous.steering.up();
+}
+
+/**
+ * Creates empty terms for a collection of bistatic eigenverbs.
+ */
+std::shared_ptr<rvbts_collection::biverb_terms> rvbts_collection::create_terms(
+    const biverb_collection::csptr &biverbs) {
+    auto terms = std::make_shared<biverb_terms>();
+    terms->biverbs = biverbs;
+    const auto num_interfaces = biverbs->num_interfaces();
+    for (size_t interface = 0; interface < num_interfaces; ++interface) {
+        terms->offsets.push_back(terms->verbs.size());
+        for (const auto &verb : biverbs->biverbs_window(interface)) {
+            terms->verbs.push_back(verb.get());
+            terms->max_duration =
+                std::max(terms->max_duration, verb->duration);
+        }
+    }
+    terms->src_arrival.resize(3 * terms->verbs.size());
+    return terms;
+}
+
+/**
+ * Computes the source arrival vectors for a range of eigenverbs.
+ */
+void rvbts_collection::compute_arrivals(biverb_terms *terms, size_t first,
+                                        size_t last) const {
+    for (size_t n = first; n < last; ++n) {
+        const biverb_model *verb = terms->verbs[n];
+        bvector arrival(verb->source_de, verb->source_az);
+        arrival.rotate(_source_orient, arrival);
+        terms->src_arrival[3 * n] = arrival.front();
+        terms->src_arrival[3 * n + 1] = arrival.right();
+        terms->src_arrival[3 * n + 2] = arrival.up();
+    }
+}
+
+/**
+ * Computes eigenverb power and receiver beam levels for a range of
+ * eigenverbs at one center frequency.
+ */
+void rvbts_collection::compute_terms(const biverb_terms &terms, double fcenter,
+                                     frequency_terms *result, size_t first,
+                                     size_t last, workspace *work) const {
+    const seq_vector::csptr &frequencies = work->frequency_axis(fcenter);
+    const size_t num_channels = _rcv_keys.size();
+    for (size_t n = first; n < last; ++n) {
+        const biverb_model *verb = terms.verbs[n];
+        result->power[n] = interpolate_power(*verb, fcenter);
+        bvector arrival(verb->receiver_de, verb->receiver_az);
+        arrival.rotate(_receiver_orient, arrival);
+        for (size_t c = 0; c < num_channels; ++c) {
+            _rcv_beams[c]->beam_level(arrival, frequencies, &work->level,
+                                      _rcv_steerings[c]);
+            result->rcv_level[n * num_channels + c] = work->level[0];
+        }
+    }
+}
+
+/**
+ * Adds the contribution of every eigenverb for a single transmission to a
+ * limited range of time indices.
+ */
+void rvbts_collection::add_transmit(const biverb_terms &terms,
+                                    const transmit_series &transmit,
+                                    matrix<double> *series, size_t time_first,
+                                    size_t time_last, workspace *work,
+                                    size_t offset) const {
+    const transmit_model &pulse = *transmit.transmit;
+    const frequency_terms &fterms = *terms.frequencies.at(pulse.fcenter);
+    const src_table *table =
+        find_src_table(pulse.transmit_mode, transmit.steering);
+    const bp_model::csptr &src_beam =
+        (table != nullptr) ? table->beam : transmit.src_beam;
+    const seq_vector::csptr &frequencies = work->frequency_axis(pulse.fcenter);
+    const size_t num_channels = _rcv_keys.size();
+    bvector arrival(1.0, 0.0, 0.0);
+
+    // limit search to eigenverbs whose arrival envelope, which spans 5
+    // durations either side of a peak that is one duration after the
+    // travel time, can overlap this range of time indices
+
+    const double t0 = (*_travel_times)(0);
+    const double dt = _travel_times->increment(0);
+    const double max_duration = terms.max_duration + pulse.duration;
+    const double time_min =
+        t0 + double(time_first) * dt - pulse.delay - 6.0 * max_duration - dt;
+    const double time_max =
+        t0 + double(time_last) * dt - pulse.delay + 4.0 * max_duration + dt;
+
+    for (size_t interface = 0; interface < terms.offsets.size(); ++interface) {
+        const auto all = terms.biverbs->biverbs_window(interface);
+        const auto window =
+            terms.biverbs->biverbs_window(interface, time_min, time_max);
+        const size_t verb_first =
+            terms.offsets[interface] + (window.begin() - all.begin());
+        const size_t verb_last = verb_first + window.size();
+        for (size_t n = verb_first; n < verb_last; ++n) {
+            const biverb_model *verb = terms.verbs[n];
+
+            // find range of time indices to update
+
+            const auto duration = verb->duration + pulse.duration;
+            const auto delay = pulse.delay + verb->travel_time + duration;
+            const size_t first =
+                std::max(time_first,
+                         _travel_times->find_index(delay - 5.0 * duration));
+            const size_t last =
+                std::min(time_last,
+                         _travel_times->find_index(delay + 5.0 * duration));
+            if (last <= first) {
+                continue;
+            }
+
+            // compute source level for this transmission
+
+            arrival.front(terms.src_arrival[3 * n]);
+            arrival.right(terms.src_arrival[3 * n + 1]);
+            arrival.up(terms.src_arrival[3 * n + 2]);
+            src_beam->beam_level(arrival, frequencies, &work->level,
+                                 transmit.steering);
+            const double src_level = pulse.source_level + work->level[0];
+            if (src_level < power_threshold) {
+                continue;
+            }
+            double verb_level = fterms.power[n];
+            if (verb->frequencies->size() <= 1) {
+                verb_level *= pulse.duration;
+            }
+
+            // add Gaussian to each receiver channel
+
+            const size_t num_times = last - first;
+            const double *gaussian =
+                envelope(delay, duration, first, last, work);
+            const double *rcv_level = &fterms.rcv_level[n * num_channels];
+            for (size_t c = 0; c < num_channels; ++c) {
+                const double level = src_level + verb_level + rcv_level[c];
+                if (level < power_threshold) {
+                    continue;
+                }
+                double *row = &(*series)(_rcv_keys[c], first - offset);
+                for (size_t t = 0; t < num_times; ++t) {
+                    row[t] += level * gaussian[t];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Stores the terms and transmit contributions used to compute this
+ * collection.
+ */
+void rvbts_collection::incremental(std::shared_ptr<const biverb_terms> terms,
+                                   std::vector<transmit_series> transmits) {
+    _terms = std::move(terms);
+    _transmits = std::move(transmits);
+}
+
+/**
+ * Sums the contributions of each transmission into the time series.
+ */
+void rvbts_collection::sum_transmits(size_t time_first, size_t time_last) {
+    if (time_last <= time_first) {
+        return;
+    }
+    const size_t num_times = time_last - time_first;
+    for (size_t r = 0; r < _time_series.size1(); ++r) {
+        double *row = &_time_series(r, time_first);
+        std::fill(row, row + num_times, 0.0);
+        for (const auto &transmit : _transmits) {
+            const double *series = &(*transmit.series)(r, time_first);
+            for (size_t t = 0; t < num_times; ++t) {
+                row[t] += series[t];
+            }
         }
     }
 }
 
+/**
+ * Moves the window of travel times kept in memory, and clears its contents.
+ */
+void rvbts_collection::slide_window(size_t time_first) {
+    _window_first = time_first;
+    _time_series.clear();
+}
+
+/**
+ * Adds the contribution of every transmission to a limited range of time
+ * indices in the window kept in memory.
+ */
+void rvbts_collection::accumulate_transmits(size_t time_first,
+                                            size_t time_last,
+                                            workspace *work) {
+    if (time_last <= time_first) {
+        return;
+    }
+    const size_t num_times = time_last - time_first;
+    matrix<double> &series = work->series;
+    if (series.size1() != _time_series.size1() ||
+        series.size2() < num_times) {
+        series.resize(_time_series.size1(), num_times, false);
+    }
+    for (const auto &transmit : _transmits) {
+        for (size_t r = 0; r < series.size1(); ++r) {
+            std::fill_n(&series(r, 0), num_times, 0.0);
+        }
+        add_transmit(*_terms, transmit, &series, time_first, time_last, work,
+                     time_first);
+        for (size_t r = 0; r < _time_series.size1(); ++r) {
+            double *row = &_time_series(r, time_first - _window_first);
+            const double *contribution = &series(r, 0);
+            for (size_t t = 0; t < num_times; ++t) {
+                row[t] += contribution[t];
+            }
+        }
+    }
+}
+
+namespace {
+
+/**
+ * Tabulates a beam pattern, or returns the original pattern if the size
+ * limit of the table stopped refinement before it met max_error.
+ */
+bp_model::csptr create_table(const bp_model::csptr &beam,
+                             const seq_vector::csptr &frequencies,
+                             const bvector &steering, double max_error) {
+    auto table = std::dynamic_pointer_cast<const bp_table>(
+        bp_table::create(beam, frequencies, steering, max_error));
+    if (table->error() > max_error) {
+        std::cout << "rvbts_collection: beam table error " << table->error()
+                  << " exceeds " << max_error << ", using exact beam"
+                  << std::endl;
+        return beam;
+    }
+    return table;
+}
+
+}  // namespace
+
+/**
+ * Replaces the source and receiver beam patterns with lookup tables.
+ */
+void rvbts_collection::beam_tables(const transmit_list &transmits,
+                                   const std::vector<bvector> &steerings,
+                                   double max_error) {
+    std::vector<double> fcenters;
+    for (const auto &transmit : transmits) {
+        fcenters.push_back(transmit->fcenter);
+    }
+    if (fcenters.empty()) {
+        return;
+    }
+    std::sort(fcenters.begin(), fcenters.end());
+    fcenters.erase(std::unique(fcenters.begin(), fcenters.end()),
+                   fcenters.end());
+    const seq_vector::csptr frequencies(new seq_data(fcenters));
+
+    auto steering = steerings.begin();
+    for (const auto &transmit : transmits) {
+        const int mode = transmit->transmit_mode;
+        const bvector &src_steering = *steering++;
+        if (find_src_table(mode, src_steering) == nullptr) {
+            _src_tables.push_back(
+                {mode, src_steering,
+                 create_table(_source->src_beam(mode), frequencies,
+                              src_steering, max_error)});
+        }
+    }
+    for (size_t c = 0; c < _rcv_keys.size(); ++c) {
+        _rcv_beams[c] = create_table(_rcv_patterns[c], frequencies,
+                                     _rcv_steerings[c], max_error);
+    }
+    _beam_table_error = max_error;
+}
+
+/**
+ * Finds the source beam lookup table for a transmit mode and steering.
+ */
+const rvbts_collection::src_table *rvbts_collection::find_src_table(
+    int transmit_mode, const bvector &steering) const {
+    for (const auto &table : _src_tables) {
+        if (table.transmit_mode == transmit_mode &&
+            table.steering.front() == steering.front() &&
+            table.steering.right() == steering.right() &&
+            table.steering.up() == steering.up()) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Single frequency axis used to compute beam levels at the center
+ * frequency of a transmission.
+ */
+const seq_vector::csptr &rvbts_collection::workspace::frequency_axis(
+    double fcenter) {
+    auto &axis = frequencies[fcenter];
+    if (!axis) {
+        axis = seq_vector::csptr(new seq_linear(fcenter, 1.0, 1));
+    }
+    return axis;
+}
+
+/**
+ * Creates a netCDF file for streaming.
+ */
+void rvbts_collection::init_netcdf(const char *filename) {
+    _nc_file = std::make_unique<netCDF::NcFile>(filename,
+                                                netCDF::NcFile::replace);
+    _nc_time_series = write_header(_nc_file.get());
+    _stream_file = filename;
+}
+
+/**
+ * Writes the window of travel times kept in memory to the streaming file.
+ */
+void rvbts_collection::save_netcdf() {
+    const size_t num_times = _travel_times->size();
+    if (_nc_file == nullptr || _window_first >= num_times) {
+        return;
+    }
+    const size_t count =
+        std::min(_time_series.size2(), num_times - _window_first);
+    const std::vector<size_t> start{0, _window_first};
+    const std::vector<size_t> counts{1, count};
+    std::vector<size_t> index(start);
+    for (size_t r = 0; r < _time_series.size1(); ++r) {
+        index[0] = r;
+        _nc_time_series.putVar(index, counts, &_time_series(r, 0));
+    }
+}
+
+/**
+ * Closes the streaming file, and removes it if incomplete.
+ */
+void rvbts_collection::close_netcdf(bool complete) {
+    _nc_file.reset();
+    if (!complete) {
+        std::remove(_stream_file.c_str());
+        _stream_file.clear();
+    }
+}
+
 /**
  * Writes reverberation time series data to disk.
  */
 void rvbts_collection::write_netcdf(const char *filename) const {
-	netCDF::NcFile nc_file(filename, netCDF::NcFile::replace);
+    if (streaming()) {
+        throw std::logic_error("rvbts_collection: time series streamed to " +
+                               _stream_file);
+    }
+    netCDF::NcFile nc_file(filename, netCDF::NcFile::replace);
+    netCDF::NcVar time_series_var = write_header(&nc_file);
+    time_series_var.putVar(_time_series.data().begin());
+}
 
+/**
+ * Writes everything except the time series to a netCDF file.
+ */
+netCDF::NcVar rvbts_collection::write_header(netCDF::NcFile *file) const {
+    netCDF::NcFile &nc_file = *file;
     auto num_channels = (long)_time_series.size1();
-    auto num_times = (long)_time_series.size2();
+    auto num_times = (long)_travel_times->size();
 
     // dimensions
 
@@ -220,5 +703,5 @@ void rvbts_collection::write_netcdf(const char *filename) const {
     seq_linear channels(0.0, 1.0, (size_t)num_channels);
     channels_var.putVar(channels.data().begin());
     time_var.putVar(_travel_times->data().begin());
-    time_series_var.putVar(_time_series.data().begin());
+    return time_series_var;
 }
@@ -4,7 +4,10 @@
  */
 #pragma once
 
+#include <usml/beampatterns/bp_model.h>
+#include <usml/biverbs/biverb_collection.h>
 #include <usml/biverbs/biverb_model.h>
+#include <usml/netcdf-cxx/netcdfcpp.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/transmit/transmit_model.h>
 #include <usml/types/orientation.h>
@@ -13,11 +16,17 @@
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <cstddef>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace usml {
 namespace rvbts {
 
+using namespace usml::beampatterns;
 using namespace usml::biverbs;
 using namespace usml::sensors;
 using namespace usml::threads;
@@ -33,6 +42,38 @@ using namespace usml::types;
  * This implementation supports beam level simulations where each receiver
  * channel has its own beam pattern and steering. It lacks the phase delay
  * between channels needed to support element level simulation.
+ *
+ * The receiver beam patterns and steerings are captured when the collection
+ * is constructed, so that add_biverb() does not need to lock the receiver
+ * for each channel. The Gaussian envelope for each bistatic eigenverb is
+ * computed once, and then scaled into the time series for each channel.
+ *
+ * The simple form of add_biverb() is not thread safe, because it uses
+ * workspace variables inside this class to avoid memory allocation.
+ * Multiple threads can update the same collection if each thread provides
+ * its own workspace, and limits its updates to a range of time indices that
+ * does not overlap with any other thread.
+ *
+ * The rvbts_generator uses a second, incremental, interface. It first
+ * computes the terms of each bistatic eigenverb that do not depend on the
+ * transmission: the source arrival vector in array coordinates, and the
+ * eigenverb power and receiver beam levels at each transmit frequency.
+ * It then computes the time series contribution of each transmission
+ * separately, and sums them to create the final time series. The terms are
+ * kept with the collection. When the transmit schedule changes, the next
+ * generator re-uses the terms from the previous collection. A generator
+ * that re-uses terms also keeps the contribution of each transmission, so
+ * that later generators can re-use the transmissions that did not change.
+ *
+ * Long ping cycles with fine time resolution and many channels can make
+ * the full time series too large to keep in memory. In streaming mode,
+ * the collection only keeps a window of travel times in memory. The
+ * rvbts_generator computes each window, writes it to a netCDF file with
+ * save_netcdf(), and then slides the window forward. Transmit contributions
+ * are not kept in streaming mode, so only the terms are re-used by the
+ * next generator. The streamed file belongs to the collection, and it is
+ * removed when the collection is destroyed. Clients that want to keep the
+ * file must copy it while they still hold a reference to the collection.
  */
 class USML_DECLSPEC rvbts_collection {
    public:
@@ -46,6 +87,89 @@ class USML_DECLSPEC rvbts_collection {
      */
     static double power_threshold;
 
+    /**
+     * Memory re-used by add_biverb() to avoid allocations for each
+     * bistatic eigenverb. Each thread that updates a collection must
+     * use its own workspace.
+     */
+    struct workspace {
+        /// Single frequency axes used for beam levels, indexed by fcenter.
+        std::map<double, seq_vector::csptr> frequencies;
+
+        /// Beam level at a single frequency.
+        vector<double> level = vector<double>(1);
+
+        /// Gaussian envelope of a bistatic eigenverb.
+        std::vector<double> gaussian;
+
+        /// Contribution of a single transmission to a range of travel times.
+        matrix<double> series;
+
+        /**
+         * Single frequency axis used to compute beam levels at the center
+         * frequency of a transmission. Axes are cached for re-use across
+         * eigenverbs.
+         *
+         * @param fcenter   Center frequency of the transmission (Hz).
+         * @return          Frequency axis with fcenter as its only element.
+         */
+        const seq_vector::csptr& frequency_axis(double fcenter);
+    };
+
+    /**
+     * Terms of each bistatic eigenverb that depend on the center frequency of
+     * a transmission, but not its other properties.
+     */
+    struct frequency_terms {
+        /// Eigenverb power interpolated to the center frequency.
+        std::vector<double> power;
+
+        /// Receiver beam level, stored in eigenverb, channel order.
+        std::vector<double> rcv_level;
+    };
+
+    /**
+     * Terms of each bistatic eigenverb that do not depend on the
+     * transmission. Immutable once computed, so that it can be shared
+     * by successive collections for the same bistatic eigenverbs.
+     */
+    struct biverb_terms {
+        /// Bistatic eigenverbs used to compute these terms.
+        biverb_collection::csptr biverbs;
+
+        /// Bistatic eigenverbs for all interfaces, in travel time order.
+        std::vector<const biverb_model*> verbs;
+
+        /// Index of the first eigenverb for each interface in verbs.
+        std::vector<size_t> offsets;
+
+        /// Longest duration of any eigenverb in verbs (sec).
+        double max_duration{0.0};
+
+        /// Source arrival front, right, up in array coordinates, per verb.
+        std::vector<double> src_arrival;
+
+        /// Frequency dependent terms, indexed by center frequency.
+        std::map<double, std::shared_ptr<const frequency_terms> > frequencies;
+    };
+
+    /**
+     * Time series contribution of a single transmission.
+     */
+    struct transmit_series {
+        /// Single waveform in a transmission schedule.
+        transmit_model::csptr transmit;
+
+        /// Transmit steering relative to source array.
+        bvector steering;
+
+        /// Source beam pattern used for this transmission.
+        bp_model::csptr src_beam;
+
+        /// Reverberation time series for each receiver channel, if kept.
+        std::shared_ptr<const matrix<double> > series;
+    };
+
     /**
      * Initialize model parameters with state of sensor_pair at the time that
      * reverberation generator was created.
@@ -59,13 +183,21 @@ class USML_DECLSPEC rvbts_collection {
      * @param receiver_orient Receiver orientation at this time.
      * @param receiver_speed  Receiver speed at this time.
      * @param travel_times    Times at which reverberation is computed (sec).
+     * @param window          Number of travel times kept in memory in
+     *                        streaming mode. Zero keeps the whole time
+     *                        series in memory.
      */
     rvbts_collection(
         const sensor_model::sptr& source, const wposition1 source_pos,
         const orientation& source_orient, const double source_speed,
         const sensor_model::sptr& receiver, const wposition1 receiver_pos,
         const orientation& receiver_orient, const double receiver_speed,
-        const seq_vector::csptr& travel_times);
+        const seq_vector::csptr& travel_times, size_t window = 0);
+
+    /**
+     * Closes the streaming file, if any, and removes it from disk.
+     */
+    ~rvbts_collection();
 
     // Reference to source sensor.
     sensor_model::sptr source() const { return _source; }
@@ -94,9 +226,27 @@ class USML_DECLSPEC rvbts_collection {
     /// Receiver times at which reverberation is computed (sec).
     seq_vector::csptr travel_times() const { return _travel_times; }
 
-    /// Reverberation time series for each receiver channel.
+    /**
+     * Reverberation time series for each receiver channel. In streaming
+     * mode, this only contains the window of travel times that starts at
+     * window_first().
+     */
     const matrix<double>& time_series() const { return _time_series; }
 
+    /// Index of the first travel time in time_series().
+    size_t window_first() const { return _window_first; }
+
+    /// True if only a window of the time series is kept in memory.
+    bool streaming() const {
+        return _time_series.size2() < _travel_times->size();
+    }
+
+    /**
+     * Name of the file that the time series was streamed to, if any.
+     * The file is removed when this collection is destroyed.
+     */
+    const std::string& stream_file() const { return _stream_file; }
+
     /**
      * Adds the intensity contribution for a single bistatic eigenverb.
      * \f[
@@ -124,6 +274,201 @@ class USML_DECLSPEC rvbts_collection {
                     const transmit_model::csptr& transmit,
                     const bvector& steering);
 
+    /**
+     * Adds the intensity contribution for a single bistatic eigenverb to a
+     * limited range of time indices. Allows multiple threads to update
+     * disjoint time windows of the same collection in parallel.
+     *
+     * @param verb	   	    Bistatic eigenverb for time series contribution.
+     * @param transmit	    Single waveform in a transmission schedule.
+     * @param steering 	    Transmit steering relative to source array.
+     * @param time_first    First time index to update.
+     * @param time_last     One past the last time index to update.
+     * @param work          Memory re-used across calls by this thread.
+     */
+    void add_biverb(const biverb_model::csptr& verb,
+                    const transmit_model::csptr& transmit,
+                    const bvector& steering, size_t time_first,
+                    size_t time_last, workspace* work);
+
+    /**
+     * Replaces the source and receiver beam patterns with bp_table lookup
+     * tables at the center frequencies of a transmission schedule. Source
+     * beams are tabulated for the transmit mode and steering of each
+     * transmission. Receiver beams are tabulated for the steering of each
+     * channel. Beams requested for other transmissions are computed
+     * from the original beam patterns. Uses bp_table::create() so that
+     * tables still held by the previous collection are re-used. If the
+     * size limit of a table stops refinement before it meets max_error,
+     * that beam is computed from its original pattern instead. Must be
+     * called before the first call to add_biverb().
+     *
+     * @param transmits     Transmission schedule for the source.
+     * @param steerings     Source steering for each transmission, relative
+     *                      to the source array.
+     * @param max_error     Maximum interpolation error in beam level
+     *                      (linear units).
+     */
+    void beam_tables(const transmit_list& transmits,
+                     const std::vector<bvector>& steerings, double max_error);
+
+    /// Terms of each bistatic eigenverb that do not depend on transmission.
+    std::shared_ptr<const biverb_terms> terms() const { return _terms; }
+
+    /// Time series contribution of each transmission, null if not kept.
+    const std::vector<transmit_series>& transmits() const {
+        return _transmits;
+    }
+
+    /**
+     * True if the biverb_terms of another collection can be used by this
+     * collection. Requires the same source and receiver orientations,
+     * receiver channels, and beam tables.
+     *
+     * @param other     Collection that owns the terms.
+     * @return          True if terms can be re-used.
+     */
+    bool same_terms(const rvbts_collection& other) const;
+
+    /**
+     * True if the time series contribution of a transmission in another
+     * collection can be used by this collection. Requires re-usable terms,
+     * the same travel times, and the same transmission.
+     *
+     * @param other     Collection that owns the contribution.
+     * @param current   Transmission in this collection.
+     * @param previous  Transmission in the other collection.
+     * @return          True if the contribution can be re-used.
+     */
+    bool same_series(const rvbts_collection& other,
+                     const transmit_series& current,
+                     const transmit_series& previous) const;
+
+    /**
+     * Creates empty terms for a collection of bistatic eigenverbs.
+     * Lists the eigenverbs for every interface, and allocates memory
+     * for the source arrivals. Records where each interface starts in the
+     * list, and the longest eigenverb duration, so that add_transmit()
+     * can find eigenverbs by travel time.
+     *
+     * @param biverbs   Bistatic eigenverbs for this pair.
+     * @return          Terms that still need compute_arrivals().
+     */
+    static std::shared_ptr<biverb_terms> create_terms(
+        const biverb_collection::csptr& biverbs);
+
+    /**
+     * Computes the source arrival vectors for a range of eigenverbs.
+     *
+     * @param terms     Terms to be updated.
+     * @param first     First eigenverb to update.
+     * @param last      One past the last eigenverb to update.
+     */
+    void compute_arrivals(biverb_terms* terms, size_t first,
+                          size_t last) const;
+
+    /**
+     * Computes eigenverb power and receiver beam levels for a range of
+     * eigenverbs at one center frequency.
+     *
+     * @param terms     Terms for all eigenverbs.
+     * @param fcenter   Center frequency of the transmission (Hz).
+     * @param result    Frequency dependent terms to be updated.
+     * @param first     First eigenverb to update.
+     * @param last      One past the last eigenverb to update.
+     * @param work      Memory re-used across calls by this thread.
+     */
+    void compute_terms(const biverb_terms& terms, double fcenter,
+                       frequency_terms* result, size_t first, size_t last,
+                       workspace* work) const;
+
+    /**
+     * Adds the contribution of every eigenverb for a single transmission to a
+     * limited range of time indices. Uses the same equation as add_biverb(),
+     * but takes the transmit independent terms from a cache. Uses
+     * biverb_collection::biverbs_window() to skip the eigenverbs whose
+     * arrival envelope can not reach this range of time indices.
+     *
+     * @param terms         Terms for all eigenverbs, including the
+     *                      frequency terms for this transmission.
+     * @param transmit      Transmission to compute.
+     * @param series        Time series contribution to be updated.
+     * @param time_first    First time index to update.
+     * @param time_last     One past the last time index to update.
+     * @param work          Memory re-used across calls by this thread.
+     * @param offset        Time index of the first column in series.
+     */
+    void add_transmit(const biverb_terms& terms,
+                      const transmit_series& transmit, matrix<double>* series,
+                      size_t time_first, size_t time_last, workspace* work,
+                      size_t offset = 0) const;
+
+    /**
+     * Stores the terms and transmit contributions used to compute this
+     * collection.
+     *
+     * @param terms     Terms of each bistatic eigenverb.
+     * @param transmits Time series contribution of each transmission.
+     */
+    void incremental(std::shared_ptr<const biverb_terms> terms,
+                     std::vector<transmit_series> transmits);
+
+    /**
+     * Sums the contributions of each transmission into the time series
+     * for a limited range of time indices.
+     *
+     * @param time_first    First time index to update.
+     * @param time_last     One past the last time index to update.
+     */
+    void sum_transmits(size_t time_first, size_t time_last);
+
+    /**
+     * Moves the window of travel times kept in memory, and clears its
+     * contents. Used in streaming mode after the previous window has been
+     * saved.
+     *
+     * @param time_first    Index of the first travel time in the window.
+     */
+    void slide_window(size_t time_first);
+
+    /**
+     * Adds the contribution of every transmission to a limited range of
+     * time indices in the window kept in memory. Computes each transmission
+     * separately and sums them in schedule order, so that the result matches
+     * the sum_transmits() result for the same transmissions. Used when
+     * transmit contributions are not stored, which includes streaming mode.
+     * Uses the terms and transmissions passed to incremental().
+     *
+     * @param time_first    First time index to update.
+     * @param time_last     One past the last time index to update.
+     *                      Must not extend past the end of the window.
+     * @param work          Memory re-used across calls by this thread.
+     */
+    void accumulate_transmits(size_t time_first, size_t time_last,
+                              workspace* work);
+
+    /**
+     * Creates a netCDF file for streaming, and writes everything except
+     * the time series. Uses the same format as write_netcdf().
+     *
+     * @param filename  Name of the file to write.
+     */
+    void init_netcdf(const char* filename);
+
+    /**
+     * Writes the window of travel times kept in memory to the streaming
+     * file. Windows that extend past the last travel time are truncated.
+     */
+    void save_netcdf();
+
+    /**
+     * Closes the streaming file. Removes the file if the time series
+     * was not completed, so that aborted runs do not leave partial files.
+     *
+     * @param complete  True if every window was written to the file.
+     */
+    void close_netcdf(bool complete);
+
     /**
      * Writes reverberation time series data to disk.
      *
@@ -189,6 +534,10 @@ class USML_DECLSPEC rvbts_collection {
      *   ...
      * }
      * </pre>
+     *
+     * @param filename  Name of the file to write.
+     * @throw logic_error   If the time series was streamed to a file,
+     *                      because only one window is in memory.
      */
     void write_netcdf(const char* filename) const;
 
@@ -225,6 +574,94 @@ class USML_DECLSPEC rvbts_collection {
 
     /// Reverberation time series for each receiver channel.
     matrix<double> _time_series;
+
+    /// Index of the first travel time in _time_series.
+    size_t _window_first = 0;
+
+    /// Name of the file that the time series was streamed to, if any.
+    std::string _stream_file;
+
+    /// @name Streaming netCDF file
+    /// @{
+    std::unique_ptr<netCDF::NcFile> _nc_file;
+    netCDF::NcVar _nc_time_series;
+    /// @}
+
+    /// Receiver channel keys at time that class constructed.
+    std::vector<int> _rcv_keys;
+
+    /// Receiver beam pattern for each channel in _rcv_keys.
+    std::vector<bp_model::csptr> _rcv_beams;
+
+    /// Receiver beam pattern for each channel, before beam_tables().
+    std::vector<bp_model::csptr> _rcv_patterns;
+
+    /// Maximum interpolation error used by beam_tables(), zero if none.
+    double _beam_table_error = 0.0;
+
+    /// Terms of each bistatic eigenverb that do not depend on transmission.
+    std::shared_ptr<const biverb_terms> _terms;
+
+    /// Time series contribution of each transmission.
+    std::vector<transmit_series> _transmits;
+
+    /// Receiver steering for each channel in _rcv_keys.
+    std::vector<bvector> _rcv_steerings;
+
+    /// Workspace used by the simple form of add_biverb().
+    workspace _work;
+
+    /// Source beam lookup table for one transmit mode and steering.
+    struct src_table {
+        int transmit_mode;
+        bvector steering;
+        bp_model::csptr beam;
+    };
+
+    /// Source beam lookup tables created by beam_tables().
+    std::vector<src_table> _src_tables;
+
+    /**
+     * Finds the source beam lookup table for a transmit mode and steering.
+     *
+     * @param transmit_mode Source beam number.
+     * @param steering      Transmit steering relative to source array.
+     * @return              Lookup table, or null if beam_tables() did not
+     *                      create a table for this mode and steering.
+     */
+    const src_table* find_src_table(int transmit_mode,
+                                    const bvector& steering) const;
+
+    /**
+     * Eigenverb power interpolated to the center frequency of a transmission.
+     *
+     * @param verb      Bistatic eigenverb.
+     * @param fcenter   Center frequency of the transmission (Hz).
+     * @return          Interpolated eigenverb power.
+     */
+    static double interpolate_power(const biverb_model& verb, double fcenter);
+
+    /**
+     * Evaluates the Gaussian envelope of a bistatic eigenverb over a window
+     * of time indices, normalized by its duration.
+     *
+     * @param delay     Arrival time of the envelope peak (sec).
+     * @param duration  Duration of the envelope (sec).
+     * @param first     First time index in the window.
+     * @param last      One past the last time index in the window.
+     * @param work      Memory re-used across calls by this thread.
+     * @return          Envelope value for each time in the window.
+     */
+    const double* envelope(double delay, double duration, size_t first,
+                           size_t last, workspace* work) const;
+
+    /**
+     * Writes everything except the time series to a netCDF file.
+     *
+     * @param file  File to be written.
+     * @return      Time series variable, which has not been written.
+     */
+    netCDF::NcVar write_header(netCDF::NcFile* file) const;
 };
 
 /// @}
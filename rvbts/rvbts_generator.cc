@@ -6,6 +6,7 @@
 #include <usml/managed/managed_obj.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/rvbts/rvbts_generator.h>
+#include <usml/threads/parallel_chunks.h>
 #include <usml/types/bvector.h>
 #include <usml/types/seq_linear.h>
 
@@ -13,8 +14,16 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/matrix_expression.hpp>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace usml::rvbts;
 
@@ -25,7 +34,8 @@ rvbts_generator::rvbts_generator(const sensor_pair::sptr& pair,
                                  const sensor_model::sptr& source,
                                  const sensor_model::sptr& receiver,
                                  const double treverb,
-                                 const biverb_collection::csptr& biverbs)
+                                 const biverb_collection::csptr& biverbs,
+                                 const rvbts_collection::csptr& previous)
     : _description(pair->description()),
       _source(source),
       _source_pos(source->position()),
@@ -39,6 +49,7 @@ rvbts_generator::rvbts_generator(const sensor_pair::sptr& pair,
       _travel_times(new seq_linear(receiver->time_minimum(), treverb,
                                    receiver->time_maximum())),
       _biverbs(biverbs),
+      _previous(previous),
       _source_steering(compute_src_steering()) {
     add_listener(pair.get());
 }
@@ -79,6 +90,96 @@ matrix<double> rvbts_generator::compute_src_steering() const {
     return steering;
 }
 
+/**
+ * Number of threads used to compute reverberation for each sensor pair.
+ */
+unsigned rvbts_generator::num_workers = std::thread::hardware_concurrency();
+
+/**
+ * Number of travel times processed as a single unit of work.
+ */
+size_t rvbts_generator::chunk_size = 1024;
+
+/**
+ * Maximum interpolation error for source and receiver beam lookup tables.
+ */
+double rvbts_generator::beam_table_error = 0.0;
+
+/**
+ * Number of travel times kept in memory when streaming the time series.
+ */
+size_t rvbts_generator::stream_window = 0;
+
+/**
+ * Directory used for streamed time series files.
+ */
+std::string rvbts_generator::stream_directory = ".";
+
+namespace {
+
+/**
+ * Splits a range of items into chunks and returns the bounds of one chunk.
+ */
+std::pair<size_t, size_t> chunk_bounds(size_t index, size_t size,
+                                       size_t num_items) {
+    const size_t first = index * size;
+    return {first, std::min(first + size, num_items)};
+}
+
+}  // namespace
+
+/**
+ * Executes one phase of the calculation on this thread and on helper tasks
+ * in the thread pool.
+ */
+bool rvbts_generator::run_phase(
+    size_t num_chunks,
+    const std::function<void(size_t, rvbts_collection::workspace*)>& task) {
+    std::vector<rvbts_collection::workspace> work(
+        parallel_chunks::num_threads(num_chunks, num_workers));
+    auto process = [&](size_t index, size_t worker) {
+        task(index, &work[worker]);
+    };
+    const bool ok =
+        parallel_chunks::run(num_chunks, num_workers, process, &_abort);
+    return ok && !_abort;
+}
+
+/**
+ * Computes the time series one window at a time, and streams each window
+ * to a netCDF file.
+ */
+bool rvbts_generator::stream_series(rvbts_collection* collection) {
+    std::ostringstream filename;
+    filename << stream_directory << "/rvbts_"
+             << sensor_pair::generate_hash_key(_source->keyID(),
+                                               _receiver->keyID())
+             << "_" << id() << ".nc";
+    collection->init_netcdf(filename.str().c_str());
+
+    const size_t num_times = _travel_times->size();
+    const size_t window = collection->time_series().size2();
+    const size_t time_chunk = std::max(chunk_size, size_t(1));
+    bool ok = true;
+    for (size_t first = 0; ok && first < num_times; first += window) {
+        const size_t num_window = std::min(window, num_times - first);
+        collection->slide_window(first);
+        const auto compute_series = [&](size_t index,
+                                        rvbts_collection::workspace* work) {
+            auto bounds = chunk_bounds(index, time_chunk, num_window);
+            collection->accumulate_transmits(first + bounds.first,
+                                             first + bounds.second, work);
+        };
+        ok = run_phase((num_window + time_chunk - 1) / time_chunk,
+                       compute_series);
+        if (ok) {
+            collection->save_netcdf();
+        }
+    }
+    collection->close_netcdf(ok);
+    return ok;
+}
+
 /**
  * Compute reverberation time series for a bistatic pair.
  */
@@ -88,35 +189,142 @@ void rvbts_generator::run() {
              << " rvbts_generator: *** aborted before execution ***" << endl;
         return;
     }
+    cout << "task #" << id() << " rvbts_generator: " << _description << endl;
 
+    const size_t num_times = _travel_times->size();
+    const size_t window = (stream_window < num_times) ? stream_window : 0;
     auto* collection = new rvbts_collection(
         _source, _source_pos, _source_orient, _source_speed, _receiver,
-        _receiver_pos, _receiver_orient, _receiver_speed, _travel_times);
+        _receiver_pos, _receiver_orient, _receiver_speed, _travel_times,
+        window);
     rvbts_collection::csptr result(collection);
 
-    cout << "task #" << id() << " rvbts_generator: " << _description << endl;
+    std::vector<rvbts_collection::transmit_series> transmits;
+    std::vector<bvector> steerings;
+    size_t n = 0;
+    for (const auto& transmit : _transmit_schedule) {
+        bvector steering(
+            matrix_column<const matrix<double> >(_source_steering, n++));
+        steerings.push_back(steering);
+        transmits.push_back({transmit, steering,
+                             _source->src_beam(transmit->transmit_mode),
+                             nullptr});
+    }
+    if (beam_table_error > 0.0) {
+        collection->beam_tables(_transmit_schedule, steerings,
+                                beam_table_error);
+    }
 
-    // loop through eigenverbs for each interface
-
-    auto num_interfaces = _biverbs->num_interfaces();
-    for (size_t interface = 0; interface < num_interfaces; ++interface) {
-        auto verb_list = _biverbs->biverbs(interface);
-        for (const auto& verb : verb_list) {
-            int n = 0;
-            for (const auto& transmit : _transmit_schedule) {
-                bvector steering(
-                    matrix_column<matrix<double> >(_source_steering, n));
-                collection->add_biverb(verb, transmit, steering);
-                if (_abort) {
-                    cout << "task #" << id()
-                         << " rvbts_generator *** aborted during execution ***"
-                         << endl;
-                    return;
+    // re-use terms from previous calculation if possible
+
+    const rvbts_collection* previous = nullptr;
+    if (_previous != nullptr && _previous->terms() != nullptr &&
+        _previous->terms()->biverbs == _biverbs &&
+        collection->same_terms(*_previous)) {
+        previous = _previous.get();
+    }
+    std::shared_ptr<rvbts_collection::biverb_terms> terms;
+    if (previous != nullptr) {
+        terms = std::make_shared<rvbts_collection::biverb_terms>(
+            *previous->terms());
+    } else {
+        terms = rvbts_collection::create_terms(_biverbs);
+    }
+    const size_t num_verbs = terms->verbs.size();
+    const size_t num_channels = _receiver->rcv_num_keys();
+    const size_t verb_chunk = std::max(size_t(1), chunk_size / 16);
+    const size_t num_verb_chunks = (num_verbs + verb_chunk - 1) / verb_chunk;
+
+    // compute source arrivals, and the terms for each new frequency
+
+    std::vector<std::pair<double, rvbts_collection::frequency_terms*> > added;
+    for (const auto& transmit : _transmit_schedule) {
+        auto& entry = terms->frequencies[transmit->fcenter];
+        if (entry == nullptr) {
+            auto* fterms = new rvbts_collection::frequency_terms();
+            fterms->power.resize(num_verbs);
+            fterms->rcv_level.resize(num_verbs * num_channels);
+            entry.reset(fterms);
+            added.emplace_back(transmit->fcenter, fterms);
+        }
+    }
+    const bool arrivals = previous == nullptr;
+    const auto compute_terms = [&](size_t index,
+                                   rvbts_collection::workspace* work) {
+        auto bounds = chunk_bounds(index, verb_chunk, num_verbs);
+        if (arrivals) {
+            collection->compute_arrivals(terms.get(), bounds.first,
+                                         bounds.second);
+        }
+        for (const auto& add : added) {
+            collection->compute_terms(*terms, add.first, add.second,
+                                      bounds.first, bounds.second, work);
+        }
+    };
+    bool ok = run_phase(
+        (arrivals || !added.empty()) ? num_verb_chunks : 0, compute_terms);
+
+    // keep the contribution of each transmission only if this calculation
+    // re-uses terms from the previous one, which is the case where the next
+    // calculation can re-use them too. Re-use contributions from the
+    // previous calculation, if possible, and allocate memory for the rest.
+
+    const bool keep_series = previous != nullptr && !collection->streaming();
+    std::vector<std::pair<const rvbts_collection::transmit_series*,
+                          matrix<double>*> >
+        compute;
+    if (keep_series) {
+        for (auto& transmit : transmits) {
+            for (const auto& old : previous->transmits()) {
+                if (collection->same_series(*previous, transmit, old)) {
+                    transmit.series = old.series;
+                    break;
                 }
-                ++n;
             }
+            if (transmit.series == nullptr) {
+                auto* series =
+                    new matrix<double>(num_channels, _travel_times->size());
+                series->clear();
+                transmit.series.reset(series);
+                compute.emplace_back(&transmit, series);
+            }
+        }
+    }
+
+    // compute the contribution of each new transmission, and sum them,
+    // in chunks of travel time, or accumulate every transmission directly
+    // into the time series if contributions are not kept
+
+    const size_t time_chunk = std::max(chunk_size, size_t(1));
+    const size_t num_time_chunks = (num_times + time_chunk - 1) / time_chunk;
+    collection->incremental(terms, transmits);
+    const auto compute_series = [&](size_t index,
+                                    rvbts_collection::workspace* work) {
+        auto bounds = chunk_bounds(index, time_chunk, num_times);
+        if (!keep_series) {
+            collection->accumulate_transmits(bounds.first, bounds.second,
+                                             work);
+            return;
+        }
+        for (const auto& item : compute) {
+            collection->add_transmit(*terms, *item.first, item.second,
+                                     bounds.first, bounds.second, work);
         }
+        collection->sum_transmits(bounds.first, bounds.second);
+    };
+    if (collection->streaming()) {
+        ok = ok && stream_series(collection);
+    } else {
+        ok = ok && run_phase(num_time_chunks, compute_series);
+    }
+    if (!ok) {
+        cout << "task #" << id()
+             << " rvbts_generator *** aborted during execution ***" << endl;
+        return;
     }
+    const size_t num_computed = keep_series ? compute.size() : transmits.size();
+    cout << "task #" << id() << " rvbts_generator: computed " << num_computed
+         << " of " << transmits.size() << " transmits" << endl;
 
     // notify listeners of results
 
@@ -18,6 +18,9 @@
 #include <usml/usml_config.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
 
 namespace usml {
 namespace rvbts {
@@ -41,6 +44,51 @@ class USML_DECLSPEC rvbts_generator
     : public thread_task,
       public update_notifier<rvbts_collection::csptr> {
    public:
+    /**
+     * Number of threads used to compute reverberation for each sensor pair,
+     * including the thread running this task. Defaults to the number of cores
+     * on this machine. A value of one computes all reverberation on this
+     * thread.
+     */
+    static unsigned num_workers;
+
+    /**
+     * Number of travel times processed as a single unit of work.
+     * Defaults to 1024.
+     */
+    static size_t chunk_size;
+
+    /**
+     * Maximum interpolation error for source and receiver beam lookup
+     * tables (linear units). If this is greater than zero, each beam is
+     * tabulated at the transmit frequencies before the reverberation is
+     * computed, and then beam levels are interpolated from these tables.
+     * Defaults to zero, which computes every beam level from its beam pattern.
+     */
+    static double beam_table_error;
+
+    /**
+     * Number of travel times kept in memory when streaming the time series.
+     * If this is greater than zero, and less than the number of travel
+     * times, the time series is computed one window of this size at a time,
+     * and each window is written to a netCDF file in stream_directory
+     * before the next one is computed. The collection passed to listeners
+     * only keeps the last window in memory. Defaults to zero, which keeps
+     * the whole time series in memory.
+     */
+    static size_t stream_window;
+
+    /**
+     * Directory used for streamed time series files. Each generator
+     * writes to a file named "rvbts_<hash_key>_<task id>.nc", so that an
+     * aborted run can not overwrite the file of a collection that has
+     * already been published. Each file is removed when its
+     * rvbts_collection is destroyed, so only the files of collections
+     * that are still referenced remain on disk. Defaults to the current
+     * directory.
+     */
+    static std::string stream_directory;
+
     /**
      * Initialize generator with state of sensor_pair at this time. Makes copies
      * of the position, orientation, speed, transmit pulses, and bistatic
@@ -52,16 +100,42 @@ class USML_DECLSPEC rvbts_generator
      * @param receiver    	Reference to the receiver for this pair.
      * @param treverb		Time increment for reverberation time series.
      * @param biverbs		Overlap of source and receiver eigenverbs.
+     * @param previous      Previous reverberation for this pair, if any.
+     *                      Its transmit independent terms, and the
+     *                      contributions of unchanged transmissions, are
+     *                      re-used when they are still valid.
      */
     rvbts_generator(const sensor_pair::sptr& pair,
                     const sensor_model::sptr& source,
                     const sensor_model::sptr& receiver, const double treverb,
-                    const biverb_collection::csptr& biverbs);
+                    const biverb_collection::csptr& biverbs,
+                    const rvbts_collection::csptr& previous = nullptr);
 
     /**
      * Compute reverberation time series for a bistatic pair. Loops through all
      * of the bistatic eigenverbs in the pair and computes their contribution to
      * each receiver channel as a function of travel time.
+     *
+     * The calculation has two phases. The first computes the terms of each
+     * bistatic eigenverb that do not depend on the transmission, in chunks of
+     * eigenverbs. The second computes the contribution of each transmission
+     * in chunks of chunk_size travel times, and sums them. In each phase,
+     * this task and up to num_workers-1 helper tasks in the thread pool claim
+     * chunks until none remain. Each thread only writes the results for its
+     * own chunk, so no locking is needed, and the result is independent of
+     * the number of threads.
+     *
+     * Terms and transmit contributions are re-used from the previous
+     * collection when the bistatic eigenverbs, sensor orientations, and
+     * beam patterns have not changed. This allows changes to the transmit
+     * schedule to only compute the transmissions that changed. A separate
+     * time series for each transmission is only kept when the terms are
+     * re-used. Otherwise each thread sums the transmissions for its chunk
+     * directly into the time series, which avoids allocating a full
+     * channel x time matrix per transmission.
+     *
+     * In streaming mode, the second phase is repeated for each window of
+     * stream_window travel times, and all transmissions are computed.
      */
     virtual void run();
 
@@ -79,6 +153,29 @@ class USML_DECLSPEC rvbts_generator
      */
     matrix<double> compute_src_steering() const;
 
+    /**
+     * Executes one phase of the calculation on this thread and on helper
+     * tasks in the thread pool.
+     *
+     * @param num_chunks    Number of chunks in this phase.
+     * @param task          Computes a single chunk using the workspace of
+     *                      the calling thread.
+     * @return              False if the calculation was aborted.
+     */
+    bool run_phase(
+        size_t num_chunks,
+        const std::function<void(size_t, rvbts_collection::workspace*)>& task);
+
+    /**
+     * Computes the time series one window at a time, and streams each window
+     * to a netCDF file. Requires the terms and transmissions to be stored in
+     * the collection by rvbts_collection::incremental().
+     *
+     * @param collection    Streaming collection to be computed.
+     * @return              False if the calculation was aborted.
+     */
+    bool stream_series(rvbts_collection* collection);
+
     /// Human readable name for this object instance.
     const std::string _description;
 
@@ -115,6 +212,9 @@ class USML_DECLSPEC rvbts_generator
     /// Overlap of source and receiver eigenverbs.
     const biverb_collection::csptr _biverbs;
 
+    /// Previous reverberation for this pair, if any.
+    const rvbts_collection::csptr _previous;
+
     /**
      * Source steerings relative to source array orientation. The rows represent
      * front, right, and up coordinates.  There is a column for each pulse in
@@ -5,31 +5,41 @@
 #include <usml/beampatterns/bp_model.h>
 #include <usml/beampatterns/bp_omni.h>
 #include <usml/biverbs/biverb_collection.h>
+#include <usml/biverbs/biverb_model.h>
 #include <usml/eigenrays/eigenray_collection.h>
 #include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/managed/managed_obj.h>
 #include <usml/managed/manager_template.h>
 #include <usml/managed/update_listener.h>
+#include <usml/netcdf-cxx/netcdfcpp.h>
 #include <usml/ocean/ocean_utils.h>
 #include <usml/platforms/platform_manager.h>
 #include <usml/platforms/platform_model.h>
 #include <usml/rvbts/rvbts.h>
 #include <usml/rvbts/rvbts_collection.h>
+#include <usml/rvbts/rvbts_generator.h>
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/sensors/sensor_pair.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
 #include <usml/threads/thread_task.h>
 #include <usml/transmit/transmit_cw.h>
 #include <usml/transmit/transmit_model.h>
 #include <usml/types/seq_linear.h>
+#include <usml/types/bvector.h>
+#include <usml/types/orientation.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition1.h>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <boost/test/unit_test.hpp>
+#include <fstream>
 #include <iostream>
 #include <list>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 BOOST_AUTO_TEST_SUITE(rvbts_test)
@@ -177,5 +187,321 @@ BOOST_AUTO_TEST_CASE(update_envelope) {
     sensor_manager::reset();
 }
 
+/**
+ * Adds a single bistatic eigenverb to a two channel receiver, and compares
+ * the time series in each channel to the analytic Gaussian envelope.
+ * Both channels use omni-directional beams, so their time series should
+ * be identical.
+ */
+BOOST_AUTO_TEST_CASE(gaussian_envelope) {
+    cout << "=== rvbts_test: gaussian_envelope ===" << endl;
+    auto beam = bp_model::csptr(new bp_omni());
+    wposition1 position(36.0, 16.0, -100.0);
+    sensor_model::sptr source(new sensor_model(1, "source", 0.0, position));
+    source->src_beam(0, beam);
+    sensor_model::sptr receiver(new sensor_model(2, "receiver", 0.0, position));
+    receiver->rcv_beam(0, beam);
+    receiver->rcv_beam(1, beam);
+
+    seq_vector::csptr travel_times(new seq_linear(0.0, 0.01, 401));
+    rvbts_collection collection(source, position, orientation(), 0.0,
+                                receiver, position, orientation(), 0.0,
+                                travel_times);
+
+    auto* verb = new biverb_model();
+    verb->travel_time = 2.0;
+    verb->frequencies = seq_vector::csptr(new seq_linear(1000.0, 10.0, 1));
+    verb->power = vector<double>(1, 1e-3);
+    verb->duration = 0.05;
+    verb->source_de = 0.0;
+    verb->source_az = 0.0;
+    verb->receiver_de = 0.0;
+    verb->receiver_az = 0.0;
+    biverb_model::csptr biverb(verb);
+
+    transmit_model::csptr transmit(
+        new transmit_cw("CW", 0.1, 1000.0, 0.0, 200.0));
+    collection.add_biverb(biverb, transmit, bvector(1.0, 0.0, 0.0));
+
+    // compute expected envelope, omni beam levels are 1.0
+
+    const double duration = verb->duration + transmit->duration;
+    const double delay = transmit->delay + verb->travel_time + duration;
+    const double level = (transmit->source_level + 1.0) +
+                         verb->power[0] * transmit->duration + 1.0;
+    const size_t first = travel_times->find_index(delay - 5.0 * duration);
+    const size_t last = travel_times->find_index(delay + 5.0 * duration);
+
+    const matrix<double>& series = collection.time_series();
+    BOOST_CHECK_EQUAL(series.size1(), 2);
+    for (size_t t = 0; t < travel_times->size(); ++t) {
+        double expected = 0.0;
+        if (t >= first && t < last) {
+            const double tau = ((*travel_times)[t] - delay) / duration;
+            expected = level * exp(-0.5 * tau * tau) /
+                       (duration * sqrt(TWO_PI));
+        }
+        BOOST_CHECK_CLOSE(series(0, t) + 1.0, expected + 1.0, 1e-10);
+        BOOST_CHECK_EQUAL(series(0, t), series(1, t));
+    }
+}
+
+/**
+ * Creates a bistatic pair for the update_envelope scenario, with two
+ * transmissions and a multi-channel receiver. Computes acoustics for
+ * this pair in the background, and waits for them to finish.
+ *
+ * @param num_channels  Number of omni-directional receiver channels.
+ * @return              Sensor pair with bistatic eigenverbs.
+ */
+static sensor_pair::sptr create_multichannel_pair(size_t num_channels) {
+    ocean_utils::make_iso(2000.0);
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 100.0, 1100.0));
+    sensor_mgr->frequencies(freq);
+
+    auto beam = bp_model::csptr(new bp_omni());
+    auto* source = new sensor_model(1, "source", 0.0,
+                                    wposition1(36.0, 16.0, -100.0));
+    source->compute_reverb(true);
+    source->multistatic(1);
+    source->time_maximum(8.0);
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 0.0, 200.0)));
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 1.0, 200.0)));
+    source->transmit_schedule(transmits);
+    sensor_mgr->add_sensor(sensor_model::sptr(source));
+
+    auto* receiver = new sensor_model(2, "receiver", 0.0,
+                                      wposition1(36.0, 16.0, -500.0));
+    receiver->compute_reverb(true);
+    receiver->multistatic(1);
+    receiver->time_maximum(8.0);
+    for (size_t n = 0; n < num_channels; ++n) {
+        const double az = 360.0 * double(n) / double(num_channels);
+        receiver->rcv_beam((int)n, beam, bvector(0.0, az));
+    }
+    sensor_mgr->add_sensor(sensor_model::sptr(receiver));
+    for (auto& platform : platform_manager::instance()->list()) {
+        platform->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+
+    sensor_pair::sptr pair = *(sensor_mgr->find_source(1).begin());
+    BOOST_REQUIRE(pair->biverbs() != nullptr);
+    cout << "biverbs="
+         << pair->biverbs()->biverbs(eigenverb_model::BOTTOM).size() << endl;
+    return pair;
+}
+
+/**
+ * Computes reverberation for the update_envelope scenario with one worker,
+ * and then with multiple workers, and compares the results. Uses a finer
+ * time increment and more receiver channels than update_envelope to give
+ * each worker a meaningful amount of work. Also checks that the time
+ * windows used to select biverbs for each chunk do not change the result.
+ * See studies/rvbts_speed for a benchmark of how this scales with the
+ * number of workers.
+ */
+BOOST_AUTO_TEST_CASE(parallel_rvbts) {
+    cout << "=== rvbts_test: parallel_rvbts ===" << endl;
+    const size_t num_channels = 16;
+    sensor_pair::sptr pair = create_multichannel_pair(num_channels);
+
+    // compute reverberation serially, and then with multiple workers
+
+    const unsigned num_workers = rvbts_generator::num_workers;
+    const size_t chunk_size = rvbts_generator::chunk_size;
+    rvbts_generator::chunk_size = 100;
+    matrix<double> results[2];
+    const unsigned workers[2] = {1, 4};
+    for (size_t n = 0; n < 2; ++n) {
+        rvbts_generator::num_workers = workers[n];
+        auto task = std::make_shared<rvbts_generator>(
+            pair, pair->source(), pair->receiver(), 0.001, pair->biverbs());
+        thread_controller::instance()->run(task);
+        thread_task::wait();
+        BOOST_REQUIRE(pair->rvbts() != nullptr);
+        results[n] = pair->rvbts()->time_series();
+    }
+    rvbts_generator::num_workers = num_workers;
+    rvbts_generator::chunk_size = chunk_size;
+
+    BOOST_CHECK_EQUAL(results[0].size1(), num_channels);
+    BOOST_CHECK_EQUAL(results[1].size2(), results[0].size2());
+    double total = 0.0;
+    for (size_t c = 0; c < results[0].size1(); ++c) {
+        for (size_t t = 0; t < results[0].size2(); ++t) {
+            BOOST_CHECK_EQUAL(results[1](c, t), results[0](c, t));
+            total += results[0](c, t);
+        }
+    }
+    BOOST_CHECK(total > 0.0);
+
+    // a single chunk that covers the whole time series should match the
+    // small chunks, which only visit the biverbs in their time window
+
+    rvbts_generator::chunk_size = results[0].size2();
+    auto single = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), 0.001, pair->biverbs());
+    thread_controller::instance()->run(single);
+    thread_task::wait();
+    rvbts_generator::chunk_size = chunk_size;
+    const matrix<double>& whole = pair->rvbts()->time_series();
+    for (size_t c = 0; c < results[0].size1(); ++c) {
+        for (size_t t = 0; t < results[0].size2(); ++t) {
+            BOOST_CHECK_EQUAL(whole(c, t), results[0](c, t));
+        }
+    }
+
+    // omni-directional beam tables should reproduce the same result
+
+    rvbts_generator::beam_table_error = 1e-6;
+    auto task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), 0.001, pair->biverbs());
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    rvbts_generator::beam_table_error = 0.0;
+    const matrix<double>& tables = pair->rvbts()->time_series();
+    for (size_t c = 0; c < results[0].size1(); ++c) {
+        for (size_t t = 0; t < results[0].size2(); ++t) {
+            BOOST_CHECK_CLOSE(tables(c, t) + 1.0, results[0](c, t) + 1.0,
+                              1e-10);
+        }
+    }
+    sensor_manager::reset();
+}
+
+/**
+ * Changes one transmission in the schedule, and checks that the
+ * reverberation is updated incrementally. The first calculation from
+ * scratch should not keep the contribution of each transmission. A second
+ * calculation that re-uses its terms should keep them. The next calculation
+ * should re-use the transmit independent terms and the contribution of the
+ * unchanged transmission from the previous calculation, and it should
+ * produce the same result as a calculation from scratch.
+ */
+BOOST_AUTO_TEST_CASE(incremental_rvbts) {
+    cout << "=== rvbts_test: incremental_rvbts ===" << endl;
+    sensor_pair::sptr pair = create_multichannel_pair(4);
+    BOOST_REQUIRE(pair->rvbts() != nullptr);
+    BOOST_REQUIRE_EQUAL(pair->rvbts()->transmits().size(), 2);
+    BOOST_CHECK(pair->rvbts()->transmits()[0].series == nullptr);
+    const double treverb = pair->rvbts()->travel_times()->increment(0);
+
+    // re-use terms without changing the schedule, which keeps the
+    // contribution of each transmission
+
+    auto task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), treverb, pair->biverbs(),
+        pair->rvbts());
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    rvbts_collection::csptr original = pair->rvbts();
+    BOOST_REQUIRE(original->transmits()[0].series != nullptr);
+
+    // delay the second transmission
+
+    transmit_list transmits;
+    transmits.push_back(pair->source()->transmit_schedule().front());
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 2.0, 200.0)));
+    pair->source()->transmit_schedule(transmits);
+
+    task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), treverb, pair->biverbs(),
+        original);
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    rvbts_collection::csptr update = pair->rvbts();
+    BOOST_CHECK_EQUAL(update->terms()->frequencies.at(1005.0),
+                      original->terms()->frequencies.at(1005.0));
+    BOOST_CHECK_EQUAL(update->transmits()[0].series,
+                      original->transmits()[0].series);
+    BOOST_CHECK(update->transmits()[1].series !=
+                original->transmits()[1].series);
+
+    // compare to calculation from scratch
+
+    task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), treverb, pair->biverbs());
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    rvbts_collection::csptr scratch = pair->rvbts();
+    const matrix<double>& expected = scratch->time_series();
+    const matrix<double>& actual = update->time_series();
+    BOOST_CHECK(scratch->terms() != update->terms());
+    for (size_t c = 0; c < expected.size1(); ++c) {
+        for (size_t t = 0; t < expected.size2(); ++t) {
+            BOOST_CHECK_EQUAL(actual(c, t), expected(c, t));
+        }
+    }
+    sensor_manager::reset();
+}
+
+/**
+ * Streams the reverberation time series to disk in small windows, and
+ * checks that the file matches the time series computed in memory. Uses
+ * a window that is not a multiple of the chunk size, and does not divide
+ * evenly into the number of travel times, to exercise partial chunks
+ * and windows.
+ */
+BOOST_AUTO_TEST_CASE(streaming_rvbts) {
+    cout << "=== rvbts_test: streaming_rvbts ===" << endl;
+    sensor_pair::sptr pair = create_multichannel_pair(4);
+    BOOST_REQUIRE(pair->rvbts() != nullptr);
+    const matrix<double> expected = pair->rvbts()->time_series();
+    const double treverb = pair->rvbts()->travel_times()->increment(0);
+
+    const size_t chunk_size = rvbts_generator::chunk_size;
+    const std::string stream_directory = rvbts_generator::stream_directory;
+    rvbts_generator::chunk_size = 8;
+    rvbts_generator::stream_window = 20;
+    rvbts_generator::stream_directory = USML_TEST_DIR "/rvbts/test";
+    auto task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), treverb, pair->biverbs());
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    rvbts_collection::csptr streamed = pair->rvbts();
+
+    // a second run must not overwrite the file of the first
+    task = std::make_shared<rvbts_generator>(
+        pair, pair->source(), pair->receiver(), treverb, pair->biverbs());
+    thread_controller::instance()->run(task);
+    thread_task::wait();
+    BOOST_CHECK_NE(streamed->stream_file(), pair->rvbts()->stream_file());
+    rvbts_generator::chunk_size = chunk_size;
+    rvbts_generator::stream_window = 0;
+    rvbts_generator::stream_directory = stream_directory;
+
+    BOOST_REQUIRE(streamed->streaming());
+    BOOST_CHECK_EQUAL(streamed->time_series().size2(), 20);
+    BOOST_CHECK_THROW(streamed->write_netcdf("unused.nc"), std::logic_error);
+
+    {
+        netCDF::NcFile file(streamed->stream_file(), netCDF::NcFile::read);
+        matrix<double> actual(expected.size1(), expected.size2());
+        file.getVar("time_series").getVar(actual.data().begin());
+        for (size_t c = 0; c < expected.size1(); ++c) {
+            for (size_t t = 0; t < expected.size2(); ++t) {
+                BOOST_CHECK_EQUAL(actual(c, t), expected(c, t));
+            }
+        }
+    }
+
+    // files are removed when their collections are no longer referenced
+    const std::string first_file = streamed->stream_file();
+    const std::string second_file = pair->rvbts()->stream_file();
+    streamed.reset();
+    BOOST_CHECK(!std::ifstream(first_file).good());
+    task.reset();
+    pair.reset();
+    sensor_manager::reset();
+    BOOST_CHECK(!std::ifstream(second_file).good());
+}
+
 /// @}
 BOOST_AUTO_TEST_SUITE_END()
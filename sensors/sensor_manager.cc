@@ -144,35 +144,69 @@ typename sensor_model::sptr sensor_manager::find_sensor(
 }
 
 /**
- * Search all pairs for ones that have this sensor as a source.
+ * Find all pairs that have this sensor as a source.
  */
 pair_list sensor_manager::find_source(sensor_model::key_type keyID) {
     read_lock_guard guard(_mutex);
-    pair_list pair_list;
-    for (auto receiverID : _rcv_list) {
-        auto hash_key = sensor_pair::generate_hash_key(keyID, receiverID);
-        auto pair = find(hash_key);
-        if (pair != nullptr) {
-            pair_list.push_back(pair);
-        }
+    auto iter = _src_pairs.find(keyID);
+    if (iter == _src_pairs.end()) {
+        return pair_list();
     }
-    return pair_list;
+    return iter->second;
 }
 
 /**
- * Search all pairs for ones that have this sensor as a receiver.
+ * Find all pairs that have this sensor as a receiver.
  */
 pair_list sensor_manager::find_receiver(sensor_model::key_type keyID) {
     read_lock_guard guard(_mutex);
-    pair_list pair_list;
-    for (auto sourceID : _src_list) {
-        auto hash_key = sensor_pair::generate_hash_key(sourceID, keyID);
-        auto pair = find(hash_key);
-        if (pair != nullptr) {
-            pair_list.push_back(pair);
+    auto iter = _rcv_pairs.find(keyID);
+    if (iter == _rcv_pairs.end()) {
+        return pair_list();
+    }
+    return iter->second;
+}
+
+/**
+ * Adds a new pair to the manager and to the lists of pairs for its
+ * source and receiver.
+ */
+void sensor_manager::add_pair(const sensor_pair::sptr& pair,
+                              update_listener<sensor_pair>* listener) {
+    if (listener != nullptr) {
+        pair->add_listener(listener);
+    }
+    add(pair);
+    _src_pairs[pair->keyID().first].push_back(pair);
+    _rcv_pairs[pair->keyID().second].push_back(pair);
+}
+
+/**
+ * Removes a pair from the manager and from the lists of pairs for its
+ * source and receiver.
+ */
+void sensor_manager::remove_pair(const sensor_pair::sptr& pair,
+                                 update_listener<sensor_pair>* listener) {
+    const auto sourceID = pair->keyID().first;
+    const auto receiverID = pair->keyID().second;
+    remove(pair->keyID());
+    if (listener != nullptr) {
+        pair->remove_listener(listener);
+    }
+    auto src_iter = _src_pairs.find(sourceID);
+    if (src_iter != _src_pairs.end()) {
+        src_iter->second.remove(pair);
+        if (src_iter->second.empty()) {
+            _src_pairs.erase(src_iter);
+        }
+    }
+    auto rcv_iter = _rcv_pairs.find(receiverID);
+    if (rcv_iter != _rcv_pairs.end()) {
+        rcv_iter->second.remove(pair);
+        if (rcv_iter->second.empty()) {
+            _rcv_pairs.erase(rcv_iter);
         }
     }
-    return pair_list;
 }
 
 /**
@@ -183,10 +217,7 @@ void sensor_manager::add_monostatic_pair(
     const sensor_model::sptr& sensor, update_listener<sensor_pair>* listener) {
     if (sensor->min_range() < 1e-6) {
         sensor_pair::sptr pair(new sensor_pair(sensor, sensor));
-        if (listener != nullptr) {
-            pair->add_listener(listener);
-        }
-        add(pair);
+        add_pair(pair, listener);
     }
 }
 
@@ -203,10 +234,7 @@ void sensor_manager::add_multistatic_source(
             auto receiver = find_sensor(receiverID);
             if (receiver->multistatic() == multistatic) {
                 sensor_pair::sptr pair(new sensor_pair(source, receiver));
-                if (listener != nullptr) {
-                    pair->add_listener(listener);
-                }
-                add(pair);
+                add_pair(pair, listener);
             }
         }
     }
@@ -225,10 +253,7 @@ void sensor_manager::add_multistatic_receiver(
             auto source = find_sensor(sourceID);
             if (source->multistatic() == multistatic) {
                 sensor_pair::sptr pair(new sensor_pair(source, receiver));
-                if (listener != nullptr) {
-                    pair->add_listener(listener);
-                }
-                add(pair);
+                add_pair(pair, listener);
             }
         }
     }
@@ -241,13 +266,9 @@ void sensor_manager::add_multistatic_receiver(
 void sensor_manager::remove_monostatic_pair(
     const sensor_model::sptr& sensor, update_listener<sensor_pair>* listener) {
     auto sensorID = sensor->keyID();
-    auto hash_key = sensor_pair::generate_hash_key(sensorID, sensorID);
-    auto pair = find(hash_key);
+    auto pair = find(sensor_pair::generate_key(sensorID, sensorID));
     if (pair != nullptr) {
-        remove(hash_key);
-        if (listener != nullptr) {
-            pair->remove_listener(listener);
-        }
+        remove_pair(pair, listener);
     }
 }
 
@@ -257,18 +278,12 @@ void sensor_manager::remove_monostatic_pair(
  */
 void sensor_manager::remove_multistatic_source(
     const sensor_model::sptr& source, update_listener<sensor_pair>* listener) {
-    auto sourceID = source->keyID();
-    for (auto receiverID : _rcv_list) {
-        if (sourceID != receiverID) {
-            auto receiver = platform_manager::instance()->find(receiverID);
-            auto hash_key =
-                sensor_pair::generate_hash_key(sourceID, receiverID);
-            auto pair = find(hash_key);
-            if (pair != nullptr) {
-                remove(hash_key);
-                if (listener != nullptr) {
-                    pair->remove_listener(listener);
-                }
+    auto iter = _src_pairs.find(source->keyID());
+    if (iter != _src_pairs.end()) {
+        const pair_list list = iter->second;  // copy, remove_pair() changes it
+        for (const auto& pair : list) {
+            if (pair->source() != pair->receiver()) {
+                remove_pair(pair, listener);
             }
         }
     }
@@ -281,18 +296,12 @@ void sensor_manager::remove_multistatic_source(
 void sensor_manager::remove_multistatic_receiver(
     const sensor_model::sptr& receiver,
     update_listener<sensor_pair>* listener) {
-    auto receiverID = receiver->keyID();
-    for (auto sourceID : _rcv_list) {
-        if (sourceID != receiverID) {
-            auto source = platform_manager::instance()->find(sourceID);
-            auto hash_key =
-                sensor_pair::generate_hash_key(sourceID, receiverID);
-            auto pair = find(hash_key);
-            if (pair != nullptr) {
-                remove(hash_key);
-                if (listener != nullptr) {
-                    pair->remove_listener(listener);
-                }
+    auto iter = _rcv_pairs.find(receiver->keyID());
+    if (iter != _rcv_pairs.end()) {
+        const pair_list list = iter->second;  // copy, remove_pair() changes it
+        for (const auto& pair : list) {
+            if (pair->source() != pair->receiver()) {
+                remove_pair(pair, listener);
             }
         }
     }
@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <set>
+#include <unordered_map>
 
 namespace usml {
 namespace sensors {
@@ -31,9 +32,17 @@ using namespace usml::types;
  * Stores and manages the bistatic sensor pairs in use by the simulation. Uses
  * the is_source() and is_receiver() members of the sensor_model class to
  * automatically identify all the cases where added sensors act as the source or
- * receiver in a pair.
+ * receiver in a pair. Pairs are stored using a sensor_pair_key that packs the
+ * source and receiver keyIDs into a pair of integers, in a hash map that
+ * uses sensor_pair_key_hash. Hash maps from each sensor to the pairs that
+ * use it as a source or receiver allow find_source() and find_receiver()
+ * to run in a time proportional to the number of pairs that include that
+ * sensor.
  */
-class USML_DECLSPEC sensor_manager : public manager_template<sensor_pair> {
+class USML_DECLSPEC sensor_manager
+    : public manager_template<
+          sensor_pair, std::unordered_map<sensor_pair_key, sensor_pair::sptr,
+                                          sensor_pair_key_hash>> {
    public:
     /// Exception thrown if frequencies member not set
     struct freq_missing : public std::exception {
@@ -111,7 +120,7 @@ class USML_DECLSPEC sensor_manager : public manager_template<sensor_pair> {
         typename sensor_model::key_type keyID);
 
     /**
-     * Search all pairs for ones that have this sensor as a source.
+     * Find all pairs that have this sensor as a source.
      *
      * @param keyID		ID used to lookup sensor in platform_manager.
      * @return 			List of pairs that include this sensor.
@@ -119,7 +128,7 @@ class USML_DECLSPEC sensor_manager : public manager_template<sensor_pair> {
     pair_list find_source(sensor_model::key_type keyID);
 
     /**
-     * Search all pairs for ones that have this sensor as a receiver.
+     * Find all pairs that have this sensor as a receiver.
      *
      * @param keyID		ID used to lookup sensor in platform_manager.
      * @return 			List of pairs that include this sensor.
@@ -127,6 +136,29 @@ class USML_DECLSPEC sensor_manager : public manager_template<sensor_pair> {
     pair_list find_receiver(sensor_model::key_type keyID);
 
    private:
+    /// Type used to find the pairs associated with each sensor keyID.
+    typedef std::unordered_map<uint64_t, pair_list> adjacency_map;
+
+    /**
+     * Adds a new pair to the manager and to the lists of pairs for its
+     * source and receiver.
+     *
+     * @param pair      Sensor pair to be added.
+     * @param listener  Update listener for sensor_pair objects.
+     */
+    void add_pair(const sensor_pair::sptr& pair,
+                  update_listener<sensor_pair>* listener);
+
+    /**
+     * Removes a pair from the manager and from the lists of pairs for its
+     * source and receiver.
+     *
+     * @param pair      Sensor pair to be removed.
+     * @param listener  Update listener for sensor_pair objects.
+     */
+    void remove_pair(const sensor_pair::sptr& pair,
+                     update_listener<sensor_pair>* listener);
+
     /**
      * Adds a monostatic sensor pair if new sensor being added is both a source
      * and receiver. Called from sensor_manager::add_sensor().
@@ -217,6 +249,12 @@ class USML_DECLSPEC sensor_manager : public manager_template<sensor_pair> {
      * receiver.
      */
     std::set<uint64_t> _rcv_list;
+
+    /// Pairs that use each sensor keyID as a source.
+    adjacency_map _src_pairs;
+
+    /// Pairs that use each sensor keyID as a receiver.
+    adjacency_map _rcv_pairs;
 };
 
 /// @}
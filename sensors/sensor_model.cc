@@ -10,18 +10,24 @@
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/sensors/sensor_pair.h>
+#include <usml/sensors/update_timer.h>
 #include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_pool.h>
-#include <usml/threads/thread_task.h>
 #include <usml/types/wposition.h>
 #include <usml/wavegen/wavefront_generator.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
-#include <cfloat>
+#include <chrono>
 #include <cmath>
 
 using namespace usml::sensors;
 
+/**
+ * Clock used to measure the update_interval() of all sensors.
+ */
+sensor_model::clock_function sensor_model::update_clock =
+    std::chrono::steady_clock::now;
+
 /**
  * Reset source beams.
  */
@@ -170,44 +176,126 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
 
     platform_model::update_internals(time, pos, orient, speed, update_type);
 
-    // start wavefront_generator background task to update acoustics
+    // record threshold crossing as a pending update,
+    // forced updates launch immediately and are not counted as coalesced
 
     if (update_acoustics) {
+        if (_pending_update && update_type != FORCE_UPDATE) {
+            ++_update_stats.coalesced;
+        }
         _needs_update = false;
-        _update_position = pos;
-        _update_orient = orient;
+        _pending_update = true;
+    }
+    if (!_pending_update || update_type == NO_UPDATE) {
+        return;
+    }
 
-        auto targets = find_targets();
+    // start wavefront_generator background task to update acoustics,
+    // unless the last one was launched less than update_interval ago,
+    // in which case the update_timer launches it when the interval expires
 
-        if (!targets.empty() || _compute_reverb) {
-            // abort previous wavefront generator if it exists
+    std::chrono::duration<double> elapsed = update_clock() - _launch_time;
+    if (update_type == FORCE_UPDATE ||
+        _launch_time == std::chrono::steady_clock::time_point() ||
+        elapsed.count() >= _update_interval) {
+        launch_pending(pos, orient);
+    } else {
+        schedule_trailing();
+    }
+}
 
-            if (_wavefront_task != nullptr) {
-                _wavefront_task->abort();
-            }
+/**
+ * Launches the pending update if the update_interval has expired.
+ */
+void sensor_model::launch_trailing() {
+    write_lock_guard guard(mutex());
+    if (update_clock() >= _trailing_deadline) {
+        _trailing_deadline = std::chrono::steady_clock::time_point();
+    }
+    if (!_pending_update) {
+        return;
+    }
+    std::chrono::duration<double> elapsed = update_clock() - _launch_time;
+    if (elapsed.count() >= _update_interval) {
+        launch_pending(position(), orient());
+    } else {
+        schedule_trailing();
+    }
+}
+
+/**
+ * Schedules a check for the pending update when the update_interval expires.
+ */
+void sensor_model::schedule_trailing() {
+    auto sensor = weak_from_this();
+    if (sensor.expired()) {
+        return;
+    }
+
+    // skip if an earlier check is already scheduled,
+    // later checks are harmless if the update_interval shrinks
+
+    auto deadline = _launch_time +
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::duration<double>(_update_interval));
+    if (_trailing_deadline != std::chrono::steady_clock::time_point() &&
+        _trailing_deadline <= deadline) {
+        return;
+    }
+    _trailing_deadline = deadline;
+    update_timer::instance()->schedule(sensor, deadline);
+}
+
+/**
+ * Launches the pending update and records the launch position.
+ */
+void sensor_model::launch_pending(const wposition1& pos,
+                                  const orientation& orient) {
+    _pending_update = false;
+    _launch_time = update_clock();
+    _update_position = pos;
+    _update_orient = orient;
+    launch_wavefront();
+}
 
-            // launch a new wavefront generator
+/**
+ * Launches a new wavefront_generator for the current motion of this sensor.
+ */
+void sensor_model::launch_wavefront() {
+    auto targets = find_targets();
 
-            wposition tpos(targets.size(), 1);
-            matrix<uint64_t> targetIDs(targets.size(), 1);
+    if (!targets.empty() || _compute_reverb) {
+        // abort previous wavefront generator if it exists
 
-            // count the number of targets
-            size_t count = 0;
-            for (const auto& target : targets) {
-                tpos.latitude(count, 0, target->position().latitude());
-                tpos.longitude(count, 0, target->position().longitude());
-                tpos.altitude(count, 0, target->position().altitude());
-                targetIDs(count, 0) = target->keyID();
-                ++count;
+        if (_wavefront_task != nullptr) {
+            if (!_wavefront_task->done()) {
+                ++_update_stats.aborted;
             }
-            auto frequencies = sensor_manager::instance()->frequencies();
+            _wavefront_task->abort();
+        }
+
+        // launch a new wavefront generator
 
-            _wavefront_task = std::make_shared<wavefront_generator>(
-                this, tpos, targetIDs, frequencies, _de_fan, _az_fan,
-                _time_step, _time_maximum, _intensity_threshold, _max_bottom,
-                _max_surface, _wavefront_file);
-            thread_controller::instance()->run(_wavefront_task);
+        wposition tpos(targets.size(), 1);
+        matrix<uint64_t> targetIDs(targets.size(), 1);
+
+        // count the number of targets
+        size_t count = 0;
+        for (const auto& target : targets) {
+            tpos.latitude(count, 0, target->position().latitude());
+            tpos.longitude(count, 0, target->position().longitude());
+            tpos.altitude(count, 0, target->position().altitude());
+            targetIDs(count, 0) = target->keyID();
+            ++count;
         }
+        auto frequencies = sensor_manager::instance()->frequencies();
+
+        _wavefront_task = std::make_shared<wavefront_generator>(
+            this, tpos, targetIDs, frequencies, _de_fan, _az_fan, _time_step,
+            _time_maximum, _intensity_threshold, _max_bottom, _max_surface,
+            _wavefront_file, _finalize_margin);
+        ++_update_stats.launched;
+        thread_controller::instance()->run(_wavefront_task);
     }
 }
 
@@ -215,24 +303,11 @@ void sensor_model::update_internals(time_t time, const wposition1& pos,
  * Get list of acoustic targets near this sensor.
  */
 std::list<platform_model::sptr> sensor_model::find_targets() {
-    double min_range2 = _min_range * _min_range;
-    double max_range2 = _max_range * _max_range;
-    wposition1 object_pos = position();
-
     std::list<platform_model::sptr> targets;
-    for (const auto& platform : platform_manager::instance()->list()) {
+    for (const auto& platform : platform_manager::instance()->find_range(
+             position(), _min_range, _max_range)) {
         if (platform->is_acoustic_target()) {
-            if (min_range2 < DBL_EPSILON && max_range2 < DBL_EPSILON) {
-                targets.push_back(platform);
-            } else {
-                wposition1 platform_pos = platform->position();
-                double distance2 = platform_pos.distance2(object_pos);
-                if (distance2 >= min_range2) {
-                    if (max_range2 < DBL_EPSILON || distance2 <= max_range2) {
-                        targets.push_back(platform);
-                    }
-                }
-            }
+            targets.push_back(platform);
         }
     }
     return targets;
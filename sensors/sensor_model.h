@@ -20,6 +20,7 @@
 #include <usml/usml_config.h>
 #include <usml/wavegen/wavefront_notifier.h>
 
+#include <chrono>
 #include <cstddef>
 #include <list>
 #include <map>
@@ -75,9 +76,24 @@ using namespace usml::wavegen;
  * before the new background task is created. Uses update_notifier to notify
  * listeners when eigenray and eigenverb data has changed. Does not notify
  * listeners when other fields like position and orientation change.
+ *
+ * High rate navigation feeds can cross the motion thresholds faster than the
+ * wavefront_generator can finish. The update_interval() limits the rate at
+ * which new wavefront generators are launched. Threshold crossings that occur
+ * within this interval of the last launch are coalesced into a single pending
+ * update. The update_timer launches the pending update when the interval
+ * expires, and it uses the sensor's motion at the time of that launch, so the
+ * latest state wins. Pending updates are only launched by the update_timer
+ * for sensors that are owned by a shared pointer. Motion thresholds are
+ * measured from the position at the last launch. The update_stats() method
+ * counts the generators launched, the updates coalesced, and the generators
+ * aborted. Forced updates launch immediately and are not counted as
+ * coalesced.
  */
-class USML_DECLSPEC sensor_model : public platform_model,
-                                   public wavefront_notifier {
+class USML_DECLSPEC sensor_model
+    : public platform_model,
+      public wavefront_notifier,
+      public std::enable_shared_from_this<sensor_model> {
    public:
     /**
      * Form of the shared pointer that supports access to sensor_model
@@ -85,6 +101,18 @@ class USML_DECLSPEC sensor_model : public platform_model,
      */
     using sptr = std::shared_ptr<sensor_model>;
 
+    /// Statistics on the wavefront generators launched by this sensor.
+    struct update_statistics {
+        /// Number of wavefront generators launched.
+        size_t launched{0};
+
+        /// Number of updates coalesced into a pending update.
+        size_t coalesced{0};
+
+        /// Number of wavefront generators aborted before completion.
+        size_t aborted{0};
+    };
+
     /**
      * Initialize location and orientation of the sensor in world coordinates.
      *
@@ -175,6 +203,18 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// The maximum number of surface bounces.
     void max_surface(int value) { _max_surface = value; }
 
+    /**
+     * Time after the first arrival at a target before its eigenrays are
+     * finalized (sec). Finalized targets are passed to the wavefront
+     * listeners, like sensor_pair, while the wavefront is still propagating.
+     * Defaults to zero, which only publishes eigenrays when the
+     * wavefront_generator completes.
+     */
+    double finalize_margin() const { return _finalize_margin; }
+
+    /// Time after the first arrival at a target before it is finalized (sec).
+    void finalize_margin(double value) { _finalize_margin = value; }
+
     /// True if eigenverbs computed for this sensor.
     bool compute_reverb() const { return _compute_reverb; }
 
@@ -280,6 +320,58 @@ class USML_DECLSPEC sensor_model : public platform_model,
     /// Force wavefront calculation on next update.
     void set_needs_update() { _needs_update = true; }
 
+    /**
+     * Minimum wall clock interval between wavefront generator launches (sec).
+     * Threshold crossings within this interval are coalesced into a single
+     * pending update. Set to zero to launch on every threshold crossing.
+     */
+    double update_interval() const {
+        read_lock_guard guard(mutex());
+        return _update_interval;
+    }
+
+    /// Minimum wall clock interval between wavefront generator launches (sec).
+    void update_interval(double value) {
+        write_lock_guard guard(mutex());
+        _update_interval = value;
+    }
+
+    /// True if a coalesced update is waiting for the update_interval.
+    bool pending_update() const {
+        read_lock_guard guard(mutex());
+        return _pending_update;
+    }
+
+    /// Statistics on the wavefront generators launched by this sensor.
+    update_statistics update_stats() const {
+        read_lock_guard guard(mutex());
+        return _update_stats;
+    }
+
+    /// Reset the statistics on wavefront generators to zero.
+    void reset_update_stats() {
+        write_lock_guard guard(mutex());
+        _update_stats = update_statistics();
+    }
+
+    /// Function that returns the current time for update_interval().
+    using clock_function = std::chrono::steady_clock::time_point (*)();
+
+    /**
+     * Clock used to measure the update_interval() of all sensors.
+     * Defaults to std::chrono::steady_clock::now(). Tests can replace it
+     * to control the passage of time.
+     */
+    static clock_function update_clock;
+
+    /**
+     * Launches the pending update if the update_interval() has expired
+     * since the last launch. Otherwise, schedules another check with the
+     * update_timer for the time that the interval expires. Invoked by the
+     * update_timer.
+     */
+    void launch_trailing();
+
    protected:
     /**
      * Updates the internal state of this platform and its children. Starts
@@ -287,7 +379,10 @@ class USML_DECLSPEC sensor_model : public platform_model,
      * moved by moved by more than the thresholds defined in motion_thresholds
      * class. Acoustics not computed if sensor has time_maximum set to zero.
      * Acoustics not computed if there are no eigenrays or eigenverbs to be
-     * computed.
+     * computed. Threshold crossings within the update_interval() of the
+     * last launch are coalesced into a pending update, unless update_type is
+     * FORCE_UPDATE. The update_timer launches the pending update when
+     * the interval expires.
      *
      * @param time          Time at which platform was updated.
      * @param pos           New location for this platform.
@@ -301,11 +396,34 @@ class USML_DECLSPEC sensor_model : public platform_model,
         update_type_enum update_type = TEST_THRESHOLD) override;
 
     /**
-     * Get list of acoustic targets near this sensor.
+     * Launches a new wavefront_generator for the current motion of this
+     * sensor. Aborts the previous wavefront generator if it exists.
+     */
+    void launch_wavefront();
+
+    /**
+     * Launches the pending update and records the position and orientation
+     * at which it was launched.
+     *
+     * @param pos           Location of the platform at launch.
+     * @param orient        Orientation of the platform at launch.
+     */
+    void launch_pending(const wposition1& pos, const orientation& orient);
+
+    /**
+     * Get list of acoustic targets near this sensor. Uses the spatial index
+     * in platform_manager::find_range() to search for platforms between the
+     * minimum and maximum range.
      */
     std::list<platform_model::sptr> find_targets();
 
    private:
+    /**
+     * Schedules a check for the pending update when the update_interval()
+     * expires, unless a check has already been scheduled.
+     */
+    void schedule_trailing();
+
     /// Type used to store list of objects.
     typedef std::map<int, bp_model::csptr> beam_map_type;
 
@@ -355,6 +473,9 @@ class USML_DECLSPEC sensor_model : public platform_model,
      */
     int _max_surface{999};
 
+    /// Time after the first arrival at a target before it is finalized (sec).
+    double _finalize_margin{0.0};
+
     /// True if computing reverberation from this sensor.
     bool _compute_reverb{false};
 
@@ -387,6 +508,24 @@ class USML_DECLSPEC sensor_model : public platform_model,
 
     /// Orientation of the platform at last acoustic update.
     orientation _update_orient;
+
+    /// Minimum wall clock interval between wavefront generator launches (sec).
+    double _update_interval{0.0};
+
+    /// True if a coalesced update is waiting for the update_interval.
+    bool _pending_update{false};
+
+    /// Wall clock time of the last wavefront generator launch.
+    std::chrono::steady_clock::time_point _launch_time;
+
+    /**
+     * Earliest time at which the update_timer will check for a pending
+     * update. Zero if no check is scheduled.
+     */
+    std::chrono::steady_clock::time_point _trailing_deadline;
+
+    /// Statistics on the wavefront generators launched by this sensor.
+    update_statistics _update_stats;
 };
 
 /// @}
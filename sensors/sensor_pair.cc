@@ -28,8 +28,8 @@ using namespace usml::sensors;
  */
 sensor_pair::sensor_pair(const sensor_model::sptr& source,
                          const sensor_model::sptr& receiver)
-    : managed_obj<std::string, sensor_pair>(
-          generate_hash_key(source->keyID(), receiver->keyID()),
+    : managed_obj<sensor_pair_key, sensor_pair>(
+          generate_key(source->keyID(), receiver->keyID()),
           source->description() + " -> " + receiver->description()),
       _source(source),
       _receiver(receiver),
@@ -49,7 +49,7 @@ sensor_pair::~sensor_pair() {
 }
 
 /**
- * Utility to generate a hash key for the bistatic_template
+ * Utility to generate a human readable hash key.
  */
 std::string sensor_pair::generate_hash_key(uint64_t src_id, uint64_t rcv_id) {
     std::stringstream key;
@@ -81,45 +81,16 @@ void sensor_pair::update_wavefront_data(
         write_lock_guard guard(_mutex);
 
         // eigenray collection has eigenray list for all targets near this
-        // sensor find the eigenray list specific to this pair
-
-        auto sourceID = _source->keyID();
-        auto targetID = _receiver->keyID();
-        wposition1 source_pos(_source->position());
-        wposition1 receiver_pos(_receiver->position());
-        eigenray_list raylist = eigenrays->find_eigenrays(targetID);
-
+        // sensor, create a view of the eigenray list specific to this pair,
         // swap source/receiver sense of direct path eigenrays, if needed
 
-        if (_source != _receiver && sensor->keyID() == _receiver->keyID()) {
-            sourceID = _receiver->keyID();
-            targetID = _source->keyID();
-            source_pos = _receiver->position();
-            receiver_pos = _source->position();
-            eigenray_list new_list;
-            for (const auto& ray : eigenrays->find_eigenrays(targetID)) {
-                auto* copy = new eigenray_model(*ray);
-                std::swap(copy->source_de, copy->target_de);
-                std::swap(copy->source_az, copy->target_az);
-                new_list.push_back(eigenray_model::csptr(copy));
-            }
-            raylist = new_list;  // replace original list
-        }
-
-        // create new direct path collection with just rays for a single target
-
-        matrix<uint64_t> receiverID(1, 1);
-        receiverID(0, 0) = targetID;
-
-        auto* collection = new eigenray_collection(
-            eigenrays->frequencies(), _source->position(),
-            wposition(receiver_pos), sourceID, receiverID,
-            eigenrays->coherent());
-        for (const auto& ray : raylist) {
-            collection->add_eigenray(0, 0, ray);
-        }
-        collection->sum_eigenrays();
-        _dirpaths = eigenray_collection::csptr(collection);
+        const bool reciprocal =
+            _source != _receiver && sensor->keyID() == _receiver->keyID();
+        const auto targetID =
+            reciprocal ? _source->keyID() : _receiver->keyID();
+        _dirpaths = std::make_shared<eigenray_collection>(
+            eigenrays, targetID, _source->position(), _receiver->position(),
+            _source->keyID(), _receiver->keyID(), reciprocal);
 
         // update eigenverb contributions
 
@@ -156,6 +127,27 @@ void sensor_pair::update_wavefront_data(
     }
 }
 
+/**
+ * Update direct path eigenrays as soon as the target for this pair has
+ * been finalized.
+ */
+void sensor_pair::update_wavefront_target(const sensor_model* sensor,
+                                          eigenray_collection::csptr eigenrays,
+                                          uint64_t targetID) {
+    {
+        write_lock_guard guard(_mutex);
+        const bool reciprocal =
+            _source != _receiver && sensor->keyID() == _receiver->keyID();
+        if (targetID != (reciprocal ? _source->keyID() : _receiver->keyID())) {
+            return;
+        }
+        _dirpaths = std::make_shared<eigenray_collection>(
+            eigenrays, targetID, _source->position(), _receiver->position(),
+            _source->keyID(), _receiver->keyID(), reciprocal);
+    }
+    notify_update(this);
+}
+
 /**
  * Update bistatic eigenverbs using results of the biverb_generator
  * background task.
@@ -190,7 +182,7 @@ void sensor_pair::notify_update(const biverb_collection::csptr* object) {
         }
         sensor_pair::sptr reference = sensor_manager::instance()->find(keyID());
         _rvbts_task = std::make_shared<rvbts_generator>(
-            reference, _source, _receiver, treverb, _biverbs);
+            reference, _source, _receiver, treverb, _biverbs, _rvbts);
         thread_controller::instance()->run(_rvbts_task);
         _rvbts_task.reset();  // destroy background task shared pointer
     }
@@ -16,9 +16,13 @@
 #include <usml/usml_config.h>
 #include <usml/wavegen/wavefront_listener.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace usml {
 namespace biverbs {
@@ -46,6 +50,27 @@ using namespace usml::wavegen;
 /// @ingroup sensors
 /// @{
 
+/**
+ * Lookup key for a sensor_pair in the sensor_manager. Packs the keyIDs of the
+ * source and receiver into a pair of integers, so that lookups don't need to
+ * build and compare strings.
+ */
+typedef std::pair<uint64_t, uint64_t> sensor_pair_key;
+
+/**
+ * Hash function for a sensor_pair_key, so that the sensor_manager can store
+ * pairs in an unordered map. Mixes the receiver keyID into the source keyID
+ * using the 64-bit golden ratio constant from boost::hash_combine.
+ */
+struct sensor_pair_key_hash {
+    size_t operator()(const sensor_pair_key& key) const {
+        uint64_t hash = std::hash<uint64_t>()(key.first);
+        hash ^= std::hash<uint64_t>()(key.second) + 0x9e3779b97f4a7c15ULL +
+                (hash << 6) + (hash >> 2);
+        return (size_t)hash;
+    }
+};
+
 /**
  * Cache of modeling products for link between source and receiver. Listens for
  * acoustic changes in its component sensor_models. Each eigenray represents a
@@ -58,7 +83,7 @@ using namespace usml::wavegen;
  * when all of the calculations are complete.
  */
 class USML_DECLSPEC sensor_pair
-    : public managed_obj<std::string, sensor_pair>,
+    : public managed_obj<sensor_pair_key, sensor_pair>,
       public wavefront_listener,
       public update_listener<biverb_collection::csptr>,
       public update_listener<rvbts_collection::csptr>,
@@ -80,10 +105,9 @@ class USML_DECLSPEC sensor_pair
      */
     virtual ~sensor_pair();
 
-    /// Lookup key for this combination of source and receiver
+    /// Human readable key for this combination of source and receiver.
     std::string hash_key() const {
-        read_lock_guard guard(_mutex);
-        return generate_hash_key(_source->keyID(), _receiver->keyID());
+        return generate_hash_key(keyID().first, keyID().second);
     }
 
     /// Reference to the source sensor.
@@ -126,7 +150,19 @@ class USML_DECLSPEC sensor_pair
     }
 
     /**
-     * Utility to generate a hash key for the bistatic_template
+     * Utility to generate the key used to find pairs in the sensor_manager.
+     *
+     * @param    src_id   The source id used to generate the key
+     * @param    rcv_id   The receiver id used to generate the key
+     * @return   Packed combination of source and receiver ids.
+     */
+    static key_type generate_key(uint64_t src_id, uint64_t rcv_id) {
+        return key_type(src_id, rcv_id);
+    }
+
+    /**
+     * Utility to generate a human readable hash key, in the form "src_rcv".
+     * Used to create unique names for files and log messages.
      *
      * @param    src_id   The source id used to generate the hash_key
      * @param    rcv_id   The receiver id used to generate the hash_key
@@ -145,10 +181,12 @@ class USML_DECLSPEC sensor_pair
     /**
      * Update eigenrays and eigenverbs using results of the wavefront_generator
      * background task. Stores a reference to the eigenrays and eigenverbs
-     * and computes direct path eigenrays. Launches a new biverb_generator to
-     * compute bistatic eigenverb contributions if both source and receiver
-     * eigenverbs are ready. Notifies sensor_pair listeners early if acoustic
-     * calculations are complete with any additional background tasks.
+     * and creates a view of the direct path eigenrays for this pair, which
+     * shares the eigenrays and totals computed for the updated sensor.
+     * Launches a new biverb_generator to compute bistatic eigenverb
+     * contributions if both source and receiver eigenverbs are ready.
+     * Notifies sensor_pair listeners early if acoustic calculations are
+     * complete with any additional background tasks.
      *
      * This computation can be triggered by updates from either the source or
      * receiver object in this sensor_pair. If this is an update from a
@@ -172,6 +210,22 @@ class USML_DECLSPEC sensor_pair
         const sensor_model* sensor, eigenray_collection::csptr eigenrays,
         eigenverb_collection::csptr eigenverbs) override;
 
+    /**
+     * Update direct path eigenrays as soon as the target for this pair has
+     * been finalized, while the wavefront_generator is still propagating.
+     * Creates a view of the finalized eigenrays, in the same way as
+     * update_wavefront_data(), and notifies sensor_pair listeners. Ignores
+     * targets that are not the complement of the updated sensor. The direct
+     * paths are replaced again when the wavefront_generator completes.
+     *
+     * @param sensor		Pointer to updated sensor.
+     * @param eigenrays		Transmission loss results being computed.
+     * @param targetID 	    Platform ID number of the finalized target.
+     */
+    virtual void update_wavefront_target(const sensor_model* sensor,
+                                         eigenray_collection::csptr eigenrays,
+                                         uint64_t targetID) override;
+
     /**
      * Update bistatic eigenverbs using results of the biverb_generator
      * background task. Stores a reference to the bistatic eigenverbs then
@@ -27,3 +27,4 @@
 #include <usml/sensors/sensor_manager.h>
 #include <usml/sensors/sensor_model.h>
 #include <usml/sensors/sensor_pair.h>
+#include <usml/sensors/update_timer.h>
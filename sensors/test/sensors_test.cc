@@ -18,17 +18,23 @@
 #include <usml/sensors/sensor_pair.h>
 #include <usml/sensors/sensors.h>
 #include <usml/sensors/test/simple_sonobuoy.h>
+#include <usml/sensors/update_timer.h>
 #include <usml/threads/thread_task.h>
 #include <usml/types/seq_linear.h>
 #include <usml/types/seq_vector.h>
 #include <usml/types/wposition1.h>
+#include <usml/wavegen/wavefront_listener.h>
 
+#include <algorithm>
+#include <chrono>
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace boost::unit_test;
 using namespace usml::sensors;
@@ -53,6 +59,50 @@ class pair_listener : public update_listener<sensor_pair> {
 };
 pair_listener test_listener;
 
+/// Time reported by test_clock().
+std::chrono::steady_clock::time_point test_time;
+
+/// Clock controlled by the test, used for sensor_model::update_clock.
+std::chrono::steady_clock::time_point test_clock() { return test_time; }
+
+/**
+ * Records the targets finalized before the wavefront generator completes,
+ * and counts the sensor_pair updates.
+ */
+class finalize_listener : public wavefront_listener,
+                          public update_listener<sensor_pair> {
+   public:
+    /// Targets finalized before the wavefront generator completed.
+    std::vector<uint64_t> targets;
+
+    /// True once the wavefront generator has completed.
+    bool complete{false};
+
+    /// Number of sensor_pair updates.
+    size_t pair_updates{0};
+
+    /// Records that the wavefront generator has completed.
+    void update_wavefront_data(
+        const sensor_model* /*sensor*/, eigenray_collection::csptr /*rays*/,
+        eigenverb_collection::csptr /*verbs*/) override {
+        complete = true;
+    }
+
+    /// Records targets finalized before the generator completed.
+    void update_wavefront_target(const sensor_model* /*sensor*/,
+                                 eigenray_collection::csptr eigenrays,
+                                 uint64_t targetID) override {
+        if (!complete && eigenrays != nullptr) {
+            targets.push_back(targetID);
+        }
+    }
+
+    /// Counts sensor_pair updates.
+    void notify_update(const sensor_pair* /*pair*/) override {
+        ++pair_updates;
+    }
+};
+
 /**
  * @ingroup sensors_test
  * @{
@@ -121,8 +171,8 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     };
     // clang-format on
     auto num_sites = 5;
-    std::string expected_pairs[] = {"1_1", "2_2", "2_4", "2_5", "3_2",
-                                    "3_4", "3_5", "5_2", "5_4"};
+    const std::set<std::string> expected_pairs = {
+        "1_1", "2_2", "2_4", "2_5", "3_2", "3_4", "3_5", "5_2", "5_4"};
 
     // create platform and sensor_pair objects.
 
@@ -197,13 +247,22 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
         }
     }
 
-    // check that the right bistatic pairs created
+    // check that the right bistatic pairs created,
+    // pairs are stored in a hash map, so their order is not defined
 
-    int n = 0;
+    std::set<std::string> actual_pairs;
     for (const auto& pair : sensor_mgr->list()) {
-        BOOST_CHECK_EQUAL(pair->hash_key(), expected_pairs[n++]);
+        actual_pairs.insert(pair->hash_key());
         BOOST_CHECK_GE(pair->dirpaths()->eigenrays().size(), 4);
     }
+    BOOST_CHECK(actual_pairs == expected_pairs);
+
+    // check the pairs found for individual sources and receivers
+
+    BOOST_CHECK_EQUAL(sensor_mgr->find_source(3).size(), 3);
+    BOOST_CHECK_EQUAL(sensor_mgr->find_receiver(4).size(), 3);
+    BOOST_CHECK_EQUAL(sensor_mgr->find_receiver(1).size(), 1);
+    BOOST_CHECK(sensor_mgr->find_source(4).empty());
 
     // clean up and exit
 
@@ -211,6 +270,122 @@ BOOST_AUTO_TEST_CASE(update_wavefront_data) {
     sensor_manager::reset();
 }
 
+/**
+ * Tests the ability to coalesce a rapid series of motion updates into a
+ * single pending wavefront calculation. Sets an update_interval that is much
+ * longer than the test, so that only the first threshold crossing launches a
+ * wavefront_generator. The next two threshold crossings should be combined
+ * into one pending update, and that pending update should be launched by a
+ * FORCE_UPDATE. Then shortens the update_interval and checks that a pending
+ * update is launched when the interval expires, without further updates.
+ * Uses a clock controlled by the test, so that the result does not depend
+ * on how long each step of the test takes.
+ */
+BOOST_AUTO_TEST_CASE(update_coalescing) {
+    cout << "=== sensors_test: update_coalescing ===" << endl;
+
+    ocean_utils::make_iso(2000.0);
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 10.0, 1000.0));
+    sensor_mgr->frequencies(freq);
+    test_time = std::chrono::steady_clock::now();
+    sensor_model::update_clock = test_clock;
+
+    wposition1 position(36.0, 16.0, -100.0);
+    sensor_model::sptr sensor(new sensor_model(1, "sensor", 0.0, position));
+    sensor->time_maximum(1.0);
+    sensor->update_interval(3600.0);
+    platform_manager::instance()->add(sensor);
+
+    // first update launches, next two are coalesced into one pending update
+
+    sensor->update(0.0, position, orientation(), 0.0);
+    for (int n = 1; n <= 2; ++n) {
+        position.latitude(position.latitude() + 0.1);
+        sensor->update(n, position, orientation(), 0.0);
+    }
+    BOOST_CHECK(sensor->pending_update());
+    BOOST_CHECK_EQUAL(sensor->update_stats().launched, 1);
+    BOOST_CHECK_EQUAL(sensor->update_stats().coalesced, 1);
+
+    // forced update launches the pending update
+
+    sensor->update(3.0, platform_model::FORCE_UPDATE);
+    BOOST_CHECK(!sensor->pending_update());
+    BOOST_CHECK_EQUAL(sensor->update_stats().launched, 2);
+    BOOST_CHECK_EQUAL(sensor->update_stats().coalesced, 1);
+    thread_task::wait();
+
+    // trailing update launches when the interval expires
+
+    sensor->update_interval(0.2);
+    sensor->update(4.0, platform_model::FORCE_UPDATE);
+    position.latitude(position.latitude() + 0.1);
+    sensor->update(5.0, position, orientation(), 0.0);
+    update_timer::instance()->check();
+    BOOST_CHECK(sensor->pending_update());
+    BOOST_CHECK_EQUAL(sensor->update_stats().launched, 3);
+
+    test_time += std::chrono::milliseconds(300);
+    update_timer::instance()->check();
+    BOOST_CHECK(!sensor->pending_update());
+    BOOST_CHECK_EQUAL(sensor->update_stats().launched, 4);
+    BOOST_CHECK_EQUAL(sensor->update_stats().coalesced, 1);
+    thread_task::wait();
+
+    sensor_model::update_clock = std::chrono::steady_clock::now;
+    update_timer::reset();
+    sensor_manager::reset();
+}
+
+/**
+ * Tests the ability to publish the eigenrays for a target while the
+ * wavefront is still propagating. The receiver is about 11 km from the
+ * source, so its eigenrays should be finalized about 8 sec into a 10 sec
+ * propagation. The bistatic pair should be updated once when its target
+ * is finalized, and again when the wavefront_generator completes.
+ */
+BOOST_AUTO_TEST_CASE(finalize_targets) {
+    cout << "=== sensors_test: finalize_targets ===" << endl;
+
+    ocean_utils::make_iso(2000.0);
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 10.0, 1000.0));
+    sensor_mgr->frequencies(freq);
+    auto beam = bp_model::csptr(new bp_omni());
+    finalize_listener listener;
+
+    sensor_model::sptr source(
+        new sensor_model(1, "source", 0.0, wposition1(36.0, 16.0, -100.0)));
+    source->time_maximum(10.0);
+    source->finalize_margin(0.5);
+    source->multistatic(1);
+    source->src_beam(0, beam);
+    source->add_wavefront_listener(&listener);
+    sensor_mgr->add_sensor(source, &listener);
+
+    sensor_model::sptr receiver(
+        new sensor_model(2, "receiver", 0.0, wposition1(36.1, 16.0, -100.0)));
+    receiver->time_maximum(10.0);
+    receiver->multistatic(1);
+    receiver->rcv_beam(0, beam);
+    sensor_mgr->add_sensor(receiver, &listener);
+
+    source->update(0.0, platform_model::FORCE_UPDATE);
+    thread_task::wait();
+
+    BOOST_CHECK(listener.complete);
+    BOOST_CHECK_EQUAL(
+        std::count(listener.targets.begin(), listener.targets.end(), 2), 1);
+    BOOST_CHECK_EQUAL(listener.pair_updates, 2);
+    auto pair = sensor_mgr->find(sensor_pair::generate_key(1, 2));
+    BOOST_REQUIRE(pair != nullptr);
+    BOOST_CHECK_GE(pair->dirpaths()->eigenrays().size(), 1);
+
+    source->remove_wavefront_listener(&listener);
+    sensor_manager::reset();
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
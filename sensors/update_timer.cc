@@ -0,0 +1,124 @@
+/**
+ * @file update_timer.cc
+ * Launches coalesced sensor updates when their update interval expires.
+ */
+
+#include <usml/sensors/sensor_model.h>
+#include <usml/sensors/update_timer.h>
+
+#include <vector>
+
+using namespace usml::sensors;
+
+/// Reference to the update_timer owned by this singleton.
+std::unique_ptr<update_timer> update_timer::_instance;
+
+/// Mutex to lock creation of instance.
+read_write_lock update_timer::_instance_mutex;
+
+/**
+ * Provides a reference to the update_timer singleton.
+ */
+update_timer* update_timer::instance() {
+    read_lock_guard guard(_instance_mutex);
+    update_timer* timer = _instance.get();
+    if (timer == nullptr) {
+        guard.unlock();
+        write_lock_guard write_guard(_instance_mutex);
+        timer = _instance.get();
+        if (timer == nullptr) {
+            timer = new update_timer();
+            _instance.reset(timer);
+        }
+    }
+    return timer;
+}
+
+/**
+ * Stops the background thread and discards all scheduled checks.
+ */
+void update_timer::reset() {
+    std::unique_ptr<update_timer> timer;
+    {
+        write_lock_guard guard(_instance_mutex);
+        timer = std::move(_instance);
+    }
+    // destroyed without the lock, because sensors being checked by the
+    // background thread can schedule another check with instance()
+}
+
+/**
+ * Constructs the timer and starts its background thread.
+ */
+update_timer::update_timer() : _thread(&update_timer::run, this) {}
+
+/**
+ * Stops the background thread.
+ */
+update_timer::~update_timer() {
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    _thread.join();
+}
+
+/**
+ * Schedules a check for the pending update of a sensor.
+ */
+void update_timer::schedule(const std::weak_ptr<sensor_model>& sensor,
+                            time_point deadline) {
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _schedule.emplace(deadline, sensor);
+    }
+    _wake.notify_all();
+}
+
+/**
+ * Checks the sensors whose deadline has passed.
+ */
+void update_timer::check() {
+    std::lock_guard<std::mutex> check_guard(_check_mutex);
+    std::vector<std::weak_ptr<sensor_model>> due;
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        const time_point now = sensor_model::update_clock();
+        while (!_schedule.empty() && _schedule.begin()->first <= now) {
+            due.push_back(_schedule.begin()->second);
+            _schedule.erase(_schedule.begin());
+        }
+    }
+
+    // launch without holding the schedule lock, so that sensors can
+    // schedule another check
+
+    for (const auto& weak : due) {
+        if (auto sensor = weak.lock()) {
+            sensor->launch_trailing();
+        }
+    }
+}
+
+/**
+ * Sleeps until the earliest deadline, then checks the due sensors.
+ */
+void update_timer::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop) {
+        if (_schedule.empty()) {
+            _wake.wait(lock);
+            continue;
+        }
+        const auto wait =
+            _schedule.begin()->first - sensor_model::update_clock();
+        if (wait > std::chrono::steady_clock::duration::zero()) {
+            _wake.wait_for(lock, wait);
+            continue;
+        }
+        lock.unlock();
+        check();
+        lock.lock();
+    }
+}
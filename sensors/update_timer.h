@@ -0,0 +1,116 @@
+/**
+ * @file update_timer.h
+ * Launches coalesced sensor updates when their update interval expires.
+ */
+#pragma once
+
+#include <usml/threads/read_write_lock.h>
+#include <usml/usml_config.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace usml {
+namespace sensors {
+
+using namespace usml::threads;
+
+class sensor_model;
+
+/// @ingroup sensors
+/// @{
+
+/**
+ * Singleton that launches coalesced sensor updates when their update
+ * interval expires. A single background thread sleeps until the earliest
+ * deadline, so that waiting sensors do not occupy the workers of the
+ * thread_controller, which are needed by the wavefront generators. Sensors
+ * are held by weak pointers, so a sensor that is destroyed before its
+ * deadline is simply skipped. Deadlines are measured with
+ * sensor_model::update_clock.
+ */
+class USML_DECLSPEC update_timer {
+   public:
+    /// Time at which a sensor should be checked for a pending update.
+    using time_point = std::chrono::steady_clock::time_point;
+
+    /**
+     * Provides a reference to the update_timer singleton. Constructs the
+     * singleton, and starts its background thread, the first time that
+     * this is invoked.
+     *
+     * @return  Reference to the update_timer singleton.
+     */
+    static update_timer* instance();
+
+    /**
+     * Stops the background thread and discards all scheduled checks.
+     * A new singleton is constructed on the next call to instance().
+     */
+    static void reset();
+
+    /**
+     * Stops the background thread.
+     */
+    ~update_timer();
+
+    /**
+     * Schedules a check for the pending update of a sensor. Invokes
+     * sensor_model::launch_trailing() once the deadline has passed.
+     *
+     * @param sensor    Sensor to check for a pending update.
+     * @param deadline  Time at which the sensor should be checked.
+     */
+    void schedule(const std::weak_ptr<sensor_model>& sensor,
+                  time_point deadline);
+
+    /**
+     * Checks the sensors whose deadline has passed on the calling thread.
+     * Invoked by the background thread. Can also be invoked directly, for
+     * example after a test advances sensor_model::update_clock. Returns
+     * after all of the due updates have been launched.
+     */
+    void check();
+
+   private:
+    /// Constructs the timer and starts its background thread.
+    update_timer();
+
+    /// Sleeps until the earliest deadline, then checks the due sensors.
+    void run();
+
+    /// Reference to the update_timer owned by this singleton.
+    static std::unique_ptr<update_timer> _instance;
+
+    /// Mutex to lock creation of instance.
+    static read_write_lock _instance_mutex;
+
+    /// Mutex that locks the schedule.
+    std::mutex _mutex;
+
+    /**
+     * Serializes checks, so that check() does not return while another
+     * thread is still launching the updates that it found to be due.
+     */
+    std::mutex _check_mutex;
+
+    /// Wakes the background thread when the schedule changes.
+    std::condition_variable _wake;
+
+    /// Sensors to check, earliest deadline first.
+    std::multimap<time_point, std::weak_ptr<sensor_model>> _schedule;
+
+    /// True if the background thread should exit.
+    bool _stop{false};
+
+    /// Background thread that waits for deadlines.
+    std::thread _thread;
+};
+
+/// @}
+}  // namespace sensors
+}  // namespace usml
@@ -0,0 +1,162 @@
+/**
+ * @file rvbts_speed.cc
+ *
+ * Measure how the speed of the reverberation time series generator scales
+ * with the number of worker threads. Uses the multi-channel scenario from
+ * rvbts_test, with a finer time increment and more channels, so that each
+ * worker has a meaningful amount of work.
+ *
+ *      - Ocean: 2000 meters deep, isovelocity
+ *      - Source: 36N 16E, 100 meters deep, two CW pulses at 1005 Hz
+ *      - Receiver: 36N 16E, 500 meters deep, omni channels
+ *      - Frequency: 900 to 1100 Hz
+ *      - Travel Time: 8 seconds
+ *      - Time Increment: 1 msec
+ *
+ * The bistatic eigenverbs are computed once, and then the time series is
+ * computed with 1, 2, 4, ... workers, up to the maximum number of workers.
+ * Each run is compared to the single worker result, which it should
+ * match exactly.
+ *
+ *      rvbts_speed [num_channels] [max_workers]
+ */
+
+#include <usml/beampatterns/bp_model.h>
+#include <usml/beampatterns/bp_omni.h>
+#include <usml/ocean/ocean_utils.h>
+#include <usml/platforms/platform_manager.h>
+#include <usml/platforms/platform_model.h>
+#include <usml/rvbts/rvbts_collection.h>
+#include <usml/rvbts/rvbts_generator.h>
+#include <usml/sensors/sensor_manager.h>
+#include <usml/sensors/sensor_model.h>
+#include <usml/sensors/sensor_pair.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
+#include <usml/threads/thread_task.h>
+#include <usml/transmit/transmit_cw.h>
+#include <usml/transmit/transmit_model.h>
+#include <usml/types/bvector.h>
+#include <usml/types/seq_linear.h>
+#include <usml/types/seq_vector.h>
+#include <usml/types/wposition1.h>
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/timer/timer.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace usml::beampatterns;
+using namespace usml::ocean;
+using namespace usml::rvbts;
+using namespace usml::sensors;
+using namespace usml::threads;
+using namespace usml::transmit;
+
+/**
+ * Command line interface.
+ */
+int main(int argc, char* argv[]) {
+    cout << "=== rvbts_speed ===" << endl;
+
+    size_t num_channels = 64;
+    if (argc > 1) {
+        num_channels = atoi(argv[1]);
+    }
+    unsigned max_workers = std::thread::hardware_concurrency();
+    if (argc > 2) {
+        max_workers = atoi(argv[2]);
+    }
+    max_workers = std::max(max_workers, 1U);
+    thread_controller::reset(max_workers);
+
+    // define scenario parameters
+
+    ocean_utils::make_iso(2000.0);
+    auto* sensor_mgr = sensor_manager::instance();
+    seq_vector::csptr freq(new seq_linear(900.0, 100.0, 1100.0));
+    sensor_mgr->frequencies(freq);
+
+    auto beam = bp_model::csptr(new bp_omni());
+    auto* source = new sensor_model(1, "source", 0.0,
+                                    wposition1(36.0, 16.0, -100.0));
+    source->compute_reverb(true);
+    source->multistatic(1);
+    source->time_maximum(8.0);
+    source->src_beam(0, beam);
+    transmit_list transmits;
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 0.0, 200.0)));
+    transmits.push_back(transmit_model::csptr(
+        new transmit_cw("CW", 0.1, 1005.0, 1.0, 200.0)));
+    source->transmit_schedule(transmits);
+    sensor_mgr->add_sensor(sensor_model::sptr(source));
+
+    auto* receiver = new sensor_model(2, "receiver", 0.0,
+                                      wposition1(36.0, 16.0, -500.0));
+    receiver->compute_reverb(true);
+    receiver->multistatic(1);
+    receiver->time_maximum(8.0);
+    for (size_t n = 0; n < num_channels; ++n) {
+        const double az = 360.0 * double(n) / double(num_channels);
+        receiver->rcv_beam((int)n, beam, bvector(0.0, az));
+    }
+    sensor_mgr->add_sensor(sensor_model::sptr(receiver));
+
+    // compute bistatic eigenverbs in the background
+
+    cout << "compute biverbs for " << num_channels << " channels" << endl;
+    for (auto& platform : platform_manager::instance()->list()) {
+        platform->update(0.0, platform_model::FORCE_UPDATE);
+    }
+    thread_task::wait();
+    sensor_pair::sptr pair = *(sensor_mgr->find_source(1).begin());
+    if (pair->biverbs() == nullptr) {
+        cout << "no biverbs computed" << endl;
+        return 1;
+    }
+
+    // compute the time series with an increasing number of workers
+
+    rvbts_generator::chunk_size = 100;
+    matrix<double> serial;
+    double serial_time = 0.0;
+    for (unsigned workers = 1; workers <= max_workers; workers *= 2) {
+        rvbts_generator::num_workers = workers;
+        auto task = std::make_shared<rvbts_generator>(
+            pair, pair->source(), pair->receiver(), 0.001, pair->biverbs());
+        boost::timer::cpu_timer timer;
+        thread_controller::instance()->run(task);
+        thread_task::wait();
+        const double wall = double(timer.elapsed().wall) * 1e-9;
+
+        const matrix<double>& series = pair->rvbts()->time_series();
+        if (workers == 1) {
+            serial = series;
+            serial_time = wall;
+        }
+        size_t num_diff = 0;
+        for (size_t c = 0; c < series.size1(); ++c) {
+            for (size_t t = 0; t < series.size2(); ++t) {
+                if (series(c, t) != serial(c, t)) {
+                    ++num_diff;
+                }
+            }
+        }
+        cout << "workers=" << workers << std::fixed << std::setprecision(3)
+             << " time=" << wall << " secs"
+             << " speedup=" << serial_time / wall
+             << " differences=" << num_diff << endl;
+        cout.unsetf(std::ios::floatfield);
+    }
+
+    sensor_manager::reset();
+    platform_manager::reset();
+    cout << "== test complete ==" << endl;
+    return 0;
+}
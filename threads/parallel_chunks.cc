@@ -0,0 +1,121 @@
+/**
+ * @file parallel_chunks.cc
+ * Splits work into chunks that are processed by several threads.
+ */
+
+#include <usml/threads/parallel_chunks.h>
+#include <usml/threads/thread_controller.h>
+#include <usml/threads/thread_pool.h>
+#include <usml/threads/thread_task.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+using namespace usml::threads;
+
+namespace {
+
+/**
+ * Work shared by parallel_chunks::run() and its helper tasks. Kept in a
+ * shared pointer so that helper tasks which start late, or after an abort,
+ * never reference memory that has already been released.
+ */
+struct chunk_work {
+    parallel_chunks::chunk_function process;
+    size_t num_chunks = 0;
+    std::atomic<size_t> next{0};    ///< index of next chunk to be claimed
+    std::atomic<size_t> active{0};  ///< number of threads inside a chunk
+    std::atomic<bool> abort{false};
+
+    /**
+     * Process chunks until all chunks have been claimed, or the work is
+     * aborted. The active count is raised before each claim, so a thread
+     * that waits for it to reach zero knows that no chunk is in progress.
+     *
+     * @param worker        Worker number of the calling thread.
+     * @param owner_abort   Abort flag of the task that owns this work,
+     *                      checked before each chunk. Null for helper tasks.
+     */
+    void run(size_t worker, const bool* owner_abort = nullptr) {
+        while (!abort) {
+            if (owner_abort != nullptr && *owner_abort) {
+                abort = true;
+                break;
+            }
+            ++active;
+            const size_t index = next++;
+            if (index >= num_chunks || abort) {
+                --active;
+                break;
+            }
+            process(index, worker);
+            --active;
+        }
+    }
+};
+
+/**
+ * Helper task that processes chunks on another thread of the pool.
+ */
+class chunk_helper : public thread_task {
+   public:
+    chunk_helper(std::shared_ptr<chunk_work> work, size_t worker)
+        : _work(std::move(work)), _worker(worker) {}
+    void run() override { _work->run(_worker); }
+
+   private:
+    std::shared_ptr<chunk_work> _work;
+    size_t _worker;
+};
+
+}  // namespace
+
+/**
+ * Number of threads that run() uses for a given amount of work.
+ */
+size_t parallel_chunks::num_threads(size_t num_chunks, unsigned num_workers) {
+    return std::max(std::min(size_t(std::max(num_workers, 1U)), num_chunks),
+                    size_t(1));
+}
+
+/**
+ * Processes all chunks on the calling thread and on helper tasks.
+ */
+bool parallel_chunks::run(size_t num_chunks, unsigned num_workers,
+                          const chunk_function& process, const bool* abort) {
+    const size_t threads = num_threads(num_chunks, num_workers);
+    if (threads <= 1) {
+        for (size_t index = 0; index < num_chunks; ++index) {
+            if (abort != nullptr && *abort) {
+                return false;
+            }
+            process(index, 0);
+        }
+        return abort == nullptr || !*abort;
+    }
+
+    auto work = std::make_shared<chunk_work>();
+    work->process = process;
+    work->num_chunks = num_chunks;
+    for (size_t worker = 1; worker < threads; ++worker) {
+        thread_controller::instance()->run(
+            std::make_shared<chunk_helper>(work, worker));
+    }
+    work->run(0, abort);
+
+    // raise the shared abort flag before the final check of the active
+    // count, so that helpers which start later do not claim a chunk
+
+    while (true) {
+        if (abort != nullptr && *abort) {
+            work->abort = true;
+        }
+        if (work->active == 0) {
+            break;
+        }
+        thread_task::sleep();
+    }
+    return !work->abort;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file parallel_chunks.h
+ * Splits work into chunks that are processed by several threads.
+ */
+#pragma once
+
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <functional>
+
+namespace usml {
+namespace threads {
+
+/// @ingroup threads
+/// @{
+
+/**
+ * Splits work into chunks that are processed by the calling thread and by
+ * helper tasks in the thread_controller pool. Each thread claims the next
+ * unprocessed chunk until none remain. The calling thread also processes
+ * chunks, so that it finishes even if every other thread in the pool is
+ * busy.
+ *
+ * The run() method does not return until no thread is inside a chunk.
+ * Helper tasks that start after that never process a chunk, so the chunk
+ * function can safely reference memory owned by the caller. Each thread
+ * is given a worker number, so that callers can keep scratch memory
+ * for each thread.
+ */
+class USML_DECLSPEC parallel_chunks {
+   public:
+    /// Processes one chunk, given the chunk number and worker number.
+    using chunk_function = std::function<void(size_t, size_t)>;
+
+    /**
+     * Number of threads that run() uses for a given amount of work.
+     *
+     * @param num_chunks    Number of chunks to process.
+     * @param num_workers   Maximum number of threads, including the
+     *                      calling thread.
+     * @return              Number of threads, always at least one.
+     */
+    static size_t num_threads(size_t num_chunks, unsigned num_workers);
+
+    /**
+     * Processes all chunks on the calling thread and on helper tasks.
+     * A single thread processes the chunks in order without using the pool.
+     *
+     * @param num_chunks    Number of chunks to process.
+     * @param num_workers   Maximum number of threads, including the
+     *                      calling thread.
+     * @param process       Processes one chunk. The worker number is less
+     *                      than num_threads(), and it is zero for the
+     *                      calling thread.
+     * @param abort         Abort flag of the calling task, checked by the
+     *                      calling thread between chunks. No new chunks are
+     *                      claimed once it is set. Null if the work can not
+     *                      be aborted.
+     * @return              False if the work was aborted before all chunks
+     *                      were processed.
+     */
+    static bool run(size_t num_chunks, unsigned num_workers,
+                    const chunk_function& process,
+                    const bool* abort = nullptr);
+};
+
+/// @}
+}  // end of namespace threads
+}  // end of namespace usml
@@ -5,6 +5,7 @@
 //#include <bits/stdint-intn.h>
 #include <cstdint>
 #include <cstddef>
+#include <usml/threads/parallel_chunks.h>
 #include <usml/threads/read_write_lock.h>
 #include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_pool.h>
@@ -13,9 +14,11 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/timer/timer.hpp>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(threads_test)
 
@@ -292,6 +295,58 @@ BOOST_AUTO_TEST_CASE(thread_controller_test) {
     #endif
 }
 
+/**
+ * Processes chunks with parallel_chunks, and checks that every chunk is
+ * processed exactly once, by a worker number less than num_threads().
+ * Then sets the abort flag from a chunk processed by the calling thread,
+ * and checks that run() reports the abort and stops claiming new chunks.
+ */
+BOOST_AUTO_TEST_CASE(parallel_chunks_test) {
+    cout << "=== threads_test: parallel_chunks_test ===" << endl;
+    const size_t num_chunks = 100;
+    const unsigned num_workers = 4;
+    const size_t num_threads =
+        parallel_chunks::num_threads(num_chunks, num_workers);
+    BOOST_CHECK_EQUAL(num_threads, num_workers);
+    BOOST_CHECK_EQUAL(parallel_chunks::num_threads(2, num_workers), 2);
+    BOOST_CHECK_EQUAL(parallel_chunks::num_threads(0, 0), 1);
+
+    // Boost.Test checks are not thread safe, so results are checked
+    // after run() returns
+
+    std::vector<int> count(num_chunks, 0);
+    std::atomic<size_t> bad_workers{0};
+    bool ok = parallel_chunks::run(
+        num_chunks, num_workers, [&](size_t index, size_t worker) {
+            ++count[index];
+            if (worker >= num_threads) {
+                ++bad_workers;
+            }
+            thread_task::sleep();
+        });
+    BOOST_CHECK(ok);
+    BOOST_CHECK_EQUAL(bad_workers, 0);
+    for (size_t n = 0; n < num_chunks; ++n) {
+        BOOST_CHECK_EQUAL(count[n], 1);
+    }
+
+    bool abort = false;
+    std::atomic<size_t> processed{0};
+    ok = parallel_chunks::run(
+        num_chunks, num_workers,
+        [&](size_t, size_t worker) {
+            ++processed;
+            if (worker == 0) {
+                abort = true;
+            }
+            thread_task::sleep();
+        },
+        &abort);
+    BOOST_CHECK(!ok);
+    BOOST_CHECK_LT(processed, num_chunks);
+    thread_task::wait();
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
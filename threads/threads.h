@@ -12,6 +12,7 @@
 #pragma once
 
 #include <usml/threads/read_write_lock.h>
+#include <usml/threads/parallel_chunks.h>
 #include <usml/threads/thread_controller.h>
 #include <usml/threads/thread_pool.h>
 #include <usml/threads/thread_task.h>
@@ -0,0 +1,319 @@
+/**
+ * @file column_writer.cc
+ * Streams records to a binary file with one contiguous array per column.
+ */
+
+#include <usml/types/column_writer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace usml::types;
+
+namespace {
+
+/// Alignment of each column in the final file.
+const size_t ALIGNMENT = 64;
+
+/// Quotes and escapes a string for the JSON header.
+std::string quote(const std::string& text) {
+    std::ostringstream oss;
+    oss << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            oss << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << (int)c << std::dec;
+        } else {
+            oss << c;
+        }
+    }
+    oss << '"';
+    return oss.str();
+}
+
+/// Formats a number for the JSON header, without loss of precision.
+std::string number(double value) {
+    std::ostringstream oss;
+    oss << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << value;
+    return oss.str();
+}
+
+/// Rounds a byte offset up to the next column alignment.
+size_t align(size_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+}  // namespace
+
+/**
+ * Creates a new column file.
+ */
+column_writer::column_writer(std::string filename, size_t block_size)
+    : _filename(std::move(filename)),
+      _block_size(std::max(block_size, (size_t)1)) {}
+
+/**
+ * Closes the file if it is still open.
+ */
+column_writer::~column_writer() {
+    try {
+        close();
+    } catch (...) {
+    }
+    for (auto& col : _columns) {
+        if (col.spill) {
+            col.spill.reset();
+            std::remove(col.spill_name.c_str());
+        }
+    }
+}
+
+/**
+ * Adds a string attribute to the header.
+ */
+void column_writer::attribute(const std::string& name,
+                              const std::string& value) {
+    _attributes.emplace_back(name, quote(value));
+}
+
+/**
+ * Adds a numeric attribute to the header.
+ */
+void column_writer::attribute(const std::string& name, double value) {
+    _attributes.emplace_back(name, number(value));
+}
+
+/**
+ * Adds an array attribute to the header.
+ */
+void column_writer::attribute(const std::string& name, const double* values,
+                              size_t size) {
+    std::string list = "[";
+    for (size_t n = 0; n < size; ++n) {
+        list += (n == 0) ? "" : ", ";
+        list += number(values[n]);
+    }
+    _attributes.emplace_back(name, list + "]");
+}
+
+/**
+ * Defines a new column.
+ */
+size_t column_writer::add_column(const std::string& name, column_type type,
+                                 const std::string& units, size_t width) {
+    if (_started) {
+        throw std::logic_error(
+            "column_writer: columns must be defined before appending");
+    }
+    column col;
+    col.name = name;
+    col.type = type;
+    col.units = units;
+    col.width = std::max(width, (size_t)1);
+    col.buffer.reserve(_block_size * col.width * type_size(type));
+    col.spill_name = _filename + "." + std::to_string(_columns.size()) + ".tmp";
+    _columns.push_back(std::move(col));
+    return _columns.size() - 1;
+}
+
+/**
+ * Appends one row of values to a column.
+ */
+void column_writer::append(size_t column, const double* values, size_t size) {
+    auto& col = _columns.at(column);
+    if (size != col.width) {
+        throw std::invalid_argument(
+            "column_writer: number of values does not match column width");
+    }
+    _started = true;
+    const size_t bytes = type_size(col.type);
+    const size_t offset = col.buffer.size();
+    col.buffer.resize(offset + size * bytes);
+    char* ptr = col.buffer.data() + offset;
+    for (size_t n = 0; n < size; ++n, ptr += bytes) {
+        switch (col.type) {
+            case column_type::float64: {
+                const double v = values[n];
+                std::memcpy(ptr, &v, bytes);
+            } break;
+            case column_type::int32: {
+                const auto v = (int32_t)values[n];
+                std::memcpy(ptr, &v, bytes);
+            } break;
+            case column_type::int16: {
+                const auto v = (int16_t)values[n];
+                std::memcpy(ptr, &v, bytes);
+            } break;
+        }
+    }
+    if (++col.rows % _block_size == 0) {
+        spill(col);
+    }
+}
+
+/**
+ * Number of complete rows.
+ */
+size_t column_writer::num_rows() const {
+    if (_columns.empty()) {
+        return 0;
+    }
+    size_t rows = _columns.front().rows;
+    for (const auto& col : _columns) {
+        rows = std::min(rows, col.rows);
+    }
+    return rows;
+}
+
+/**
+ * Writes the header and columns to the final file.
+ */
+void column_writer::close() {
+    if (_closed) {
+        return;
+    }
+    _closed = true;
+    const size_t rows = num_rows();
+    for (const auto& col : _columns) {
+        if (col.rows != rows) {
+            throw std::logic_error("column_writer: columns " +
+                                   _columns[0].name + " and " + col.name +
+                                   " have different lengths");
+        }
+    }
+
+    // compute column offsets, assuming header fits in first block,
+    // and repeat if the header turns out to be larger than expected
+
+    std::vector<size_t> offsets(_columns.size());
+    std::string header;
+    size_t start = ALIGNMENT;
+    while (true) {
+        size_t offset = start;
+        for (size_t c = 0; c < _columns.size(); ++c) {
+            offsets[c] = offset;
+            offset = align(offset + rows * _columns[c].width *
+                                        type_size(_columns[c].type));
+        }
+        std::ostringstream oss;
+        oss << "{\"num_rows\": " << rows << ", \"attributes\": {";
+        for (size_t n = 0; n < _attributes.size(); ++n) {
+            oss << (n == 0 ? "" : ", ") << quote(_attributes[n].first) << ": "
+                << _attributes[n].second;
+        }
+        oss << "}, \"columns\": [";
+        for (size_t c = 0; c < _columns.size(); ++c) {
+            const auto& col = _columns[c];
+            oss << (c == 0 ? "" : ", ") << "{\"name\": " << quote(col.name)
+                << ", \"dtype\": " << quote(type_name(col.type))
+                << ", \"shape\": [" << rows;
+            if (col.width > 1) {
+                oss << ", " << col.width;
+            }
+            oss << "], \"offset\": " << offsets[c]
+                << ", \"units\": " << quote(col.units) << "}";
+        }
+        oss << "]}";
+        header = oss.str();
+        const size_t needed = align(16 + header.size());
+        if (needed <= start) {
+            break;
+        }
+        start = needed;
+    }
+
+    // write header
+
+    std::ofstream out(_filename, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("column_writer: can not open " + _filename);
+    }
+    out.write("USMLCOL1", 8);
+    char length[8];
+    for (size_t n = 0; n < sizeof(length); ++n) {
+        length[n] = (char)((header.size() >> (8 * n)) & 0xFF);
+    }
+    out.write(length, sizeof(length));
+    out.write(header.data(), (std::streamsize)header.size());
+
+    // copy each column into place, from its temporary file and buffer
+
+    std::vector<char> block;
+    for (size_t c = 0; c < _columns.size(); ++c) {
+        auto& col = _columns[c];
+        const std::vector<char> pad(offsets[c] - (size_t)out.tellp(), 0);
+        out.write(pad.data(), (std::streamsize)pad.size());
+        if (col.spill) {
+            col.spill.reset();
+            std::ifstream in(col.spill_name, std::ios::binary);
+            block.resize(_block_size * col.width * type_size(col.type));
+            while (in) {
+                in.read(block.data(), (std::streamsize)block.size());
+                out.write(block.data(), in.gcount());
+            }
+            in.close();
+            std::remove(col.spill_name.c_str());
+        }
+        out.write(col.buffer.data(), (std::streamsize)col.buffer.size());
+        col.buffer.clear();
+        col.buffer.shrink_to_fit();
+    }
+    if (!out) {
+        throw std::runtime_error("column_writer: can not write " + _filename);
+    }
+}
+
+/**
+ * Number of bytes used by a single value of a column type.
+ */
+size_t column_writer::type_size(column_type type) {
+    switch (type) {
+        case column_type::int32:
+            return sizeof(int32_t);
+        case column_type::int16:
+            return sizeof(int16_t);
+        default:
+            return sizeof(double);
+    }
+}
+
+/**
+ * Numpy dtype string for a column type, in host byte order.
+ */
+std::string column_writer::type_name(column_type type) {
+    const uint16_t probe = 1;
+    const bool little = *(const char*)&probe == 1;
+    const std::string order = little ? "<" : ">";
+    switch (type) {
+        case column_type::int32:
+            return order + "i4";
+        case column_type::int16:
+            return order + "i2";
+        default:
+            return order + "f8";
+    }
+}
+
+/**
+ * Writes the buffered contents of a column to its temporary file.
+ */
+void column_writer::spill(column& col) {
+    if (!col.spill) {
+        col.spill = std::make_unique<std::ofstream>(
+            col.spill_name, std::ios::binary | std::ios::trunc);
+        if (!*col.spill) {
+            throw std::runtime_error("column_writer: can not open " +
+                                     col.spill_name);
+        }
+    }
+    col.spill->write(col.buffer.data(), (std::streamsize)col.buffer.size());
+    col.buffer.clear();
+}
@@ -0,0 +1,184 @@
+/**
+ * @file column_writer.h
+ * Streams records to a binary file with one contiguous array per column.
+ */
+#pragma once
+
+#include <usml/usml_config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace usml {
+namespace types {
+
+/// @ingroup types
+/// @{
+
+/**
+ * Streams records to a binary file with one contiguous array per column.
+ * Designed for offline analysis of very large data sets, like eigenverbs,
+ * where the file can be memory mapped directly into numpy arrays without
+ * copying or parsing. The python/src/usml/columns.py module provides a
+ * reader for this format.
+ *
+ * The file starts with an 8 byte magic string "USMLCOL1" followed by
+ * the length of a JSON header as a little-endian 64-bit unsigned integer.
+ * The JSON header lists the number of rows, the global attributes, and
+ * the name, numpy dtype, shape, byte offset, and units of each column.
+ * Each column is stored as a C-ordered array of shape (rows) or
+ * (rows,width), starting at an offset that is a multiple of 64 bytes.
+ * All values are stored in the byte order of the host, which is
+ * identified by the dtype strings in the header.
+ *
+ * Records are appended one column value at a time, so that clients can
+ * write records as they are created, without knowing the number of records
+ * in advance. Each column is buffered in memory in blocks of "block_size"
+ * rows. Full blocks are spilled to a temporary file for each column. The
+ * close() method writes the header and copies the temporary files into
+ * their final positions. This keeps the memory used by the writer
+ * bounded for very large data sets.
+ *
+ * This class is not thread safe. Clients are responsible for locking
+ * the writer if records come from multiple threads.
+ */
+class USML_DECLSPEC column_writer {
+   public:
+    /// Data types that can be stored in a column.
+    enum class column_type { float64, int32, int16 };
+
+    /**
+     * Creates a new column file. Nothing is written to the final file
+     * until close() is called.
+     *
+     * @param filename      Name of the file to write to disk.
+     * @param block_size    Number of rows buffered in memory per column.
+     */
+    column_writer(std::string filename, size_t block_size = 65536);
+
+    /**
+     * Closes the file if it is still open. Errors are ignored.
+     */
+    ~column_writer();
+
+    /**
+     * Adds a global attribute to the header.
+     *
+     * @param name          Name of the attribute.
+     * @param value         Value of the attribute.
+     */
+    void attribute(const std::string& name, const std::string& value);
+
+    /**
+     * Adds a global attribute to the header.
+     *
+     * @param name          Name of the attribute.
+     * @param value         Value of the attribute.
+     */
+    void attribute(const std::string& name, double value);
+
+    /**
+     * Adds a global array attribute to the header, like the frequency axis.
+     *
+     * @param name          Name of the attribute.
+     * @param values        Values of the attribute.
+     * @param size          Number of values.
+     */
+    void attribute(const std::string& name, const double* values,
+                   size_t size);
+
+    /**
+     * Defines a new column. All columns must be defined before
+     * the first value is appended.
+     *
+     * @param name          Name of the column.
+     * @param type          Data type stored on disk.
+     * @param units         Units of measure, blank if dimensionless.
+     * @param width         Number of values per row.
+     * @return              Index used to append values to this column.
+     * @throw std::logic_error  If values have already been appended.
+     */
+    size_t add_column(const std::string& name, column_type type,
+                      const std::string& units = "", size_t width = 1);
+
+    /**
+     * Appends a single value to a column, converted to the column type.
+     *
+     * @param column        Index returned by add_column().
+     * @param value         Value to append.
+     */
+    void append(size_t column, double value) { append(column, &value, 1); }
+
+    /**
+     * Appends one row of values to a column, converted to the column type.
+     *
+     * @param column        Index returned by add_column().
+     * @param values        Values to append, width() values per row.
+     * @param size          Number of values, must be equal to width().
+     * @throw std::invalid_argument If size does not match the column width.
+     */
+    void append(size_t column, const double* values, size_t size);
+
+    /**
+     * Number of complete rows, the smallest number of rows in any column.
+     */
+    size_t num_rows() const;
+
+    /**
+     * Writes the header and columns to the final file, and removes
+     * the temporary files. Does nothing if the file is already closed.
+     *
+     * @throw std::logic_error  If the columns have different lengths.
+     * @throw std::runtime_error If the file can not be written.
+     */
+    void close();
+
+   private:
+    /// Definition and buffered contents of a single column.
+    struct column {
+        std::string name;
+        column_type type;
+        std::string units;
+        size_t width;
+        size_t rows = 0;
+        std::vector<char> buffer;
+        std::string spill_name;
+        std::unique_ptr<std::ofstream> spill;
+    };
+
+    /// Name of the file to write to disk.
+    const std::string _filename;
+
+    /// Number of rows buffered in memory per column.
+    const size_t _block_size;
+
+    /// Global attributes, pre-formatted as JSON values.
+    std::vector<std::pair<std::string, std::string>> _attributes;
+
+    /// Column definitions and buffers.
+    std::vector<column> _columns;
+
+    /// True once values have been appended.
+    bool _started = false;
+
+    /// True once the file has been written.
+    bool _closed = false;
+
+    /// Number of bytes used by a single value of a column type.
+    static size_t type_size(column_type type);
+
+    /// Numpy dtype string for a column type.
+    static std::string type_name(column_type type);
+
+    /// Writes the buffered contents of a column to its temporary file.
+    void spill(column& col);
+};
+
+/// @}
+}  // namespace types
+}  // namespace usml
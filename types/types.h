@@ -36,6 +36,7 @@
 #pragma once
 
 #include <usml/types/bvector.h>
+#include <usml/types/column_writer.h>
 #include <usml/types/data_grid.h>
 #include <usml/types/data_grid_bathy.h>
 #include <usml/types/data_grid_svp.h>
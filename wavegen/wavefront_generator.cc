@@ -30,7 +30,8 @@ wavefront_generator::wavefront_generator(
     const matrix<uint64_t>& targetIDs, const seq_vector::csptr& frequencies,
     const seq_vector::csptr& de_fan, const seq_vector::csptr& az_fan,
     double time_step, double time_maximum, double intensity_threshold,
-    int max_bottom, int max_surface, const std::string& wavefront_file)
+    int max_bottom, int max_surface, const std::string& wavefront_file,
+    double finalize_margin)
     : _ocean(ocean_shared::current()),
       _source(source),
       _source_position(source->position()),
@@ -44,7 +45,8 @@ wavefront_generator::wavefront_generator(
       _intensity_threshold(intensity_threshold),
       _max_bottom(max_bottom),
       _max_surface(max_surface),
-      _wavefront_file(wavefront_file) {}
+      _wavefront_file(wavefront_file),
+      _finalize_margin(finalize_margin) {}
 
 /**
  * Executes the WaveQ3D propagation model.
@@ -69,18 +71,23 @@ void wavefront_generator::run() {
     wave.max_bottom(_max_bottom);
     wave.max_surface(_max_surface);
 
-    // create listener to store eigenrays, if targets exist
+    // create listener to store eigenrays, if targets exist,
+    // finalized targets are passed to the wave_queue and the source
 
-    auto* eigenrays = new eigenray_collection(_frequencies, _source_position,
-                                              _target_positions,
-                                              _source->keyID(), _targetIDs);
+    auto eigenrays = std::make_shared<eigenray_collection>(
+        _frequencies, _source_position, _target_positions, _source->keyID(),
+        _targetIDs);
+    _eigenrays = eigenrays;
     if (_targetIDs.size1() > 0 && _targetIDs.size2() > 0) {
-        wave.add_eigenray_listener(eigenrays);
+        eigenrays->finalize_margin(_finalize_margin);
+        wave.add_eigenray_listener(eigenrays.get());
+        eigenrays->add_target_listener(&wave);
+        eigenrays->add_target_listener(this);
     }
 
     // create listener to store eigenverbs
 
-    auto* eigenverbs = new eigenverb_collection(_ocean->num_volume());
+    auto* eigenverbs = new eigenverb_collection(_ocean->num_volume(), true);
     if (_source->compute_reverb()) {
         wave.add_eigenverb_listener(eigenverbs);
     }
@@ -95,7 +102,12 @@ void wavefront_generator::run() {
         wave.init_netcdf(_wavefront_file.c_str());
         wave.save_netcdf();
     }
-    while (wave.time() < _time_maximum) {
+    size_t num_steps = 0;
+    size_t num_rays = 0;
+    while (wave.time() < _time_maximum &&
+           (has_wavefront_file || wave.num_live_rays() > 0)) {
+        num_rays += wave.num_live_rays();
+        ++num_steps;
         wave.step();
         if (_abort) {
             cout << "task #" << id()
@@ -104,6 +116,7 @@ void wavefront_generator::run() {
             if (has_wavefront_file) {
                 wave.close_netcdf();
             }
+            _eigenrays.reset();
             return;
         }
         if (has_wavefront_file) {
@@ -113,15 +126,32 @@ void wavefront_generator::run() {
     if (has_wavefront_file) {
         wave.close_netcdf();
     }
-    if (eigenrays != nullptr) {
-        eigenrays->sum_eigenrays();
-    }
+    cout << "task #" << id() << " wavefront_generator: stopped at "
+         << wave.time() << " secs, "
+         << ((num_steps > 0) ? num_rays / num_steps : 0)
+         << " live rays per step" << endl;
+    eigenrays->remove_target_listener(&wave);
+    eigenrays->remove_target_listener(this);
+    eigenrays->sum_eigenrays();
+    _eigenrays.reset();
+    eigenverbs->build_index();
 
     // distribute eigenrays and eigenverbs to listeners
 
     _done = true;
     _source->notify_wavefront_listeners(
-        _source, eigenray_collection::csptr(eigenrays),
-        eigenverb_collection::csptr(eigenverbs));
+        _source, eigenrays, eigenverb_collection::csptr(eigenverbs));
     cout << "task #" << id() << " wavefront_generator: done" << endl;
 }
+
+/**
+ * Passes a finalized target to the source's wavefront listeners.
+ */
+void wavefront_generator::finalize_target(
+    const eigenray_collection& /*collection*/, size_t t1, size_t t2,
+    size_t /*runID*/) {
+    if (!_abort) {
+        _source->notify_wavefront_targets(_source, _eigenrays,
+                                          _targetIDs(t1, t2));
+    }
+}
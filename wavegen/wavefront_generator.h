@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <usml/eigenrays/eigenray_collection.h>
+#include <usml/eigenrays/eigenray_target_listener.h>
 #include <usml/ocean/ocean_model.h>
 #include <usml/threads/thread_task.h>
 #include <usml/types/seq_vector.h>
@@ -22,6 +24,7 @@ class sensor_model;
 namespace usml {
 namespace wavegen {
 
+using namespace usml::eigenrays;
 using namespace usml::ocean;
 using namespace usml::sensors;
 using namespace usml::threads;
@@ -37,8 +40,15 @@ using namespace usml::types;
  * the new background task is created. Results are stored in the sensor_model
  * that invoked this background task, unless the task is aborted prior to
  * completion.
+ *
+ * If the finalize margin is positive, the eigenrays for each target are
+ * finalized as soon as the wavefront has travelled that far past the first
+ * arrival at that target. Each finalized target is passed to the source's
+ * wavefront listeners while the wavefront is still propagating, and the
+ * wave_queue stops searching for eigenrays to that target.
  */
-class USML_DECLSPEC wavefront_generator : public thread_task {
+class USML_DECLSPEC wavefront_generator : public thread_task,
+                                          public eigenray_target_listener {
    public:
     /**
      * Construct wavefront generator for a specific sensor.
@@ -55,6 +65,9 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
      * @param max_bottom    	The maximum number of bottom bounces.
      * @param max_surface   	The maximum number of surface bounces.
      * @param wavefront_file   	NetCDF file to store wavefront data for debug.
+     * @param finalize_margin  	Time after first arrival before a target is
+     *                          finalized (sec). Zero disables finalization
+     *                          during propagation.
      *
      */
     wavefront_generator(sensor_model* source, const wposition& target_positions,
@@ -63,7 +76,9 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
                         const seq_vector::csptr& de_fan,
                         const seq_vector::csptr& az_fan, double time_step,
                         double time_maximum, double intensity_threshold,
-                        int max_bottom, int max_surface, const std::string& wavefront_file=std::string());
+                        int max_bottom, int max_surface,
+                        const std::string& wavefront_file = std::string(),
+                        double finalize_margin = 0.0);
 
     /**
      * Executes the WaveQ3D propagation model to generate eigenrays and
@@ -72,6 +87,18 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
      */
     virtual void run();
 
+    /**
+     * Passes a finalized target to the source's wavefront listeners.
+     * Ignored once the task has been aborted.
+     *
+     * @param collection    Collection that holds the eigenrays.
+     * @param t1     	    Row number of target.
+     * @param t2     	    Column number of target.
+     * @param runID 	    Wavefront identification number.
+     */
+    void finalize_target(const eigenray_collection& collection, size_t t1,
+                         size_t t2, size_t runID) override;
+
    private:
     /// Reference to the shared ocean at the time of invocation.
     /// Cached to avoid change while the calculation is being performed.
@@ -134,6 +161,12 @@ class USML_DECLSPEC wavefront_generator : public thread_task {
 
     /// NetCDF file in which to store wavefront data for debugging.
     std::string _wavefront_file;
+
+    /// Time after first arrival before a target is finalized (sec).
+    const double _finalize_margin;
+
+    /// Eigenrays being computed by run(), shared with target listeners.
+    eigenray_collection::csptr _eigenrays;
 };
 
 /// @}
@@ -9,6 +9,8 @@
 #include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/usml_config.h>
 
+#include <cstdint>
+
 namespace usml {
 namespace sensors {
 class sensor_model;
@@ -44,6 +46,22 @@ class USML_DECLSPEC wavefront_listener {
     virtual void update_wavefront_data(
         const sensor_model* sensor, eigenray_collection::csptr eigenrays,
         eigenverb_collection::csptr eigenverbs) = 0;
+
+    /**
+     * Notify listener that the eigenrays for one target are complete, while
+     * the wavefront for this sensor is still propagating. Only the eigenray
+     * list and total for this target can be used, because the rest of the
+     * collection is still being computed. Called from the wavefront
+     * generator's thread. Does nothing by default.
+     *
+     * @param sensor 		Sensor model that generated this wavefront data.
+     * @param eigenrays 	Shared pointer to the eigenrays being computed.
+     * @param targetID 	    Platform ID number of the finalized target.
+     * @see eigenray_collection::finalize_margin()
+     */
+    virtual void update_wavefront_target(
+        const sensor_model* /*sensor*/,
+        eigenray_collection::csptr /*eigenrays*/, uint64_t /*targetID*/) {}
 };
 
 /// @}
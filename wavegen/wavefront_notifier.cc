@@ -34,3 +34,14 @@ void wavefront_notifier::notify_wavefront_listeners(
         listener->update_wavefront_data(sensor, eigenrays, eigenverbs);
     }
 }
+
+/**
+ * Distribute a finalized target to all listeners.
+ */
+void wavefront_notifier::notify_wavefront_targets(
+    const sensor_model* sensor, const eigenray_collection::csptr& eigenrays,
+    uint64_t targetID) {
+    for (wavefront_listener* listener : _listeners) {
+        listener->update_wavefront_target(sensor, eigenrays, targetID);
+    }
+}
@@ -9,6 +9,7 @@
 #include <usml/usml_config.h>
 #include <usml/wavegen/wavefront_listener.h>
 
+#include <cstdint>
 #include <set>
 
 namespace usml {
@@ -41,6 +42,13 @@ class USML_DECLSPEC wavefront_notifier {
         const sensor_model* sensor, const eigenray_collection::csptr& eigenrays,
         const eigenverb_collection::csptr& eigenverbs);
 
+    /**
+     * Distribute a finalized target to all listeners.
+     */
+    void notify_wavefront_targets(const sensor_model* sensor,
+                                  const eigenray_collection::csptr& eigenrays,
+                                  uint64_t targetID);
+
    private:
     /**
      * List of active wavefront listeners.
@@ -184,3 +184,90 @@ void ode_integ::ab3_ndir(double dt, wave_front *y0, wave_front *y1,
                   A0 * y0->ndir_gradient.phi()),
         no_alias);
 }
+
+/**
+ * Variable step Adams-Bashforth (3rd order) estimate of position.
+ */
+void ode_integ::ab3_pos(double dt, double dt1, double dt2, wave_front *y0,
+                        wave_front *y1, wave_front *y2, wave_front *y3,
+                        bool no_alias) {
+    if (dt1 == dt && dt2 == dt) {
+        ab3_pos(dt, y0, y1, y2, y3, no_alias);
+        return;
+    }
+    double coeff[3];
+    ab3_coeff(dt, dt1, dt2, coeff);
+    const double A2 = coeff[0];
+    const double A1 = coeff[1];
+    const double A0 = coeff[2];
+
+    y3->position.rho(
+        dt * (A2 * y2->pos_gradient.rho() + A1 * y1->pos_gradient.rho() +
+              A0 * y0->pos_gradient.rho()),
+        no_alias);
+    y3->position.theta(
+        dt * (A2 * y2->pos_gradient.theta() + A1 * y1->pos_gradient.theta() +
+              A0 * y0->pos_gradient.theta()),
+        no_alias);
+    y3->position.phi(
+        dt * (A2 * y2->pos_gradient.phi() + A1 * y1->pos_gradient.phi() +
+              A0 * y0->pos_gradient.phi()),
+        no_alias);
+
+    y3->distance =
+        sqrt(abs2(y3->position.rho()) +
+             abs2(element_prod(y2->position.rho(), y3->position.theta())) +
+             abs2(element_prod(
+                 y2->position.rho(),
+                 element_prod(sin(y2->position.theta()), y3->position.phi()))));
+
+    y3->position.rho(y2->position.rho() + y3->position.rho(), false);
+    y3->position.theta(y2->position.theta() + y3->position.theta(), false);
+    y3->position.phi(y2->position.phi() + y3->position.phi(), false);
+}
+
+/**
+ * Variable step Adams-Bashforth (3rd order) estimate of ndirection.
+ */
+void ode_integ::ab3_ndir(double dt, double dt1, double dt2, wave_front *y0,
+                         wave_front *y1, wave_front *y2, wave_front *y3,
+                         bool no_alias) {
+    if (dt1 == dt && dt2 == dt) {
+        ab3_ndir(dt, y0, y1, y2, y3, no_alias);
+        return;
+    }
+    double coeff[3];
+    ab3_coeff(dt, dt1, dt2, coeff);
+    const double A2 = coeff[0];
+    const double A1 = coeff[1];
+    const double A0 = coeff[2];
+
+    y3->ndirection.rho(
+        y2->ndirection.rho() +
+            dt * (A2 * y2->ndir_gradient.rho() + A1 * y1->ndir_gradient.rho() +
+                  A0 * y0->ndir_gradient.rho()),
+        no_alias);
+    y3->ndirection.theta(
+        y2->ndirection.theta() + dt * (A2 * y2->ndir_gradient.theta() +
+                                       A1 * y1->ndir_gradient.theta() +
+                                       A0 * y0->ndir_gradient.theta()),
+        no_alias);
+    y3->ndirection.phi(
+        y2->ndirection.phi() +
+            dt * (A2 * y2->ndir_gradient.phi() + A1 * y1->ndir_gradient.phi() +
+                  A0 * y0->ndir_gradient.phi()),
+        no_alias);
+}
+
+/**
+ * Coefficients of the variable step Adams-Bashforth (3rd order) algorithm.
+ */
+void ode_integ::ab3_coeff(double dt, double dt1, double dt2, double coeff[3]) {
+    const double h = dt;
+    const double a = dt1;
+    const double b = dt1 + dt2;
+    const double h2 = h * h / 3.0;
+    coeff[0] = (h2 + 0.5 * (a + b) * h + a * b) / (a * b);
+    coeff[1] = -(h2 + 0.5 * b * h) / (a * dt2);
+    coeff[2] = (h2 + 0.5 * a * h) / (b * dt2);
+}
@@ -121,6 +121,55 @@ class USML_DECLSPEC ode_integ {
      */
     static void ab3_ndir(double dt, wave_front *y0, wave_front *y1,
                          wave_front *y2, wave_front *y3, bool no_alias = true);
+
+    /**
+     * Variable step Adams-Bashforth (3rd order) estimate of position.
+     * Integrates the quadratic that passes through the gradients at
+     * the three prior iterations, which need not be equally spaced in time.
+     * Identical to the fixed step version if all of the steps are equal.
+     *
+     * @param  dt       Time step from y2 to y3.
+     * @param  dt1      Time step from y1 to y2.
+     * @param  dt2      Time step from y0 to y1.
+     * @param  y0       Position of wavefront 2 iterations ago (input).
+     * @param  y1       Position of wavefront 1 iteration ago (input).
+     * @param  y2       Current position estimate (input).
+     * @param  y3       New position estimate (result).
+     * @param  no_alias Use uBLAS noalias() assignment speed-up if true.
+     */
+    static void ab3_pos(double dt, double dt1, double dt2, wave_front *y0,
+                        wave_front *y1, wave_front *y2, wave_front *y3,
+                        bool no_alias = true);
+
+    /**
+     * Variable step Adams-Bashforth (3rd order) estimate of ndirection.
+     * Identical to the fixed step version if all of the steps are equal.
+     *
+     * @param  dt       Time step from y2 to y3.
+     * @param  dt1      Time step from y1 to y2.
+     * @param  dt2      Time step from y0 to y1.
+     * @param  y0       Direction of wavefront 2 iterations ago (input).
+     * @param  y1       Direction of wavefront 1 iteration ago (input).
+     * @param  y2       Current ndirection estimate (input).
+     * @param  y3       New ndirection estimate (result).
+     * @param  no_alias Use uBLAS noalias() assignment speed-up if true.
+     */
+    static void ab3_ndir(double dt, double dt1, double dt2, wave_front *y0,
+                         wave_front *y1, wave_front *y2, wave_front *y3,
+                         bool no_alias = true);
+
+    /**
+     * Coefficients of the variable step Adams-Bashforth (3rd order)
+     * algorithm, normalized by the time step "dt". Computed by integrating
+     * the Lagrange polynomials for the three prior iterations from 0 to dt.
+     * Reduces to 23/12, -16/12, and 5/12 when all of the steps are equal.
+     *
+     * @param  dt       Time step from y2 to y3.
+     * @param  dt1      Time step from y1 to y2.
+     * @param  dt2      Time step from y0 to y1.
+     * @param  coeff    Coefficients for y2, y1, and y0 (output).
+     */
+    static void ab3_coeff(double dt, double dt1, double dt2, double coeff[3]);
 };
 
 }  // end of namespace waveq3d
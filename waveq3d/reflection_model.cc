@@ -288,34 +288,37 @@ void reflection_model::reflection_reinit(size_t de, size_t az,
 
     // Runge-Kutta to estimate prev wavefront from curr entry
     // adapted from wave_queue::init_wavefronts()
+    // uses the actual spacing of the queue, which may not be uniform
 
-    double time_step = _wave._time_step;
-    ode_integ::rk1_pos(-time_step, &curr, &next);
-    ode_integ::rk1_ndir(-time_step, &curr, &next);
+    const double time_step = _wave._time_step;
+    const double prev_step = _wave._prev_step;
+    const double past_step = _wave._past_step;
+    ode_integ::rk1_pos(-prev_step, &curr, &next);
+    ode_integ::rk1_ndir(-prev_step, &curr, &next);
     next.update();
 
-    ode_integ::rk2_pos(-time_step, &curr, &next, &past);
-    ode_integ::rk2_ndir(-time_step, &curr, &next, &past);
+    ode_integ::rk2_pos(-prev_step, &curr, &next, &past);
+    ode_integ::rk2_ndir(-prev_step, &curr, &next, &past);
     past.update();
 
-    ode_integ::rk3_pos(-time_step, &curr, &next, &past, &prev);
-    ode_integ::rk3_ndir(-time_step, &curr, &next, &past, &prev);
+    ode_integ::rk3_pos(-prev_step, &curr, &next, &past, &prev);
+    ode_integ::rk3_ndir(-prev_step, &curr, &next, &past, &prev);
     prev.update();
     reflection_copy(_wave._prev, de, az, prev);
 
     // Runge-Kutta to estimate past wavefront from prev entry
     // adapted from wave_queue::init_wavefronts()
 
-    ode_integ::rk1_pos(-time_step, &prev, &next);
-    ode_integ::rk1_ndir(-time_step, &prev, &next);
+    ode_integ::rk1_pos(-past_step, &prev, &next);
+    ode_integ::rk1_ndir(-past_step, &prev, &next);
     next.update();
 
-    ode_integ::rk2_pos(-time_step, &prev, &next, &temp);
-    ode_integ::rk2_ndir(-time_step, &prev, &next, &temp);
+    ode_integ::rk2_pos(-past_step, &prev, &next, &temp);
+    ode_integ::rk2_ndir(-past_step, &prev, &next, &temp);
     past.update();
 
-    ode_integ::rk3_pos(-time_step, &prev, &next, &temp, &past);
-    ode_integ::rk3_ndir(-time_step, &prev, &next, &temp, &past);
+    ode_integ::rk3_pos(-past_step, &prev, &next, &temp, &past);
+    ode_integ::rk3_ndir(-past_step, &prev, &next, &temp, &past);
     past.update();
     reflection_copy(_wave._past, de, az, past);
 
@@ -323,8 +326,10 @@ void reflection_model::reflection_reinit(size_t de, size_t az,
     // from past, prev, and curr entries
     // adapted from wave_queue::init_wavefronts()
 
-    ode_integ::ab3_pos(time_step, &past, &prev, &curr, &next);
-    ode_integ::ab3_ndir(time_step, &past, &prev, &curr, &next);
+    ode_integ::ab3_pos(time_step, prev_step, past_step, &past, &prev, &curr,
+                       &next);
+    ode_integ::ab3_ndir(time_step, prev_step, past_step, &past, &prev, &curr,
+                        &next);
     next.update();
     reflection_copy(_wave._next, de, az, next);
 }
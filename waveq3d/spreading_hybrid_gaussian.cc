@@ -10,6 +10,7 @@
 #include <usml/waveq3d/wave_front.h>
 #include <usml/waveq3d/wave_queue.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <memory>
@@ -29,7 +30,7 @@ spreading_hybrid_gaussian::spreading_hybrid_gaussian(wave_queue& wave)
     : spreading_model(wave, wave._frequencies->size()),
       _norm_de(wave.num_de()),
       _norm_az(wave.num_de(), wave.num_az()),
-      _beam_width(wave._frequencies->size()),
+      _spread_scale(wave._frequencies->size()),
       _intensity_de(wave._frequencies->size()),
       _intensity_az(wave._frequencies->size()),
       _duplicate(wave.num_az(), 1) {
@@ -56,6 +57,17 @@ spreading_hybrid_gaussian::spreading_hybrid_gaussian(wave_queue& wave)
 
     _norm_de /= sqrt(TWO_PI);
     _norm_az /= sqrt(TWO_PI);
+
+    for (size_t f = 0; f < wave._frequencies->size(); ++f) {
+        const double scale = SPREADING_WIDTH / (*wave._frequencies)(f);
+        _spread_scale(f) = scale * scale;
+    }
+
+    const size_t max_cells = std::max(wave.num_de(), wave.num_az());
+    _cell_dist.reserve(max_cells);
+    _cell_width.reserve(max_cells);
+    _cell_norm.reserve(max_cells);
+    _lowest_sum = 0.0;
 }
 
 /**
@@ -63,24 +75,13 @@ spreading_hybrid_gaussian::spreading_hybrid_gaussian(wave_queue& wave)
  * in the D/E and AZ directions.
  */
 const vector<double>& spreading_hybrid_gaussian::intensity(
-    const wposition1& location, size_t de, size_t az,
-    const vector<double>& offset, const vector<double>& distance) {
-    // get sound speed at target
-
-    matrix<double> sound_speed(1, 1);
-    wposition loc(1, 1);
-    loc.rho(0, 0, location.rho());
-    loc.theta(0, 0, location.theta());
-    loc.phi(0, 0, location.phi());
-    _wave._ocean->profile()->sound_speed(loc, &sound_speed);
-
-    // convert frequency into spreading distance
-
-    for (size_t f = 0; f < _wave._frequencies->size(); ++f) {
-        _spread(f) =
-            SPREADING_WIDTH * sound_speed(0, 0) / (*_wave._frequencies)(f);
-    }
-    _spread = element_prod(_spread, _spread);
+    size_t t1, size_t t2, size_t de, size_t az, const vector<double>& offset,
+    const vector<double>& distance) {
+    // convert frequency into spreading distance,
+    // using sound speed cached by wave_queue for this target
+
+    const double sound_speed = _wave._targets_sound_speed(t1, t2);
+    noalias(_spread) = (sound_speed * sound_speed) * _spread_scale;
 
     // compute Gaussian beam components in DE and AZ directions
 
@@ -142,30 +143,30 @@ void spreading_hybrid_gaussian::intensity_de(size_t de, size_t az,
     const double initial_width = cell_width;      // save for upper angles
     const double L = distance(1);                 // D/E dist from nearest ray
     double cell_dist = L - cell_width;  // dist from center of this cell
-    _intensity_de = gaussian(cell_dist, cell_width, _norm_de(d));
+    clear_gaussians();
+    add_gaussian(cell_dist, cell_width, _norm_de(d));
 
 #ifdef DEBUG_EIGENRAYS
     cout << "\t** center" << endl
          << "\tde(" << d << ")=" << (*_wave._source_de)(d)
          << " cell_dist=" << cell_dist << " cell_width=" << cell_width
-         << " beam_width=" << sqrt(_beam_width) << " norm=" << _norm_de(d)
-         << " intensity=" << _intensity_de << endl
+         << " norm=" << _norm_de(d) << " intensity=" << _lowest_sum << endl
          << "\t** lower " << endl;
 #endif
 
     d = (int)de - 1;
     cell_width = width_de(d, az, offset);  // half width of this cell
     cell_dist = L + cell_width;            // dist from center of this cell
-    _intensity_de += gaussian(cell_dist, cell_width, _norm_de(d));
+    add_gaussian(cell_dist, cell_width, _norm_de(d));
 
 #ifdef DEBUG_EIGENRAYS
     cout << "\tde(" << d << ")=" << (*_wave._source_de)(d)
          << " cell_dist=" << cell_dist << " cell_width=" << cell_width
-         << " beam_width=" << sqrt(_beam_width) << " norm=" << _norm_de(d)
-         << " intensity=" << _intensity_de << endl;
+         << " norm=" << _norm_de(d) << " intensity=" << _lowest_sum << endl;
 #endif
 
-    if (_intensity_de(0) < 1e-10) {
+    if (_lowest_sum < 1e-10) {
+        sum_gaussians(&_intensity_de);
         return;
     }
 
@@ -191,17 +192,16 @@ void spreading_hybrid_gaussian::intensity_de(size_t de, size_t az,
             _new_norm = _norm_de(d);
         }
 
-        const double old_tl = _intensity_de(0);
+        const double old_tl = _lowest_sum;
 
-        _intensity_de += gaussian(cell_dist, cell_width, _new_norm);
+        add_gaussian(cell_dist, cell_width, _new_norm);
 
 #ifdef DEBUG_EIGENRAYS
         cout << "\tde(" << d << ")=" << (*_wave._source_de)(d)
              << " cell_dist=" << cell_dist << " cell_width=" << cell_width
-             << " beam_width=" << sqrt(_beam_width) << " norm=" << _norm_de(d)
-             << " intensity=" << _intensity_de << endl;
+             << " norm=" << _norm_de(d) << " intensity=" << _lowest_sum << endl;
 #endif
-        if (_intensity_de(0) / old_tl < THRESHOLD) {
+        if (_lowest_sum / old_tl < THRESHOLD) {
             break;
         }
         if (virtual_ray) {
@@ -239,22 +239,22 @@ void spreading_hybrid_gaussian::intensity_de(size_t de, size_t az,
             _new_norm = _norm_de(d);
         }
 
-        const double old_tl = _intensity_de(0);
-        _intensity_de += gaussian(cell_dist, cell_width, _new_norm);
+        const double old_tl = _lowest_sum;
+        add_gaussian(cell_dist, cell_width, _new_norm);
 
 #ifdef DEBUG_EIGENRAYS
         cout << "\tde(" << d << ")=" << (*_wave._source_de)(d)
              << " cell_dist=" << cell_dist << " cell_width=" << cell_width
-             << " beam_width=" << sqrt(_beam_width) << " norm=" << _norm_de(d)
-             << " intensity=" << _intensity_de << endl;
+             << " norm=" << _norm_de(d) << " intensity=" << _lowest_sum << endl;
 #endif
-        if (_intensity_de(0) / old_tl < THRESHOLD) {
+        if (_lowest_sum / old_tl < THRESHOLD) {
             break;
         }
         if (virtual_ray) {
             break;
         }
     }
+    sum_gaussians(&_intensity_de);
 }
 
 /**
@@ -300,7 +300,8 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
     } else {
         _new_norm = _norm_az(de, a);
     }
-    _intensity_az = gaussian(cell_dist, cell_width, _new_norm);
+    clear_gaussians();
+    add_gaussian(cell_dist, cell_width, _new_norm);
 
     // contribution from AZ angle one lower than central cell
 
@@ -321,11 +322,12 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
     } else {
         _new_norm = _norm_az(de, a);
     }
-    _intensity_az += gaussian(cell_dist, cell_width, _new_norm);
+    add_gaussian(cell_dist, cell_width, _new_norm);
 
     // exit early if central rays have a tiny contribution
 
-    if (_intensity_az(0) < 1e-10) {
+    if (_lowest_sum < 1e-10) {
+        sum_gaussians(&_intensity_az);
         return;
     }
 
@@ -356,7 +358,7 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
 
         // compute propagation loss contribution of this cell
 
-        const double old_tl = _intensity_az(0);
+        const double old_tl = _lowest_sum;
 
         // Check for an abnormal normalization constant, ie when DE is close to
         // a de branch pt
@@ -366,9 +368,9 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
         } else {
             _new_norm = _norm_az(de, a);
         }
-        _intensity_az += gaussian(cell_dist, cell_width, _new_norm);
+        add_gaussian(cell_dist, cell_width, _new_norm);
 
-        if (_intensity_az(0) / old_tl < THRESHOLD) {
+        if (_lowest_sum / old_tl < THRESHOLD) {
             break;
         }
         if (a == 0) {
@@ -407,7 +409,7 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
 
         // compute propagation loss contribution of this cell
 
-        const double old_tl = _intensity_az(0);
+        const double old_tl = _lowest_sum;
         // Check for an abnormal normalization constant, ie when DE is close to
         // a de branch pt
         if (de >= max_de) {
@@ -415,13 +417,34 @@ void spreading_hybrid_gaussian::intensity_az(size_t de, size_t az,
         } else {
             _new_norm = _norm_az(de, a);
         }
-        _intensity_az += gaussian(cell_dist, cell_width, _new_norm);
+        add_gaussian(cell_dist, cell_width, _new_norm);
 
-        if (_intensity_az(0) / old_tl < THRESHOLD) {
+        if (_lowest_sum / old_tl < THRESHOLD) {
             break;
         }
         ++a;
     }
+    sum_gaussians(&_intensity_az);
+}
+
+/**
+ * Sum the Gaussian contributions of all recorded cells at each frequency.
+ */
+void spreading_hybrid_gaussian::sum_gaussians(vector<double>* intensity) const {
+    const size_t num_freq = _spread.size();
+    const size_t num_cells = _cell_norm.size();
+    const double* spread = &_spread.data()[0];
+    double* sum = &intensity->data()[0];
+    std::fill(sum, sum + num_freq, 0.0);
+    for (size_t c = 0; c < num_cells; ++c) {
+        const double dist = _cell_dist[c];
+        const double width = _cell_width[c];
+        const double norm = _cell_norm[c];
+        for (size_t f = 0; f < num_freq; ++f) {
+            const double beam_width = spread[f] + width;
+            sum[f] += exp(dist / beam_width) / sqrt(beam_width) * norm;
+        }
+    }
 }
 
 /**
@@ -436,7 +459,7 @@ double spreading_hybrid_gaussian::width_de(size_t de, size_t az,
 
     // compute relative offsets in time (u) and azimuth (v)
 
-    const double u = fabs(offset(0)) / _wave._time_step;
+    const double u = fabs(_wave.step_fraction(offset(0)));
     const double v = fabs(offset(2)) / (*_wave._source_az).increment(az);
 
     // compute the DE width for the current time step
@@ -505,7 +528,7 @@ double spreading_hybrid_gaussian::width_az(size_t de, size_t az,
     double length2;
     // compute relative offsets in time (u) and D/E (v)
 
-    const double u = fabs(offset(0)) / _wave._time_step;
+    const double u = fabs(_wave.step_fraction(offset(0)));
     const double v = fabs(offset(1)) / (*_wave._source_de).increment(de);
 
     // compute the AZ width for the current time step
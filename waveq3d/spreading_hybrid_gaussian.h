@@ -13,7 +13,9 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/vector_expression.hpp>
+#include <cmath>
 #include <cstddef>
+#include <vector>
 
 namespace usml {
 namespace waveq3d {
@@ -62,8 +64,25 @@ class USML_DECLSPEC spreading_hybrid_gaussian : public spreading_model {
     /** Normalization in azimuthal direction. */
     matrix<double> _norm_az;
 
-    /** Combination of cell width and spreading. (temp workspace) */
-    vector<double> _beam_width;
+    /**
+     * Square of the spreading width per unit sound speed at each frequency.
+     * Multiplied by the square of the sound speed at each target to
+     * compute the frequency dependent spreading term, without dividing
+     * by frequency for every eigenray.
+     */
+    vector<double> _spread_scale;
+
+    /** Scaled square of distance to each contributing cell. (temp workspace) */
+    std::vector<double> _cell_dist;
+
+    /** Scaled square of width of each contributing cell. (temp workspace) */
+    std::vector<double> _cell_width;
+
+    /** Normalization of each contributing cell. (temp workspace) */
+    std::vector<double> _cell_norm;
+
+    /** Sum of contributing cells at the lowest frequency. (temp workspace) */
+    double _lowest_sum;
 
     /** Intensity contribution in D/E direction. (temp workspace) */
     vector<double> _intensity_de;
@@ -122,7 +141,8 @@ class USML_DECLSPEC spreading_hybrid_gaussian : public spreading_model {
     virtual ~spreading_hybrid_gaussian() {}
 
     /**
-     * Compute the Gaussian contribution from a single wavefront cell.
+     * Add the Gaussian contribution from a single wavefront cell to the
+     * current summation.
      * \f[
      *      \frac{A}{w\sqrt{2\pi}} exp\left( - \frac{d^2}{2w^2} \right)
      * \f]
@@ -138,35 +158,67 @@ class USML_DECLSPEC spreading_hybrid_gaussian : public spreading_model {
      * is folded into the normalization calculation so that it can be
      * computed a single time, during initialization.
      *
+     * The search for contributing cells only needs the lowest frequency,
+     * so this method just records the cell and updates the lowest frequency
+     * sum. The contributions at all frequencies are computed in a single
+     * batch by sum_gaussians(), once the search is complete.
+     *
      * @param   d           Distance from field point to center of profile.
      * @param   w           Half-width this cell in the wavefront.
      * @param   A           Normalization coefficient.
+     * @return              Lowest frequency sum, including this cell.
      *
      * @xref Weisstein, Eric W. "Convolution." From MathWorld--A Wolfram Web
      * Resource. http://mathworld.wolfram.com/Convolution.html
      */
-    inline vector<double> gaussian(double d, double w, double A) {
-        _beam_width = _spread + OVERLAP * OVERLAP * w * w;  // sum of squares
-        return element_div(exp((-0.5 * d * d) / _beam_width),
-                           sqrt(_beam_width)) *
-               A;
+    inline double add_gaussian(double d, double w, double A) {
+        const double dist = -0.5 * d * d;
+        const double width = OVERLAP * OVERLAP * w * w;  // sum of squares
+        _cell_dist.push_back(dist);
+        _cell_width.push_back(width);
+        _cell_norm.push_back(A);
+        const double beam_width = _spread(0) + width;
+        _lowest_sum += exp(dist / beam_width) / sqrt(beam_width) * A;
+        return _lowest_sum;
     }
 
+    /**
+     * Remove all contributing cells from the current summation.
+     */
+    inline void clear_gaussians() {
+        _cell_dist.clear();
+        _cell_width.clear();
+        _cell_norm.clear();
+        _lowest_sum = 0.0;
+    }
+
+    /**
+     * Sum the Gaussian contributions of all recorded cells at each frequency.
+     * Cells are summed in the order they were added, so that the lowest
+     * frequency result matches the sum that controlled the search.
+     * The inner loop runs across frequencies on contiguous memory,
+     * without temporary vectors, so that the compiler can vectorize it.
+     *
+     * @param   intensity   Sum of all Gaussian contributions (output).
+     */
+    void sum_gaussians(vector<double>* intensity) const;
+
     /**
      * Estimate intensity as the product of Gaussian contributions in the
      * D/E and AZ directions.  It assumes that the the divergence can be
      * characterized in terms of independent D/E and AZ terms and that
      * Gaussian beam cross terms are unimportant.
      *
-     * @param  location     Target location.
+     * @param  t1           Row number of the target.
+     * @param  t2           Column number of the target.
      * @param  de           DE index of closest point of approach.
      * @param  az           AZ index of closest point of approach.
      * @param  offset       Offsets in time, DE, and AZ at collision.
      * @param  distance     Offsets in distance units.
      * @return              Intensity of ray at this point.
      */
-    virtual const vector<double>& intensity(const wposition1& location,
-                                            size_t de, size_t az,
+    virtual const vector<double>& intensity(size_t t1, size_t t2, size_t de,
+                                            size_t az,
                                             const vector<double>& offset,
                                             const vector<double>& distance);
 
@@ -59,15 +59,16 @@ class USML_DECLSPEC spreading_model {
     /**
      * Estimate intensity at a specific target location.
      *
-     * @param  location     Target location.
+     * @param  t1           Row number of the target.
+     * @param  t2           Column number of the target.
      * @param  de           DE index of closest point of approach.
      * @param  az           AZ index of closest point of approach.
      * @param  offset       Offsets in time, DE, and AZ at collision.
      * @param  distance     Offsets in distance units.
      * @return              Intensity of ray at this point.
      */
-    virtual const vector<double>& intensity(const wposition1& location,
-                                            size_t de, size_t az,
+    virtual const vector<double>& intensity(size_t t1, size_t t2, size_t de,
+                                            size_t az,
                                             const vector<double>& offset,
                                             const vector<double>& distance) = 0;
 
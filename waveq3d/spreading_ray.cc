@@ -45,8 +45,8 @@ spreading_ray::spreading_ray(wave_queue& wave)
  * Estimate intensity as the ratio of current area to initial area.
  */
 const vector<double>& spreading_ray::intensity(
-    const wposition1& location, size_t de, size_t az,
-    const vector<double>& offset, const vector<double>& /*distance*/) {
+    size_t t1, size_t t2, size_t de, size_t az, const vector<double>& offset,
+    const vector<double>& /*distance*/) {
     // which box has target in it?
 
     if (offset(1) < 0.0) {
@@ -56,14 +56,9 @@ const vector<double>& spreading_ray::intensity(
         --az;
     }
 
-    // get sound speed at target
+    // get sound speed at target, cached by wave_queue
 
-    matrix<double> sound_speed(1, 1);
-    wposition loc(1, 1);
-    loc.rho(0, 0, location.rho());
-    loc.theta(0, 0, location.theta());
-    loc.phi(0, 0, location.phi());
-    _wave._ocean->profile()->sound_speed(loc, &sound_speed);
+    const double sound_speed = _wave._targets_sound_speed(t1, t2);
 
     // compare area of this box to original area
     // linear interpolation between two wavefronts
@@ -106,12 +101,12 @@ const vector<double>& spreading_ray::intensity(
         area2 = t2p1.area(t2p2, t2p3, t2p4);
     }
 
-    double u = fabs(offset(0)) / _wave._time_step;
+    double u = fabs(_wave.step_fraction(offset(0)));
     const double area = (1.0 - u) * area1 + u * area2;
     //    cout << " area1=" << area1 << " area2=" << area2
     //         << " u=" << u << " area=" << area << endl ;
     const double loss =
-        _init_area(de, az) * sound_speed(0, 0) / (area * _init_sound_speed);
+        _init_area(de, az) * sound_speed / (area * _init_sound_speed);
     for (size_t f = 0; f < _wave._frequencies->size(); ++f) {
         _spread(f) = loss;
     }
@@ -80,15 +80,16 @@ class USML_DECLSPEC spreading_ray : public spreading_model {
      * away from the actual edge.  A failure to properly take this into account
      * will show up as weak eignerays near the surface, bottom, or caustics.
      *
-     * @param  location     Target location.
+     * @param  t1           Row number of the target.
+     * @param  t2           Column number of the target.
      * @param  de           DE index of closest point of approach.
      * @param  az           AZ index of closest point of approach.
      * @param  offset       Offsets in time, DE, and AZ at collision.
      * @param  distance     Offsets in distance units.
      * @return              Intensity of ray at this point.
      */
-    virtual const vector<double>& intensity(const wposition1& location,
-                                            size_t de, size_t az,
+    virtual const vector<double>& intensity(size_t t1, size_t t2, size_t de,
+                                            size_t az,
                                             const vector<double>& offset,
                                             const vector<double>& distance);
 
@@ -2,6 +2,7 @@
  * @example waveq3d/test/eigenray_test.cc
  */
 #include <usml/eigenrays/eigenrays.h>
+#include <usml/eigenverbs/eigenverb_collection.h>
 #include <usml/ocean/ocean.h>
 #include <usml/waveq3d/waveq3d.h>
 
@@ -16,6 +17,7 @@ BOOST_AUTO_TEST_SUITE(waveq3d_eigenray_test)
 using namespace boost::unit_test;
 using namespace usml::waveq3d;
 using namespace usml::eigenrays;
+using namespace usml::eigenverbs;
 
 /**
  * @ingroup waveq3d_test
@@ -197,6 +199,323 @@ BOOST_AUTO_TEST_CASE(eigenray_basic) {
     }
 }
 
+/**
+ * Tests the ability of the wave_queue to stop propagating once it can no
+ * longer contribute to any results. Uses the eigenray_basic scenario, but
+ * finalizes the target 0.7 seconds after the direct path arrives, and
+ * registers the wave_queue as a target listener. The direct path and
+ * surface bounce paths arrive before the target is finalized, but the
+ * bottom bounce path does not. Once the target is finalized, there are no
+ * remaining targets and no eigenverb listeners, so every ray should be
+ * masked out and propagation should stop well before the 3.5 sec limit
+ * used by eigenray_basic.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_pruning) {
+    cout << "=== eigenray_test: eigenray_pruning ===" << endl;
+    const double src_alt = -1000.0;
+    const double trg_lat = 45.02;
+    const double time_max = 3.5;
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 5.0, 60.0));
+    seq_vector::csptr az(new seq_linear(-4.0, 1.0, 4.0));
+    wposition target(1, 1, trg_lat, src_lng, src_alt);
+
+    eigenray_collection collection(freq, pos, target, 1);
+    collection.finalize_margin(0.7);
+    wave_queue wave(ocean, freq, pos, de, az, time_step, &target);
+    wave.add_eigenray_listener(&collection);
+    collection.add_target_listener(&wave);
+
+    // propagate until no rays remain
+
+    const size_t num_rays = de->size() * az->size();
+    BOOST_CHECK_EQUAL(wave.num_live_rays(), num_rays);
+    size_t total_rays = 0;
+    size_t num_steps = 0;
+    while (wave.time() < time_max && wave.num_live_rays() > 0) {
+        total_rays += wave.num_live_rays();
+        ++num_steps;
+        wave.step();
+    }
+    cout << "stopped at " << wave.time() << " secs, "
+         << total_rays / num_steps << " live rays per step" << endl;
+    BOOST_CHECK(collection.is_final(0, 0));
+    BOOST_CHECK_EQUAL(wave.num_live_rays(), 0);
+    BOOST_CHECK(!wave.is_live(de->size() / 2, az->size() / 2));
+    BOOST_CHECK_LT(wave.time(), 1.484018789 + 0.7 + 2.0 * time_step);
+
+    // direct and surface paths are complete, bottom path was never computed
+
+    const eigenray_list& raylist = collection.eigenrays(0, 0);
+    BOOST_REQUIRE_EQUAL(raylist.size(), 2);
+    auto ray = raylist.begin();
+    BOOST_CHECK_SMALL((*ray)->travel_time - 1.484018789, 0.002);
+    ++ray;
+    BOOST_CHECK_SMALL((*ray)->travel_time - 1.995102731, 0.002);
+    collection.remove_target_listener(&wave);
+}
+
+/**
+ * Tests the bound on eigenverb power used to mask out rays that are too weak
+ * for eigenverbs. Uses the eigenray_basic ocean, without targets. The
+ * eigenverb grazing is raised from its default of 1e-6 radians to 0.1
+ * degrees, and the eigenverb threshold is set just above the largest power
+ * that any ray in this fan can produce at that grazing angle, so every ray
+ * should be masked out after the first step. A bound computed from the
+ * default grazing angle would have kept every ray alive.
+ */
+BOOST_AUTO_TEST_CASE(eigenverb_pruning) {
+    cout << "=== eigenray_test: eigenverb_pruning ===" << endl;
+    const double src_alt = -1000.0;
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 5.0, 60.0));
+    seq_vector::csptr az(new seq_linear(-4.0, 1.0, 4.0));
+
+    // largest solid angle in this fan is the ray launched horizontally
+
+    const double max_area = 2.0 * sin(to_radians(2.5)) * to_radians(1.0);
+    eigenverb_collection collection(ocean->num_volume());
+    wave_queue wave(ocean, freq, pos, de, az, time_step);
+    wave.add_eigenverb_listener(&collection);
+    BOOST_CHECK_CLOSE(wave.eigenverb_grazing(), to_degrees(1e-6), 1e-10);
+    wave.eigenverb_grazing(0.1);
+    BOOST_CHECK_CLOSE(wave.eigenverb_grazing(), 0.1, 1e-10);
+    wave.eigenverb_threshold(
+        10.0 * log10(1.1 * max_area * wave.max_eigenverb_gain()));
+    BOOST_CHECK_GT(max_area / sin(1e-6), 1.0);
+
+    wave.step();
+    BOOST_CHECK_EQUAL(wave.num_live_rays(), 0);
+    while (wave.time() < 3.5) {
+        wave.step();
+    }
+    for (size_t n = 0; n < collection.num_interfaces(); ++n) {
+        BOOST_CHECK_EQUAL(collection.eigenverbs(n).size(), 0);
+    }
+}
+
+/**
+ * Tests the ability of the adaptive mode to refine the ray fan around
+ * targets. Uses the eigenray_basic scenario, but with a D/E ray spacing
+ * of 10 degrees instead of 5 degrees, and an AZ spacing of 2 degrees
+ * instead of 1 degree. The same scenario is run with and without
+ * refinement. Refinement launches a subfan around the direct and surface
+ * bounce paths, which are inside the coarse fan, but not around the bottom
+ * bounce path, which is outside of the coarse fan. The refined direct and
+ * surface bounce paths should be at least as accurate as those from
+ * eigenray_basic, and the bottom bounce path should still be found
+ * by the coarse fan.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_refinement) {
+    cout << "=== eigenray_test: eigenray_refinement ===" << endl;
+    const double src_alt = -1000.0;
+    const double trg_lat = 45.02;
+    const double time_max = 3.5;
+    const double travel_time[] = {1.484018789, 1.995102731, 3.051676949};
+    const double source_de[] = {-0.01, 41.93623171, -60.91257162};
+    const double intensity[] = {66.9506, 69.5211, 73.2126};
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 10.0, 60.0));
+    seq_vector::csptr az(new seq_linear(-4.0, 2.0, 4.0));
+    wposition target(1, 1, trg_lat, src_lng, src_alt);
+
+    for (size_t factor : {0, 5}) {
+        eigenray_collection collection(freq, pos, target, 1);
+        wave_queue wave(ocean, freq, pos, de, az, time_step, &target);
+        wave.refine_factor(factor);
+        wave.add_eigenray_listener(&collection);
+        while (wave.time() < time_max) {
+            wave.step();
+        }
+        cout << "refine_factor=" << factor << " subfans=" << wave.num_subfans()
+             << endl;
+
+        const eigenray_list& raylist = collection.eigenrays(0, 0);
+        BOOST_REQUIRE_EQUAL(raylist.size(), 3);
+        size_t n = 0;
+        for (const auto& ray : raylist) {
+            cout << "ray #" << n << " error:"
+                 << " tl=" << (ray->intensity(0) - intensity[n])
+                 << " t=" << (ray->travel_time - travel_time[n])
+                 << " de=" << (ray->source_de - source_de[n]) << endl;
+            if (factor > 0 && n < 2) {
+                BOOST_CHECK_SMALL(ray->intensity(0) - intensity[n], 0.1);
+                BOOST_CHECK_SMALL(ray->travel_time - travel_time[n], 0.002);
+                BOOST_CHECK_SMALL(ray->source_de - source_de[n], 0.01);
+            }
+            ++n;
+        }
+        if (factor > 0) {
+            BOOST_CHECK_EQUAL(wave.num_subfans(), 2);
+        }
+    }
+}
+
+/**
+ * Tests the adaptive mode for AZ fans that are too narrow for a subfan,
+ * and for AZ fans that wrap around all azimuths. Uses the
+ * eigenray_refinement scenario, with a three ray AZ fan centered on the
+ * target, and with a full circle AZ fan that starts and ends at the
+ * azimuth of the target. The first should only be refined in D/E, and the
+ * second should wrap the subfan around the end of the AZ fan. In both
+ * cases, subfans should be launched around the direct and surface bounce
+ * paths, and those paths should be as accurate as in eigenray_refinement.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_refinement_az) {
+    cout << "=== eigenray_test: eigenray_refinement_az ===" << endl;
+    const double src_alt = -1000.0;
+    const double trg_lat = 45.02;
+    const double time_max = 2.5;
+    const double travel_time[] = {1.484018789, 1.995102731};
+    const double source_de[] = {-0.01, 41.93623171};
+    const double intensity[] = {66.9506, 69.5211};
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 10.0, 60.0));
+    wposition target(1, 1, trg_lat, src_lng, src_alt);
+
+    for (const seq_vector::csptr& az :
+         {seq_vector::csptr(new seq_linear(-2.0, 2.0, 2.0)),
+          seq_vector::csptr(new seq_linear(0.0, 2.0, 360.0))}) {
+        eigenray_collection collection(freq, pos, target, 1);
+        wave_queue wave(ocean, freq, pos, de, az, time_step, &target);
+        wave.refine_factor(5);
+        wave.add_eigenray_listener(&collection);
+        while (wave.time() < time_max) {
+            wave.step();
+        }
+        cout << "num_az=" << az->size() << " subfans=" << wave.num_subfans()
+             << endl;
+        BOOST_CHECK_EQUAL(wave.num_subfans(), 2);
+
+        const eigenray_list& raylist = collection.eigenrays(0, 0);
+        BOOST_REQUIRE_EQUAL(raylist.size(), 2);
+        size_t n = 0;
+        for (const auto& ray : raylist) {
+            cout << "ray #" << n << " error:"
+                 << " tl=" << (ray->intensity(0) - intensity[n])
+                 << " t=" << (ray->travel_time - travel_time[n])
+                 << " de=" << (ray->source_de - source_de[n]) << endl;
+            BOOST_CHECK_SMALL(ray->intensity(0) - intensity[n], 0.1);
+            BOOST_CHECK_SMALL(ray->travel_time - travel_time[n], 0.002);
+            BOOST_CHECK_SMALL(ray->source_de - source_de[n], 0.01);
+            ++n;
+        }
+    }
+}
+
+/**
+ * Tests the accuracy of eigenrays computed with adaptive time stepping.
+ * Uses the eigenray_basic scenario, but starts with a 25 msec time step,
+ * and lets the step grow to 200 msec. Ray paths are straight lines in
+ * this isovelocity ocean, so the local errors are small, and the time
+ * step should grow quickly. The travel times, launch angles, and
+ * propagation loss of the direct and surface bounce paths should be as
+ * accurate as those from eigenray_basic, even though the time steps
+ * around each eigenray are not equal, and the surface reflection
+ * happens in a non-uniform queue. Compares the number of steps to
+ * the number needed for a fixed 25 msec time step.
+ */
+BOOST_AUTO_TEST_CASE(eigenray_adaptive_step) {
+    cout << "=== eigenray_test: eigenray_adaptive_step ===" << endl;
+    const double src_alt = -1000.0;
+    const double trg_lat = 45.02;
+    const double time_max = 3.5;
+    const double min_step = 0.025;
+    const double travel_time[] = {1.484018789, 1.995102731};
+    const double source_de[] = {-0.01, 41.93623171};
+    const double intensity[] = {66.9506, 69.5211};
+
+    // initialize propagation model
+
+    wposition::compute_earth_radius(src_lat);
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    boundary_model::csptr surface(new boundary_flat());
+    attenuation_model::csptr attn(new attenuation_constant(0.0));
+    profile_model::csptr profile(new profile_linear(c0, attn));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    seq_vector::csptr freq(new seq_log(10e3, 2.0, 3));
+    wposition1 pos(src_lat, src_lng, src_alt);
+    seq_vector::csptr de(new seq_linear(-60.0, 5.0, 60.0));
+    seq_vector::csptr az(new seq_linear(-4.0, 1.0, 4.0));
+    wposition target(1, 1, trg_lat, src_lng, src_alt);
+
+    eigenray_collection collection(freq, pos, target, 1);
+    wave_queue wave(ocean, freq, pos, de, az, min_step, &target);
+    wave.step_tolerance(0.01);
+    wave.min_time_step(min_step);
+    wave.max_time_step(0.2);
+    wave.add_eigenray_listener(&collection);
+    while (wave.time() < time_max) {
+        wave.step();
+    }
+    const auto fixed_steps = (size_t)ceil(time_max / min_step);
+    cout << wave.num_steps() << " adaptive steps vs. " << fixed_steps
+         << " fixed steps, final step " << wave.time_step() << " secs"
+         << endl;
+    BOOST_CHECK_LT(wave.num_steps(), fixed_steps / 4);
+    BOOST_CHECK_CLOSE(wave.time_step(), 0.2, 1e-6);
+
+    const eigenray_list& raylist = collection.eigenrays(0, 0);
+    BOOST_REQUIRE_GE(raylist.size(), 2);
+    size_t n = 0;
+    for (const auto& ray : raylist) {
+        if (n >= 2) {
+            break;
+        }
+        cout << "ray #" << n << " error:"
+             << " tl=" << (ray->intensity(0) - intensity[n])
+             << " t=" << (ray->travel_time - travel_time[n])
+             << " de=" << (ray->source_de - source_de[n]) << endl;
+        BOOST_CHECK_SMALL(ray->intensity(0) - intensity[n], 0.1);
+        BOOST_CHECK_SMALL(ray->travel_time - travel_time[n], 0.002);
+        BOOST_CHECK_SMALL(ray->source_de - source_de[n], 0.01);
+        ++n;
+    }
+}
+
 /**
  * Tests the model's ability to accurately estimate geometric terms for
  * the direct path and surface reflected eigenrays on a spherical earth.
@@ -1178,6 +1178,60 @@ BOOST_AUTO_TEST_CASE(surface_duct_test) {
     wave.close_netcdf();
 }
 
+/**
+ * Write a decimated subset of the wavefronts from an isovelocity ocean
+ * to a netCDF log, and read it back. Checks that only every 3rd time step,
+ * every 4th D/E ray, and every 2nd AZ ray are recorded, and that the
+ * first record contains the source altitude. Generates a BOOST error if
+ * the file does not contain the expected subset.
+ */
+BOOST_AUTO_TEST_CASE(wavefront_subset) {
+    cout << "=== refraction_test: wavefront_subset ===" << endl;
+    const char* ncname_wave =
+        USML_TEST_DIR "/waveq3d/test/wavefront_subset.nc";
+
+    profile_model::csptr profile(new profile_linear(1500.0));
+    boundary_model::csptr surface(new boundary_flat());
+    boundary_model::csptr bottom(new boundary_flat(3000.0));
+    ocean_model::csptr ocean(new ocean_model(surface, bottom, profile));
+
+    wposition1 pos(45.0, -45.0, -1000.0);
+    seq_vector::csptr de(new seq_linear(-10.0, 1.0, 10.0));
+    seq_vector::csptr az(new seq_linear(0.0, 30.0, 90.0));
+    seq_vector::csptr freq(new seq_log(10e3, 1.0, 1));
+    wave_queue wave(ocean, freq, pos, de, az, time_step);
+
+    cout << "writing wavefronts to " << ncname_wave << endl;
+    wave.init_netcdf(ncname_wave, "wavefront_subset", 3, 4, 2);
+    wave.save_netcdf();
+    for (int n = 0; n < 10; ++n) {
+        wave.step();
+        wave.save_netcdf();
+    }
+    wave.close_netcdf();
+
+    netCDF::NcFile file(ncname_wave, netCDF::NcFile::read);
+    BOOST_CHECK_EQUAL(file.getDim("travel_time").getSize(), 4);
+    BOOST_CHECK_EQUAL(file.getDim("source_de").getSize(), 6);
+    BOOST_CHECK_EQUAL(file.getDim("source_az").getSize(), 2);
+
+    std::vector<double> travel_time(4);
+    file.getVar("travel_time").getVar(travel_time.data());
+    std::vector<double> source_de(6);
+    file.getVar("source_de").getVar(source_de.data());
+    std::vector<double> altitude(4 * 6 * 2);
+    file.getVar("altitude").getVar(altitude.data());
+    for (size_t n = 0; n < 4; ++n) {
+        BOOST_CHECK_CLOSE(travel_time[n], 3.0 * n * time_step, 1e-10);
+    }
+    for (size_t d = 0; d < 6; ++d) {
+        BOOST_CHECK_CLOSE(source_de[d], -10.0 + 4.0 * d, 1e-10);
+    }
+    for (size_t n = 0; n < 6 * 2; ++n) {
+        BOOST_CHECK_CLOSE(altitude[n], -1000.0, 1e-6);
+    }
+}
+
 /// @}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,7 @@
  * Wavefront propagation as a function of time.
  */
 #include <usml/eigenverbs/eigenverb_model.h>
+#include <usml/types/seq_linear.h>
 #include <usml/waveq3d/ode_integ.h>
 #include <usml/waveq3d/reflection_model.h>
 #include <usml/waveq3d/spreading_hybrid_gaussian.h>
@@ -12,8 +13,12 @@
 #include <boost/numeric/ublas/lu.hpp>
 #include <boost/numeric/ublas/triangular.hpp>
 #include <boost/numeric/ublas/vector_proxy.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iomanip>
+#include <limits>
+#include <memory>
 #include <utility>
 
 // #define DEBUG_EIGENRAYS_DETAIL
@@ -24,6 +29,78 @@ using namespace usml::eigenrays;
 using namespace usml::eigenverbs;
 using namespace usml::waveq3d;
 
+namespace {
+
+/**
+ * Replaces the values on the previous wavefront with the quadratic
+ * extrapolation from wave_queue::prev_weights().
+ */
+void resample_prev(double value[3][3][3], const double weight[3]) {
+    for (size_t n1 = 0; n1 < 3; ++n1) {
+        for (size_t n2 = 0; n2 < 3; ++n2) {
+            value[0][n1][n2] = weight[0] * value[0][n1][n2] +
+                               weight[1] * value[1][n1][n2] +
+                               weight[2] * value[2][n1][n2];
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * Denser ray fan launched around a poorly resolved CPA. Listens for the
+ * eigenrays of its own wave_queue, and forwards the ones that it owns to
+ * the listeners of the coarse wave_queue. Eigenrays found while the subfan
+ * is catching up to the time it was created are discarded, because the
+ * coarse fan has already reported them.
+ */
+struct wave_queue::subfan : public eigenray_listener {
+    /** Coarse wave_queue that created this subfan. */
+    wave_queue& parent;
+
+    /** Propagator for the rays in this subfan. */
+    std::unique_ptr<wave_queue> wave;
+
+    /** Range of launch D/E angles owned by this subfan (degrees). */
+    double de_min, de_max;
+
+    /** Range of launch AZ angles owned by this subfan (degrees). */
+    double az_min, az_max;
+
+    /** True if AZ angles are compared modulo 360 degrees. */
+    bool wrap;
+
+    /** Number of coarse steps when this subfan was created. */
+    size_t created;
+
+    subfan(wave_queue& parent, double de_min, double de_max, double az_min,
+           double az_max, bool wrap)
+        : parent(parent),
+          de_min(de_min),
+          de_max(de_max),
+          az_min(az_min),
+          az_max(az_max),
+          wrap(wrap),
+          created(parent.num_steps()) {}
+
+    /** True if this subfan owns a launch angle. */
+    bool owns(double de, double az) const {
+        if (wrap) {
+            az = az_min + fmod(fmod(az - az_min, 360.0) + 360.0, 360.0);
+        }
+        return de >= de_min && de < de_max && az >= az_min && az < az_max;
+    }
+
+    /** Forwards the eigenrays owned by this subfan. */
+    void add_eigenray(size_t t1, size_t t2, eigenray_model::csptr ray,
+                      size_t runID) override {
+        if (wave->num_steps() >= created &&
+            parent.find_subfan(ray->source_de, ray->source_az) == this) {
+            parent.notify_eigenray_listeners(t1, t2, ray, runID);
+        }
+    }
+};
+
 /**
  * Initialize a propagation scenario.
  */
@@ -40,10 +117,25 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
       _max_de(de->size() - 1),
       _max_az(az->size() - 1),
       _time_step(time_step),
+      _prev_step(time_step),
+      _past_step(time_step),
       _time(0.0),
       _target_pos(target_pos),
       _run_id(0),
-      _nc_file(nullptr) {
+      _live(de->size(), az->size(), true),
+      _num_live(de->size() * az->size()),
+      _num_targets_done(0),
+      _spreading_type(type),
+      _refine_factor(0),
+      _refine_distance(0.0),
+      _max_subfans(16),
+      _step_tolerance(0.0),
+      _min_time_step(0.25 * time_step),
+      _max_time_step(4.0 * time_step),
+      _step_scale(1.0),
+      _step_source(nullptr),
+      _nc_decimation(1),
+      _nc_step(0) {
     _az_boundary = false;
     if (_source_az->size() > 1) {
         const double az_first = abs((*_source_az)(0));
@@ -53,6 +145,11 @@ wave_queue::wave_queue(const ocean_model::csptr& ocean,
     }
     if (_target_pos != nullptr) {
         _targets_sin_theta = sin(_target_pos->theta());
+        _targets_sound_speed.resize(_target_pos->size1(),
+                                    _target_pos->size2());
+        _ocean->profile()->sound_speed(*_target_pos, &_targets_sound_speed);
+        _target_done = scalar_matrix<bool>(_target_pos->size1(),
+                                           _target_pos->size2(), false);
     }
 
     // check for sources outside of the water column
@@ -147,6 +244,7 @@ void wave_queue::init_wavefronts() {
     ode_integ::ab3_ndir(_time_step, _past, _prev, _curr, _next);
     _next->update();
     _next->path_length = _next->distance + _curr->path_length;
+    _step_sizes.push_back(_time_step);
 }
 
 /**
@@ -165,13 +263,12 @@ void wave_queue::step() {
     _curr = _next;
     _next = save;
     _time += _time_step;
+    _past_step = _prev_step;
+    _prev_step = _time_step;
 
     // compute position, direction, and environment parameters for next entry
 
-    ode_integ::ab3_pos(_time_step, _past, _prev, _curr, _next);
-    ode_integ::ab3_ndir(_time_step, _past, _prev, _curr, _next);
-
-    _next->update();
+    integrate_next();
     _next->path_length = _next->distance + _curr->path_length;
 
     _next->attenuation += _curr->attenuation;
@@ -185,10 +282,177 @@ void wave_queue::step() {
     // search for eigenray collisions with acoustic targets
 
     detect_eigenrays();
+    if (_refine_factor >= 2) {
+        refine_eigenrays();
+    }
 
     // notify listeners that this step is complete
 
     check_eigenray_listeners(_time, runID());
+
+    // mask out rays that no longer contribute to the results
+
+    update_live_rays();
+}
+
+/**
+ * Stops searching for eigenrays to a target whose eigenrays are complete.
+ */
+void wave_queue::finalize_target(const eigenray_collection& collection,
+                                 size_t t1, size_t t2, size_t runID) {
+    if (_target_pos == nullptr || t1 >= _target_done.size1() ||
+        t2 >= _target_done.size2() || _target_done(t1, t2)) {
+        return;
+    }
+    _target_done(t1, t2) = true;
+    ++_num_targets_done;
+    for (auto& sub : _subfans) {
+        sub->wave->finalize_target(collection, t1, t2, runID);
+    }
+}
+
+/**
+ * Number of rays that can still contribute to eigenrays or eigenverbs.
+ */
+size_t wave_queue::num_live_rays() const {
+    size_t num = _num_live;
+    for (const auto& sub : _subfans) {
+        num += sub->wave->num_live_rays();
+    }
+    return num;
+}
+
+/**
+ * Computes the next entry in the wavefront queue.
+ */
+void wave_queue::integrate_next() {
+    const bool adaptive = _step_tolerance > 0.0 && _step_source == nullptr;
+    if (_step_source != nullptr) {
+        _time_step = (*_step_source)[_step_sizes.size()];
+    } else if (adaptive) {
+        _time_step = std::min(std::max(_time_step * _step_scale,
+                                       _min_time_step),
+                              _max_time_step);
+    }
+    while (true) {
+        ode_integ::ab3_pos(_time_step, _prev_step, _past_step, _past, _prev,
+                           _curr, _next);
+        ode_integ::ab3_ndir(_time_step, _prev_step, _past_step, _past, _prev,
+                            _curr, _next);
+        _next->update();
+        if (!adaptive) {
+            break;
+        }
+
+        // scale step by the fourth root of the error ratio,
+        // because the local error of this algorithm is O(dt^4)
+
+        const double error = step_error();
+        const double scale =
+            (error > 0.0) ? 0.9 * pow(_step_tolerance / error, 0.25) : 2.0;
+        if (error <= _step_tolerance || _time_step <= _min_time_step) {
+            _step_scale = std::min(std::max(scale, 0.5), 2.0);
+            break;
+        }
+        _time_step = std::max(_time_step * std::max(scale, 0.5),
+                              _min_time_step);
+    }
+    _step_sizes.push_back(_time_step);
+}
+
+/**
+ * Estimates the local position error in the next entry.
+ */
+double wave_queue::step_error() const {
+    const double h = _time_step;
+    const double a = _prev_step;
+    const double c3 = h * (2.0 * h + 3.0 * a) / (6.0 * (h + a));
+    const double c2 = h * (h + 3.0 * a) / (6.0 * a);
+    const double c1 = -h * h * h / (6.0 * a * (a + h));
+    const wvector& g3 = _next->pos_gradient;
+    const wvector& g2 = _curr->pos_gradient;
+    const wvector& g1 = _prev->pos_gradient;
+
+    double error = 0.0;
+    for (size_t de = 0; de < num_de(); ++de) {
+        for (size_t az = 0; az < num_az(); ++az) {
+            if (!_live(de, az)) {
+                continue;
+            }
+            const double rho = _next->position.rho(de, az);
+            const double theta = _next->position.theta(de, az);
+            const double drho = _curr->position.rho(de, az) +
+                                c3 * g3.rho(de, az) + c2 * g2.rho(de, az) +
+                                c1 * g1.rho(de, az) - rho;
+            const double dtheta =
+                _curr->position.theta(de, az) + c3 * g3.theta(de, az) +
+                c2 * g2.theta(de, az) + c1 * g1.theta(de, az) - theta;
+            const double dphi = _curr->position.phi(de, az) +
+                                c3 * g3.phi(de, az) + c2 * g2.phi(de, az) +
+                                c1 * g1.phi(de, az) -
+                                _next->position.phi(de, az);
+            const double dz = rho * sin(theta) * dphi;
+            const double d2 =
+                drho * drho + rho * rho * dtheta * dtheta + dz * dz;
+            error = std::max(error, d2);
+        }
+    }
+    return 0.9 * sqrt(error);
+}
+
+/**
+ * Weights that evaluate the quadratic through the previous, current,
+ * and next entries at one time step before the current entry.
+ */
+void wave_queue::prev_weights(double weight[3]) const {
+    const double h = _time_step;
+    const double a = _prev_step;
+    if (a == h) {
+        weight[0] = 1.0;
+        weight[1] = 0.0;
+        weight[2] = 0.0;
+    } else {
+        weight[0] = 2.0 * h * h / (a * (a + h));
+        weight[1] = 2.0 * (a - h) / a;
+        weight[2] = (h - a) / (h + a);
+    }
+}
+
+/**
+ * Masks out rays that can no longer contribute to any eigenray or eigenverb.
+ */
+void wave_queue::update_live_rays() {
+    const double max_verb_gain = max_eigenverb_gain();
+    const bool need_eigenrays =
+        _target_pos != nullptr && has_eigenray_listeners() &&
+        _num_targets_done < _target_pos->size1() * _target_pos->size2();
+    const bool need_eigenverbs = has_eigenverb_listeners();
+
+    for (size_t de = 0; de < num_de(); ++de) {
+        for (size_t az = 0; az < num_az(); ++az) {
+            if (!_live(de, az)) {
+                continue;
+            }
+            bool live = false;
+            if (!above_bounce_threshold(_curr, de, az)) {
+                const vector<double>& atten = _curr->attenuation(de, az);
+                if (need_eigenrays && above_intensity_threshold(atten)) {
+                    live = true;
+                } else if (need_eigenverbs) {
+                    double de_delta;
+                    const double loss =
+                        *std::min_element(atten.begin(), atten.end());
+                    live = above_eigenverb_threshold(
+                        pow(10.0, -0.1 * loss) * beam_area(de, az, &de_delta) *
+                        max_verb_gain);
+                }
+            }
+            if (!live) {
+                _live(de, az) = false;
+                --_num_live;
+            }
+        }
+    }
 }
 
 /**
@@ -295,7 +559,7 @@ void wave_queue::detect_caustics(size_t de, size_t az) {
  * Detect volume boundary reflections for reverberation contributions
  */
 void wave_queue::detect_volume_scattering(size_t de, size_t az) {
-    if (!has_eigenverb_listeners()) {
+    if (!has_eigenverb_listeners() || !_live(de, az)) {
         return;
     }
     if (above_bounce_threshold(_curr, de, az)) {
@@ -360,6 +624,9 @@ void wave_queue::detect_eigenrays() {
     // loop over all targets
     for (size_t t1 = 0; t1 < _target_pos->size1(); ++t1) {
         for (size_t t2 = 0; t2 < _target_pos->size2(); ++t2) {
+            if (_target_done(t1, t2)) {
+                continue;
+            }
             _de_branch = false;
             if (abs(_source_pos.latitude() - _target_pos->latitude(t1, t2)) <
                     1e-4 &&
@@ -376,7 +643,7 @@ void wave_queue::detect_eigenrays() {
                     // it prevents edges from acting as CPA, if so, go to next
                     // de/az Also check to see if this ray is a duplicate.
 
-                    if (_curr->on_edge(de, az)) {
+                    if (_curr->on_edge(de, az) || !_live(de, az)) {
                         continue;
                     }
 
@@ -561,6 +828,15 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
         }
     }
 
+    // interpolate in time as if the previous wavefront was
+    // the same distance from the current wavefront as the next one
+
+    const bool resample = _prev_step != _time_step;
+    double weight[3];
+    prev_weights(weight);
+    if (resample) {
+        resample_prev(distance2, weight);
+    }
     compute_offsets(t1, t2, de, az, distance2, delta, offset, distance);
 
     // build basic eigenray products
@@ -580,8 +856,8 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
 
     // compute spreading components of intensity
 
-    const vector<double> spread_intensity = _spreading_model->intensity(
-        wposition1(*(_curr->targets), t1, t2), de, az, offset, distance);
+    const vector<double> spread_intensity =
+        _spreading_model->intensity(t1, t2, de, az, offset, distance);
     for (size_t i = 0; i < ray->intensity.size(); ++i) {
         if (std::isnan(spread_intensity(i))) {
             #ifdef USML_DEBUG
@@ -599,7 +875,7 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
 
     // compute attenuation components of intensity
 
-    double dt = offset(0) / _time_step;
+    double dt = step_fraction(offset(0));
     if (dt >= 0.0) {
         ray->intensity = ray->intensity +
                          _curr->attenuation(de, az) * (1.0 - dt) +
@@ -650,6 +926,9 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
     double center;
     c_vector<double, 3> gradient;
     c_matrix<double, 3, 3> hessian;
+    if (resample) {
+        resample_prev(distance2, weight);
+    }
     make_taylor_coeff(distance2, delta, center, gradient, hessian);
     ray->target_de = center + inner_prod(gradient, offset) +
                      0.5 * inner_prod(offset, prod(hessian, offset));
@@ -684,6 +963,9 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
         }
     }
 
+    if (resample) {
+        resample_prev(distance2, weight);
+    }
     make_taylor_coeff(distance2, delta, center, gradient, hessian);
     ray->target_az = center + inner_prod(gradient, offset) +
                      0.5 * inner_prod(offset, prod(hessian, offset));
@@ -697,8 +979,130 @@ void wave_queue::build_eigenray(size_t t1, size_t t2, size_t de, size_t az,
              << " caustic=" << ray->caustic << endl;
     #endif
 
-    // Add eigenray to those objects which requested them
-    notify_eigenray_listeners(t1, t2, ray_csptr, runID());
+    // Add eigenray to those objects which requested them,
+    // or hold it until the end of the step in adaptive mode
+    if (_refine_factor < 2) {
+        notify_eigenray_listeners(t1, t2, ray_csptr, runID());
+    } else {
+        const bool refine =
+            unstable || abs(offset(1)) > 0.5 * abs(delta(1)) ||
+            abs(offset(2)) > 0.5 * abs(delta(2)) ||
+            max(abs(distance(1)), abs(distance(2))) > _refine_distance;
+        _pending.push_back({t1, t2, ray_csptr, de, az, refine});
+    }
+}
+
+/**
+ * Completes the eigenray search for the adaptive mode.
+ */
+void wave_queue::refine_eigenrays() {
+    for (auto& sub : _subfans) {
+        if (sub->wave->num_live_rays() > 0) {
+            sub->wave->step();
+        }
+    }
+    for (const auto& pending : _pending) {
+        if (pending.refine && _subfans.size() < _max_subfans &&
+            find_subfan(pending.ray->source_de, pending.ray->source_az) ==
+                nullptr) {
+            add_subfan(pending.de, pending.az, *pending.ray);
+        }
+    }
+    for (const auto& pending : _pending) {
+        if (find_subfan(pending.ray->source_de, pending.ray->source_az) ==
+            nullptr) {
+            notify_eigenray_listeners(pending.t1, pending.t2, pending.ray,
+                                      runID());
+        }
+    }
+    _pending.clear();
+}
+
+/**
+ * Launches a new subfan around a coarse ray and propagates it
+ * to the current time.
+ */
+void wave_queue::add_subfan(size_t de, size_t az, const eigenray_model& ray) {
+    const size_t de_lo = (de >= 2) ? de - 2 : 0;
+    const size_t de_hi = std::min(de + 2, _max_de);
+
+    // owns the launch angles more than one coarse ray from its edges
+
+    const double de_a = source_de(std::min(de_lo + 1, de_hi));
+    const double de_b = source_de(std::max(de_hi - 1, de_lo));
+    double az_a = -std::numeric_limits<double>::infinity();
+    double az_b = std::numeric_limits<double>::infinity();
+    seq_vector::csptr az_fan = _source_az;
+
+    if (_az_boundary) {
+        // AZ angles of coarse rays past the end of the fan, which wraps
+        // around to the start of the fan at _max_az
+
+        const auto num = (std::ptrdiff_t)_max_az;
+        const double span = source_az(_max_az) - source_az(0);
+        const auto az_angle = [&](std::ptrdiff_t n) {
+            const std::ptrdiff_t k = (n % num + num) % num;
+            return source_az((size_t)k) + span * (double)((n - k) / num);
+        };
+        const auto n = (std::ptrdiff_t)az;
+        az_a = az_angle(n - 1);
+        az_b = az_angle(n + 1);
+        az_fan = std::make_shared<seq_linear>(
+            az_angle(n - 2), az_angle(n + 2), 4 * _refine_factor + 1, true);
+    } else if (_max_az >= 4) {
+        const size_t az_lo = (az >= 2) ? az - 2 : 0;
+        const size_t az_hi = std::min(az + 2, _max_az);
+        az_a = source_az(std::min(az_lo + 1, az_hi));
+        az_b = source_az(std::max(az_hi - 1, az_lo));
+        az_fan = std::make_shared<seq_linear>(
+            source_az(az_lo), source_az(az_hi),
+            (az_hi - az_lo) * _refine_factor + 1, true);
+    }
+    auto* sub = new subfan(*this, std::min(de_a, de_b), std::max(de_a, de_b),
+                           std::min(az_a, az_b), std::max(az_a, az_b),
+                           _az_boundary);
+    if (!sub->owns(ray.source_de, ray.source_az)) {
+        delete sub;  // too close to the edge of the coarse fan
+        return;
+    }
+    _subfans.emplace_back(sub);
+
+    // launch subfan with the same targets and thresholds as the coarse fan
+
+    seq_vector::csptr de_fan(
+        new seq_linear(source_de(de_lo), source_de(de_hi),
+                       (de_hi - de_lo) * _refine_factor + 1, true));
+    sub->wave = std::make_unique<wave_queue>(
+        _ocean, _frequencies, _source_pos, de_fan, az_fan,
+        _step_sizes.front(), _target_pos, _spreading_type);
+    wave_queue& wave = *sub->wave;
+    static_cast<wave_thresholds&>(wave) = *this;
+    wave.runID(runID());
+    if (_target_pos != nullptr) {
+        wave._target_done = _target_done;
+        wave._num_targets_done = _num_targets_done;
+    }
+    wave.add_eigenray_listener(sub);
+
+    // catch up to the coarse fan, following its time steps
+
+    wave._step_source = &_step_sizes;
+    while (wave.num_steps() < num_steps()) {
+        wave.step();
+    }
+}
+
+/**
+ * Finds the first subfan that owns a launch angle.
+ */
+const wave_queue::subfan* wave_queue::find_subfan(double de,
+                                                  double az) const {
+    for (const auto& sub : _subfans) {
+        if (sub->owns(de, az)) {
+            return sub.get();
+        }
+    }
+    return nullptr;
 }
 
 /**
@@ -982,78 +1386,47 @@ void wave_queue::make_taylor_coeff(const double value[3][3][3],
 void wave_queue::collision_location(size_t de, size_t az, double time_water,
                                     wposition1* position, wvector1* ndirection,
                                     double* speed) const {
-    double drho;
-    double dtheta;
-    double dphi;
-    double d2rho;
-    double d2theta;
-    double d2phi;
     const double time1 = 2.0 * _time_step;
     const double time2 = _time_step * _time_step;
     const double dtime2 = time_water * time_water;
+    const bool resample = _prev_step != _time_step;
+    double weight[3];
+    prev_weights(weight);
+
+    // second order Taylor series from previous, current, and next values,
+    // with the previous value moved to one time step before current
 
-    // second order Taylor series for sound speed
-
-    drho = (_next->sound_speed(de, az) - _prev->sound_speed(de, az)) / time1;
-
-    d2rho = (_next->sound_speed(de, az) + _prev->sound_speed(de, az) -
-             2.0 * _curr->sound_speed(de, az)) /
-            time2;
-
-    *speed =
-        _curr->sound_speed(de, az) + drho * time_water + 0.5 * d2rho * dtime2;
-
-    // second order Taylor series for position
-
-    drho = (_next->position.rho(de, az) - _prev->position.rho(de, az)) / time1;
-    dtheta =
-        (_next->position.theta(de, az) - _prev->position.theta(de, az)) / time1;
-    dphi = (_next->position.phi(de, az) - _prev->position.phi(de, az)) / time1;
-
-    d2rho = (_next->position.rho(de, az) + _prev->position.rho(de, az) -
-             2.0 * _curr->position.rho(de, az)) /
-            time2;
-    d2theta = (_next->position.theta(de, az) + _prev->position.theta(de, az) -
-               2.0 * _curr->position.theta(de, az)) /
-              time2;
-    d2phi = (_next->position.phi(de, az) + _prev->position.phi(de, az) -
-             2.0 * _curr->position.phi(de, az)) /
-            time2;
-
-    position->rho(_curr->position.rho(de, az) + drho * time_water +
-                  0.5 * d2rho * dtime2);
-    position->theta(_curr->position.theta(de, az) + dtheta * time_water +
-                    0.5 * d2theta * dtime2);
-    position->phi(_curr->position.phi(de, az) + dphi * time_water +
-                  0.5 * d2phi * dtime2);
-
-    // second order Taylor series for ndirection
-
-    drho =
-        (_next->ndirection.rho(de, az) - _prev->ndirection.rho(de, az)) / time1;
-    dtheta =
-        (_next->ndirection.theta(de, az) - _prev->ndirection.theta(de, az)) /
-        time1;
-    dphi =
-        (_next->ndirection.phi(de, az) - _prev->ndirection.phi(de, az)) / time1;
-
-    d2rho = (_next->ndirection.rho(de, az) + _prev->ndirection.rho(de, az) -
-             2.0 * _curr->ndirection.rho(de, az)) /
-            time2;
-    d2theta =
-        (_next->ndirection.theta(de, az) + _prev->ndirection.theta(de, az) -
-         2.0 * _curr->ndirection.theta(de, az)) /
-        time2;
-    d2phi = (_next->ndirection.phi(de, az) + _prev->ndirection.phi(de, az) -
-             2.0 * _curr->ndirection.phi(de, az)) /
-            time2;
-
-    ndirection->rho(_curr->ndirection.rho(de, az) + drho * time_water +
-                    0.5 * d2rho * dtime2);
-    ndirection->theta(_curr->ndirection.theta(de, az) + dtheta * time_water +
-                      0.5 * d2theta * dtime2);
-    ndirection->phi(_curr->ndirection.phi(de, az) + dphi * time_water +
-                    0.5 * d2phi * dtime2);
+    auto taylor = [&](double prev, double curr, double next) {
+        if (resample) {
+            prev = weight[0] * prev + weight[1] * curr + weight[2] * next;
+        }
+        const double d1 = (next - prev) / time1;
+        const double d2 = (next + prev - 2.0 * curr) / time2;
+        return curr + d1 * time_water + 0.5 * d2 * dtime2;
+    };
+
+    *speed = taylor(_prev->sound_speed(de, az), _curr->sound_speed(de, az),
+                    _next->sound_speed(de, az));
+
+    position->rho(taylor(_prev->position.rho(de, az),
+                         _curr->position.rho(de, az),
+                         _next->position.rho(de, az)));
+    position->theta(taylor(_prev->position.theta(de, az),
+                           _curr->position.theta(de, az),
+                           _next->position.theta(de, az)));
+    position->phi(taylor(_prev->position.phi(de, az),
+                         _curr->position.phi(de, az),
+                         _next->position.phi(de, az)));
+
+    ndirection->rho(taylor(_prev->ndirection.rho(de, az),
+                           _curr->ndirection.rho(de, az),
+                           _next->ndirection.rho(de, az)));
+    ndirection->theta(taylor(_prev->ndirection.theta(de, az),
+                             _curr->ndirection.theta(de, az),
+                             _next->ndirection.theta(de, az)));
+    ndirection->phi(taylor(_prev->ndirection.phi(de, az),
+                           _curr->ndirection.phi(de, az),
+                           _next->ndirection.phi(de, az)));
 }
 
 /**
@@ -1065,8 +1438,9 @@ void wave_queue::build_eigenverb(size_t de, size_t az, double dt,
                                  const wposition1& position,
                                  const wvector1& ndirection, size_t type) {
     grazing = abs(grazing);
-    if (!has_eigenverb_listeners() || above_bounce_threshold(_curr, de, az) ||
-        _time <= 0.0 || grazing < 1e-6 ||
+    if (!has_eigenverb_listeners() || !_live(de, az) ||
+        above_bounce_threshold(_curr, de, az) ||
+        _time <= 0.0 || !above_eigenverb_grazing(grazing) ||
         (this->_az_boundary && az == this->_max_az) ||
         abs(source_de(de)) > 89.9) {
         return;
@@ -1076,27 +1450,11 @@ void wave_queue::build_eigenverb(size_t de, size_t az, double dt,
 #endif
 
     // compute size of area centered on ray
-    //   - use inc halfway to next and prev ray for arbitrary ray spacing
-    //   - wrap az-1 around to end of sequence if az=0 and _az_boundary
-    //   - otherwise assumes seq_vector::increment() handles end points
     //   - compute average height and width such that area = height * width
 
-    const double de_angle = to_radians((*_source_de)(de));
-    const double de_plus =
-        de_angle + 0.5 * to_radians(_source_de->increment(de));
-    const double de_minus =
-        de_angle - 0.5 * to_radians(_source_de->increment(de - 1));
-
-    const double az_angle = to_radians((*_source_az)(az));
-    const double az_plus =
-        az_angle + 0.5 * to_radians(_source_az->increment(az));
-    const size_t az_index = (az == 0 && _az_boundary) ? _max_az : az;
-    const double az_minus =
-        az_angle - 0.5 * to_radians(_source_az->increment(az_index - 1));
-
-    const double area = (sin(de_plus) - sin(de_minus)) * (az_plus - az_minus);
-    const double de_delta = de_plus - de_minus;  // average height
-    const double az_delta = area / de_delta;     // average width
+    double de_delta;  // average height
+    const double area = beam_area(de, az, &de_delta);
+    const double az_delta = area / de_delta;  // average width
 
     // compute the half-length and half-width of the eigenverb
     //   - assumes change in height and width proportional to path length
@@ -1109,7 +1467,7 @@ void wave_queue::build_eigenverb(size_t de, size_t az, double dt,
     }
     const double sin_grazing = sin(grazing);
 
-    auto* verb = new eigenverb_model();
+    eigenverb_model* verb = &_eigenverb;
     verb->length = 0.5 * path_length * de_delta / sin_grazing;
     verb->width = 0.5 * path_length * az_delta;
 
@@ -1117,7 +1475,10 @@ void wave_queue::build_eigenverb(size_t de, size_t az, double dt,
     //    - using attenuation along the path and initial size of beam
     //	  - assuming that curr()->attenuation(de,az) in positive value in dB
 
-    verb->power =
+    if (verb->power.size() != _frequencies->size()) {
+        verb->power.resize(_frequencies->size(), false);
+    }
+    noalias(verb->power) =
         pow(10.0, -0.1 * curr()->attenuation(de, az)) * area / sin_grazing;
     if (!above_eigenverb_threshold(verb->power)) {
         return;
@@ -1160,5 +1521,30 @@ void wave_queue::build_eigenverb(size_t de, size_t az, double dt,
          << "\tsurface=" << verb->surface << " bottom=" << verb->bottom
          << " caustic=" << verb->caustic << endl;
 #endif
-    notify_eigenverb_listeners(eigenverb_model::csptr(verb), type);
+    notify_eigenverb_listeners(_eigenverb, type);
+}
+
+/**
+ * Solid angle of the ray fan around a single ray.
+ */
+double wave_queue::beam_area(size_t de, size_t az, double* de_delta) const {
+    // use inc halfway to next and prev ray for arbitrary ray spacing
+    //   - wrap az-1 around to end of sequence if az=0 and _az_boundary
+    //   - otherwise assumes seq_vector::increment() handles end points
+
+    const double de_angle = to_radians((*_source_de)(de));
+    const double de_plus =
+        de_angle + 0.5 * to_radians(_source_de->increment(de));
+    const double de_minus =
+        de_angle - 0.5 * to_radians(_source_de->increment(de - 1));
+
+    const double az_angle = to_radians((*_source_az)(az));
+    const double az_plus =
+        az_angle + 0.5 * to_radians(_source_az->increment(az));
+    const size_t az_index = (az == 0 && _az_boundary) ? _max_az : az;
+    const double az_minus =
+        az_angle - 0.5 * to_radians(_source_az->increment(az_index - 1));
+
+    *de_delta = de_plus - de_minus;
+    return (sin(de_plus) - sin(de_minus)) * (az_plus - az_minus);
 }
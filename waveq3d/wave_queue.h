@@ -5,6 +5,7 @@
 #pragma once
 
 #include <usml/eigenrays/eigenray_notifier.h>
+#include <usml/eigenrays/eigenray_target_listener.h>
 #include <usml/eigenverbs/eigenverb_notifier.h>
 #include <usml/ocean/ocean_model.h>
 #include <usml/types/seq_vector.h>
@@ -12,12 +13,13 @@
 #include <usml/usml_config.h>
 #include <usml/waveq3d/reflection_notifier.h>
 #include <usml/waveq3d/wave_thresholds.h>
-#include <usml/netcdf-cxx/netcdfcpp.h>
+#include <usml/waveq3d/wavefront_writer.h>
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 namespace usml {
 namespace waveq3d {
@@ -72,10 +74,42 @@ class spreading_hybrid_gaussian;
  * parameters computations and wavefront derivatives can be reused by
  * subsequent time steps.
  *
+ * At the end of each step, rays that can no longer contribute to any
+ * eigenray or eigenverb are masked out of the rest of the calculation.
+ * A ray is dead when it exceeds the bounce thresholds, or when it is not
+ * needed for eigenrays and is too weak for eigenverbs. A ray is not needed
+ * for eigenrays if there are no eigenray listeners, if every target has
+ * been finalized (see finalize_target()), or if its accumulated attenuation
+ * is weaker than the intensity threshold at all frequencies. The positions
+ * of dead rays are still integrated, because the spreading model uses them
+ * to compute the beam width of their live neighbors, but they are skipped
+ * by the eigenray, eigenverb, and volume scattering searches. Clients can
+ * stop propagation early when num_live_rays() reaches zero.
+ *
+ * An optional adaptive mode refines the ray fan locally, so that a coarse
+ * fan can be used everywhere else. When the wavefront geometry around the
+ * closest point of approach (CPA) to a target is poorly resolved, a denser
+ * subfan of rays is launched over the launch angles around that CPA. The
+ * subfan is propagated from the source to the current time, and then
+ * marches in lockstep with the coarse fan. Each subfan owns the launch
+ * angles in the middle of its fan. Eigenrays with launch angles owned by
+ * a subfan are computed from the subfan, and the coarse eigenrays in that
+ * region are discarded. See refine_factor() for details.
+ *
+ * An optional adaptive time stepping mode lets the step size follow the
+ * local accuracy of the integration, so that the time step can be chosen
+ * for the worst case without over-resolving the rest of the propagation.
+ * The Adams-Bashforth coefficients are computed from the actual spacing
+ * of the prior iterations, and the local error is estimated by comparing
+ * each new wavefront to a 3rd order Adams-Moulton corrector. Eigenray
+ * and eigenverb interpolation in time account for the different steps on
+ * either side of the current wavefront. See step_tolerance() for details.
+ *
  * @xref S.M. Reilly, G. Potty, Sonar Propagation Modeling using Hybrid
  * Gaussian Beams in Spherical/Time Coordinates, January 2012.
  */
 class USML_DECLSPEC wave_queue : public eigenray_notifier,
+                                 public eigenray_target_listener,
                                  public eigenverb_notifier,
                                  public reflection_notifier,
                                  public wave_thresholds {
@@ -166,10 +200,16 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
     inline double time() const { return _time; }
 
     /**
-     * Propagation step size (seconds).
+     * Propagation step size (seconds). Time from the current to the next
+     * wavefront, which changes from step to step in adaptive mode.
      */
     inline double time_step() const { return _time_step; }
 
+    /**
+     * Number of steps taken since the start of propagation.
+     */
+    inline size_t num_steps() const { return _step_sizes.size() - 1; }
+
     /**
      * List of acoustic targets.
      */
@@ -260,9 +300,166 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      * portray targets near the interface.  Reflections are computed at the
      * beginning of the next iteration to ensure that the next wave elements
      * are always inside of the water column.
+     *
+     * Rays that can no longer contribute to any eigenray or eigenverb are
+     * masked out at the end of each step. Listeners and thresholds should
+     * be defined before the first step, because masked rays never come back.
      */
     void step();
 
+    /**
+     * Number of rays that can still contribute to eigenrays or eigenverbs.
+     * Updated at the end of each step(). Includes the live rays in
+     * subfans. Propagation can stop when this reaches zero.
+     */
+    size_t num_live_rays() const;
+
+    /**
+     * True if a ray can still contribute to eigenrays or eigenverbs.
+     *
+     * @param   de      D/E angle index number.
+     * @param   az      AZ angle index number.
+     */
+    inline bool is_live(size_t de, size_t az) const { return _live(de, az); }
+
+    /**
+     * Stops searching for eigenrays to a target whose eigenrays are
+     * complete. Register this wave_queue as a target listener for the
+     * eigenray_collection that it feeds, so that the rays can be masked out
+     * once every target has been finalized.
+     *
+     * @param collection    Collection that holds the eigenrays.
+     * @param t1     	    Row number of target.
+     * @param t2     	    Column number of target.
+     * @param runID 	    Wavefront identification number.
+     */
+    void finalize_target(const eigenray_collection& collection, size_t t1,
+                         size_t t2, size_t runID) override;
+
+    /**
+     * Number of subfan rays per coarse ray spacing in the adaptive mode.
+     * Values less than 2 disable the adaptive mode, which is the default.
+     * In the adaptive mode, the CPA to a target is poorly resolved if:
+     *
+     *  - The number of surface, bottom, and caustics is not the same for
+     *    wavefront points around the CPA.
+     *  - The D/E or AZ offset of the CPA is more than 50% of the ray
+     *    spacing, which indicates that the quadratic fit disagrees with
+     *    the sampled distances.
+     *  - The distance from the target to the CPA ray, in the D/E or AZ
+     *    direction, is larger than refine_distance().
+     *
+     * The subfan covers two coarse rays to either side of the CPA ray,
+     * using a linear spacing that is "factor" times denser than the coarse
+     * fan. It owns the launch angles that are more than one coarse ray
+     * spacing away from its edges. If the AZ fan covers all azimuths, the
+     * subfan wraps around the end of the AZ fan. If the AZ fan does not
+     * cover all azimuths, and has fewer than five rays, the subfan is only
+     * refined in D/E, and it owns all of the AZ angles. Subfans share the
+     * targets and thresholds of this wave_queue, but do not refine
+     * themselves, and do not produce eigenverbs. Set the refinement options
+     * before the first step.
+     *
+     * @param factor    Subfan rays per coarse ray spacing.
+     */
+    inline void refine_factor(size_t factor) { _refine_factor = factor; }
+
+    /**
+     * Number of subfan rays per coarse ray spacing in the adaptive mode.
+     */
+    inline size_t refine_factor() const { return _refine_factor; }
+
+    /**
+     * Largest distance from a target to its CPA ray, in the D/E or AZ
+     * direction, that is considered to be well resolved (meters).
+     * Defaults to zero, which refines around every eigenray.
+     *
+     * @param meters    Largest distance to CPA ray that is not refined.
+     */
+    inline void refine_distance(double meters) {
+        _refine_distance = abs(meters);
+    }
+
+    /**
+     * Largest distance from a target to its CPA ray that is considered
+     * to be well resolved (meters).
+     */
+    inline double refine_distance() const { return _refine_distance; }
+
+    /**
+     * Maximum number of subfans created by the adaptive mode.
+     * Poorly resolved eigenrays are computed from the coarse fan
+     * once this limit is reached. Defaults to 16.
+     *
+     * @param max       Maximum number of subfans.
+     */
+    inline void max_subfans(size_t max) { _max_subfans = max; }
+
+    /**
+     * Maximum number of subfans created by the adaptive mode.
+     */
+    inline size_t max_subfans() const { return _max_subfans; }
+
+    /**
+     * Number of subfans created by the adaptive mode so far.
+     */
+    inline size_t num_subfans() const { return _subfans.size(); }
+
+    /**
+     * Largest local position error allowed in a single time step (meters).
+     * A value of zero disables adaptive time stepping, which is the default.
+     *
+     * In adaptive mode, the local error of each step is estimated from the
+     * difference between the Adams-Bashforth predictor and an Adams-Moulton
+     * corrector for the live rays. Steps with too much error are repeated
+     * with a smaller time step, unless the step is already at
+     * min_time_step(). The next step is scaled by the fourth root of the
+     * ratio of the tolerance to this error, limited to a factor of two
+     * in either direction, and limited to the range from min_time_step()
+     * to max_time_step().
+     *
+     * Errors are only checked for the integration of the ray paths. The
+     * maximum time step should still be small enough to resolve boundary
+     * interactions and the curvature of the wavefront near targets. Set
+     * the time step options before the first step.
+     *
+     * @param meters    Largest position error in each time step.
+     */
+    inline void step_tolerance(double meters) {
+        _step_tolerance = abs(meters);
+    }
+
+    /**
+     * Largest local position error allowed in a single time step (meters).
+     */
+    inline double step_tolerance() const { return _step_tolerance; }
+
+    /**
+     * Smallest time step in adaptive mode (seconds). Defaults to 1/4
+     * of the time step given to the constructor.
+     *
+     * @param dt        Smallest time step.
+     */
+    inline void min_time_step(double dt) { _min_time_step = abs(dt); }
+
+    /**
+     * Smallest time step in adaptive mode (seconds).
+     */
+    inline double min_time_step() const { return _min_time_step; }
+
+    /**
+     * Largest time step in adaptive mode (seconds). Defaults to 4 times
+     * the time step given to the constructor.
+     *
+     * @param dt        Largest time step.
+     */
+    inline void max_time_step(double dt) { _max_time_step = abs(dt); }
+
+    /**
+     * Largest time step in adaptive mode (seconds).
+     */
+    inline double max_time_step() const { return _max_time_step; }
+
    protected:
     /**
      * Reference to the environmental parameters.
@@ -306,9 +503,15 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     const size_t _max_az;
 
-    /** Propagation step size (seconds). */
+    /** Propagation step size from the current to next entry (seconds). */
     double _time_step;
 
+    /** Step size from the previous to the current entry (seconds). */
+    double _prev_step;
+
+    /** Step size from the past to the previous entry (seconds). */
+    double _past_step;
+
     /** Time for current entry in the wave_front circular queue (seconds). */
     double _time;
 
@@ -329,6 +532,14 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     matrix<double> _targets_sin_theta;
 
+    /**
+     * Intermediate term: sound speed at each target.
+     * Targets do not move during propagation, so this is computed once,
+     * instead of each time that the spreading model estimates the
+     * intensity of an eigenray.
+     */
+    matrix<double> _targets_sound_speed;
+
     /** Reference to the reflection model component. */
     reflection_model* _reflection_model;
 
@@ -363,6 +574,87 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     bool _de_branch;
 
+    /** True for rays that can still contribute to eigenrays or eigenverbs. */
+    matrix<bool> _live;
+
+    /** Number of rays that can still contribute to eigenrays or eigenverbs. */
+    size_t _num_live;
+
+    /** True for targets that no longer need eigenrays. */
+    matrix<bool> _target_done;
+
+    /** Number of targets that no longer need eigenrays. */
+    size_t _num_targets_done;
+
+    /**
+     * Workspace for build_eigenverb(). Reused for each eigenverb, so
+     * that no memory is allocated unless an eigenverb listener needs
+     * to keep a copy.
+     */
+    eigenverb_model _eigenverb;
+
+    /** Type of spreading model, re-used for subfans. */
+    spreading_type _spreading_type;
+
+    /** Subfan rays per coarse ray spacing, adaptive mode off if < 2. */
+    size_t _refine_factor;
+
+    /** Largest distance to CPA ray that is not refined (meters). */
+    double _refine_distance;
+
+    /** Maximum number of subfans created by the adaptive mode. */
+    size_t _max_subfans;
+
+    /**
+     * Denser ray fan launched around a poorly resolved CPA.
+     * Defined in wave_queue.cc.
+     */
+    struct subfan;
+
+    /** Subfans created by the adaptive mode, in order of creation. */
+    std::vector<std::unique_ptr<subfan>> _subfans;
+
+    /** Eigenray from the coarse fan, held until subfans are updated. */
+    struct pending_eigenray {
+        size_t t1;
+        size_t t2;
+        eigenray_model::csptr ray;
+        size_t de;
+        size_t az;
+        bool refine;
+    };
+
+    /**
+     * Eigenrays found by the coarse fan in the current step. Held until
+     * the end of the step in adaptive mode, so that eigenrays inside
+     * subfans created in this step can be discarded.
+     */
+    std::vector<pending_eigenray> _pending;
+
+    /** Largest position error in a single step, fixed step if zero. */
+    double _step_tolerance;
+
+    /** Smallest time step in adaptive mode (seconds). */
+    double _min_time_step;
+
+    /** Largest time step in adaptive mode (seconds). */
+    double _max_time_step;
+
+    /** Scale factor for the next time step in adaptive mode. */
+    double _step_scale;
+
+    /**
+     * Step size used to compute the next entry, for each step. The first
+     * entry is the step used by init_wavefronts().
+     */
+    std::vector<double> _step_sizes;
+
+    /**
+     * Step sizes to follow instead of choosing them, nullptr if none.
+     * Used by subfans to stay on the time grid of the coarse fan.
+     */
+    const std::vector<double>* _step_source;
+
     /**
      * Initialize wavefronts at the start of propagation using a
      * 3rd order Runge-Kutta algorithm.  The Runge-Kutta algorithm is
@@ -380,6 +672,105 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      */
     void init_wavefronts();
 
+    /**
+     * Masks out rays that can no longer contribute to any eigenray or
+     * eigenverb. Assumes that spreading loss is never negative, so that
+     * an eigenray is at least as weak as the accumulated attenuation along
+     * its path. Bounds eigenverb power using max_eigenverb_gain(), which
+     * follows from the smallest grazing angle that build_eigenverb() accepts.
+     */
+    void update_live_rays();
+
+    /**
+     * Solid angle of the ray fan around a single ray, using the halfway
+     * points to its neighbors. Wraps around the end of the AZ fan if the
+     * ray fan covers all azimuths.
+     *
+     * @param   de          D/E angle index number.
+     * @param   az          AZ angle index number.
+     * @param   de_delta    Change in D/E across this ray (radians, output).
+     * @return              Solid angle of this ray (steradians).
+     */
+    double beam_area(size_t de, size_t az, double* de_delta) const;
+
+    //**************************************************
+    // adaptive time stepping
+
+    /**
+     * Computes the next entry in the wavefront queue from the past,
+     * previous and current entries. Repeats the step with a smaller time
+     * step if the local error is larger than step_tolerance(), and
+     * chooses the scale factor for the following step.
+     */
+    void integrate_next();
+
+    /**
+     * Estimates the local position error in the next entry for the live
+     * rays. Uses Milne's device to scale the difference between the
+     * Adams-Bashforth predictor and a variable step Adams-Moulton (3rd
+     * order) corrector.
+     *
+     * @return          Largest position error for any live ray (meters).
+     */
+    double step_error() const;
+
+    /**
+     * Weights that evaluate the quadratic through the previous, current,
+     * and next entries at one time step before the current entry.
+     * Used to interpolate in time as if the previous entry was the same
+     * distance from the current entry as the next entry. The weights are
+     * exactly 1, 0, and 0 if the steps are equal.
+     *
+     * @param   weight  Weights for previous, current, and next (output).
+     */
+    void prev_weights(double weight[3]) const;
+
+    /**
+     * Fraction of a time step for an offset from the current entry.
+     * Uses the step to the next entry for positive offsets,
+     * and the step to the previous entry for negative offsets.
+     *
+     * @param   offset  Time offset from the current entry (seconds).
+     * @return          Offset as a signed fraction of the time step.
+     */
+    inline double step_fraction(double offset) const {
+        return offset / ((offset >= 0.0) ? _time_step : _prev_step);
+    }
+
+    //**************************************************
+    // adaptive ray fan refinement
+
+    /**
+     * Completes the eigenray search for the adaptive mode. Steps existing
+     * subfans to the current time, creates new subfans around poorly
+     * resolved CPAs, and then sends the pending coarse eigenrays to the
+     * eigenray listeners if their launch angles are not owned by a subfan.
+     */
+    void refine_eigenrays();
+
+    /**
+     * Launches a new subfan around a coarse ray and propagates it
+     * to the current time. Does nothing if the subfan would not own
+     * the launch angles of the coarse eigenray, which happens near
+     * the edges of the coarse fan. Wraps the AZ angles of the subfan
+     * around the end of AZ fans that cover all azimuths, and only refines
+     * in D/E if the AZ fan is too narrow for a subfan.
+     *
+     * @param   de      D/E angle index number of the CPA ray.
+     * @param   az      AZ angle index number of the CPA ray.
+     * @param   ray     Poorly resolved eigenray from the coarse fan.
+     */
+    void add_subfan(size_t de, size_t az, const eigenray_model& ray);
+
+    /**
+     * Finds the first subfan that owns a launch angle.
+     *
+     * @param   de      Launch D/E angle (degrees).
+     * @param   az      Launch AZ angle (degrees).
+     * @return          Owner of this launch angle, nullptr if none.
+     */
+    const subfan* find_subfan(double de, double az) const;
+
     //**************************************************
     // reflections and caustics
 
@@ -714,7 +1105,7 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      * - The number of surface, bottom, caustic, upper, lower bounces
      *   exceeds the current threshold.
      * - The wave has not started to propagate.
-     * - The grazing angle is less than 1e-6 radians.
+     * - The grazing angle is less than the eigenverb_grazing() threshold.
      * - The last azimuth of the fan overlaps the first azimuth.
      * - The launch D/E angle is greater +/- 89.9 degrees.  This excludes
      *   the region where initial area covered by ray is close to zero.
@@ -744,16 +1135,15 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
 
    private:
     /**
-     * The netCDF file used to record the wavefront log.
+     * Background writer used to record the wavefront log.
      */
-    std::unique_ptr<netCDF::NcFile> _nc_file;
+    std::unique_ptr<wavefront_writer> _nc_writer;
 
-    /** The netCDF variables used to record the wavefront log. */
-    netCDF::NcVar _nc_time, _nc_latitude, _nc_longitude, _nc_altitude, _nc_surface,
-        _nc_bottom, _nc_caustic, _nc_upper, _nc_lower, _nc_on_edge;
+    /** Record every N-th call to save_netcdf(). */
+    size_t _nc_decimation;
 
-    /** Current record number in netDCF file. */
-    size_t _nc_rec;
+    /** Number of calls to save_netcdf() since the log was opened. */
+    size_t _nc_step;
 
    public:
     /**
@@ -812,20 +1202,32 @@ class USML_DECLSPEC wave_queue : public eigenray_notifier,
      *      etc...
      *   }
      * </pre>
+     * Records are written asynchronously by a wavefront_writer, using
+     * netCDF-4 chunking and compression. Clients can reduce the cost of
+     * large logs by recording only some of the time steps, or only
+     * every N-th D/E and AZ ray.
+     *
      * @param   filename    Name of the file to write to disk.
      * @param   long_name   Optional global attribute for identifying data-set.
+     * @param   decimation  Record every N-th call to save_netcdf(),
+     *                      starting with the first.
+     * @param   de_stride   Record every N-th D/E ray, starting at the first.
+     * @param   az_stride   Record every N-th AZ ray, starting at the first.
      */
-    void init_netcdf(const char* filename, const char* long_name = nullptr);
+    void init_netcdf(const char* filename, const char* long_name = nullptr,
+                     size_t decimation = 1, size_t de_stride = 1,
+                     size_t az_stride = 1);
 
     /**
      * Write current record to netCDF wavefront log.
      * Records travel time, latitude, longitude, altitude for
-     * the current wavefront.
+     * the current wavefront. Copies the wavefront and returns
+     * without waiting for it to be written to disk.
      */
     void save_netcdf();
 
     /**
-     * Close netCDF wavefront log.
+     * Close netCDF wavefront log. Waits for all records to be written.
      */
     void close_netcdf();
 };
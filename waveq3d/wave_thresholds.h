@@ -4,6 +4,7 @@
  */
 #pragma once
 
+#include <usml/ublas/math_traits.h>
 #include <usml/usml_config.h>
 #include <usml/waveq3d/wave_front.h>
 
@@ -32,12 +33,15 @@ class USML_DECLSPEC wave_thresholds {
     /**
      * Set thresholds to default values that a designed to let almost
      * everything through. The intensity_threshold and eigenverb_threshold
-     * default to -300 dB. The maximum number of bottom, surface, caustic,
-     * upper, and lower default to 999.
+     * default to -300 dB. The eigenverb_grazing defaults to 1e-6 radians,
+     * so that no eigenverbs are dropped unless it is raised explicitly.
+     * The maximum number of bottom, surface, caustic, upper, and lower
+     * default to 999.
      */
     wave_thresholds()
         : _intensity_threshold(300.0),
           _eigenverb_threshold(1e-30),
+          _eigenverb_grazing(1e-6),
           _max_bottom(999),
           _max_surface(999),
           _max_caustic(999),
@@ -113,6 +117,55 @@ class USML_DECLSPEC wave_thresholds {
         return false;
     }
 
+    /**
+     * Test a single eigenverb.power value against the eigenverb threshold.
+     *
+     * @param  power    Power in linear units.
+     * @return false if this value is below the threshold.
+     */
+    bool above_eigenverb_threshold(double power) {
+        return power >= _eigenverb_threshold;
+    }
+
+    /**
+     * The smallest grazing angle at which eigenverbs are created (degrees).
+     * Eigenverb power grows as 1/sin(grazing), so this also limits the
+     * eigenverb power that a ray can produce at a later collision.
+     * Reverberation at smaller angles is negligible for realistic
+     * scattering strengths, which fall off at least as fast as sin(grazing),
+     * so raising it to about 0.1 degrees prunes rays that only produce
+     * negligible eigenverbs.
+     */
+    inline void eigenverb_grazing(double angle) {
+        _eigenverb_grazing = to_radians(abs(angle));
+    }
+
+    /**
+     * The smallest grazing angle at which eigenverbs are created (degrees).
+     */
+    inline double eigenverb_grazing() const {
+        return to_degrees(_eigenverb_grazing);
+    }
+
+    /**
+     * Test an eigenverb grazing angle against the eigenverb_grazing.
+     *
+     * @param  grazing  Grazing angle at the interface (radians).
+     * @return false if this angle is smaller than the threshold.
+     */
+    inline bool above_eigenverb_grazing(double grazing) const {
+        return abs(grazing) >= _eigenverb_grazing;
+    }
+
+    /**
+     * Largest factor by which the eigenverb power of a ray can exceed its
+     * beam intensity times its solid angle. Computed from the
+     * eigenverb_grazing.
+     */
+    inline double max_eigenverb_gain() const {
+        return 1.0 / sin(_eigenverb_grazing);
+    }
+
     /**
      * The maximum number of bottom bounces.
      * Any eigenray or eigenverb with more than this number
@@ -215,6 +268,12 @@ class USML_DECLSPEC wave_thresholds {
      */
     double _eigenverb_threshold;
 
+    /**
+     * The smallest grazing angle at which eigenverbs are created.
+     * Stored in radians for comparison with the verb.grazing value.
+     */
+    double _eigenverb_grazing;
+
     /**
      * The maximum number of bottom bounces.
      * Any eigenray or eigenverb with more than this number
@@ -0,0 +1,263 @@
+/**
+ * @file wavefront_writer.cc
+ * Records wavefronts to a netCDF log on a background thread.
+ */
+#include <usml/types/wposition.h>
+#include <usml/ublas/math_traits.h>
+#include <usml/waveq3d/wave_front.h>
+#include <usml/waveq3d/wavefront_writer.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+using namespace usml::waveq3d;
+
+/**
+ * Opens the file, writes the coordinates, and starts the writer thread.
+ */
+wavefront_writer::wavefront_writer(const char* filename, const char* long_name,
+                                   const seq_vector::csptr& frequencies,
+                                   const seq_vector::csptr& source_de,
+                                   const seq_vector::csptr& source_az,
+                                   size_t de_stride, size_t az_stride,
+                                   int deflate)
+    : _de_stride(std::max(de_stride, (size_t)1)),
+      _az_stride(std::max(az_stride, (size_t)1)),
+      _num_de((source_de->size() + _de_stride - 1) / _de_stride),
+      _num_az((source_az->size() + _az_stride - 1) / _az_stride),
+      _nc_file(std::make_unique<netCDF::NcFile>(filename,
+                                                netCDF::NcFile::replace)) {
+    if (long_name != nullptr) {
+        _nc_file->putAtt("long_name", long_name);
+    }
+    _nc_file->putAtt("Conventions", "COARDS");
+
+    // dimensions
+
+    netCDF::NcDim freq_dim =
+        _nc_file->addDim("frequencies", frequencies->size());
+    netCDF::NcDim de_dim = _nc_file->addDim("source_de", _num_de);
+    netCDF::NcDim az_dim = _nc_file->addDim("source_az", _num_az);
+    netCDF::NcDim time_dim = _nc_file->addDim("travel_time");  // unlimited
+    std::vector<netCDF::NcDim> tda_dim = {time_dim, de_dim, az_dim};
+
+    // coordinates
+
+    netCDF::NcVar freq_var =
+        _nc_file->addVar("frequencies", netCDF::NcDouble(), freq_dim);
+    netCDF::NcVar de_var =
+        _nc_file->addVar("source_de", netCDF::NcDouble(), de_dim);
+    netCDF::NcVar az_var =
+        _nc_file->addVar("source_az", netCDF::NcDouble(), az_dim);
+    _nc_time = _nc_file->addVar("travel_time", netCDF::NcDouble(), time_dim);
+    _nc_latitude = _nc_file->addVar("latitude", netCDF::NcDouble(), tda_dim);
+    _nc_longitude = _nc_file->addVar("longitude", netCDF::NcDouble(), tda_dim);
+    _nc_altitude = _nc_file->addVar("altitude", netCDF::NcDouble(), tda_dim);
+    _nc_surface = _nc_file->addVar("surface", netCDF::NcShort(), tda_dim);
+    _nc_bottom = _nc_file->addVar("bottom", netCDF::NcShort(), tda_dim);
+    _nc_caustic = _nc_file->addVar("caustic", netCDF::NcShort(), tda_dim);
+    _nc_upper = _nc_file->addVar("upper", netCDF::NcShort(), tda_dim);
+    _nc_lower = _nc_file->addVar("lower", netCDF::NcShort(), tda_dim);
+    _nc_on_edge = _nc_file->addVar("on_edge", netCDF::NcByte(), tda_dim);
+
+    // chunk each record separately and compress it
+
+    std::vector<size_t> time_chunk = {1024};
+    _nc_time.setChunking(netCDF::NcVar::nc_CHUNKED, time_chunk);
+    std::vector<size_t> record_chunk = {1, _num_de, _num_az};
+    for (const netCDF::NcVar& var :
+         {_nc_latitude, _nc_longitude, _nc_altitude, _nc_surface, _nc_bottom,
+          _nc_caustic, _nc_upper, _nc_lower, _nc_on_edge}) {
+        var.setChunking(netCDF::NcVar::nc_CHUNKED, record_chunk);
+        if (deflate > 0) {
+            var.setCompression(true, true, deflate);
+        }
+    }
+
+    // units
+
+    freq_var.putAtt("units", "hertz");
+    de_var.putAtt("units", "degrees");
+    de_var.putAtt("positive", "up");
+    az_var.putAtt("units", "degrees_true");
+    az_var.putAtt("positive", "clockwise");
+    _nc_time.putAtt("units", "seconds");
+    _nc_latitude.putAtt("units", "degrees_north");
+    _nc_longitude.putAtt("units", "degrees_east");
+    _nc_altitude.putAtt("units", "meters");
+    _nc_altitude.putAtt("positive", "up");
+    _nc_surface.putAtt("units", "count");
+    _nc_bottom.putAtt("units", "count");
+    _nc_caustic.putAtt("units", "count");
+    _nc_upper.putAtt("units", "count");
+    _nc_lower.putAtt("units", "count");
+    _nc_on_edge.putAtt("units", "bool");
+
+    // coordinate data, for the subset of rays being recorded
+
+    std::vector<double> de_data;
+    for (size_t d = 0; d < source_de->size(); d += _de_stride) {
+        de_data.push_back((*source_de)(d));
+    }
+    std::vector<double> az_data;
+    for (size_t a = 0; a < source_az->size(); a += _az_stride) {
+        az_data.push_back((*source_az)(a));
+    }
+    freq_var.putVar(frequencies->data().begin());
+    de_var.putVar(de_data.data());
+    az_var.putVar(az_data.data());
+
+    // allocate snapshot buffers and start writer thread
+
+    const size_t size = _num_de * _num_az;
+    for (size_t n = 0; n < NUM_BUFFERS; ++n) {
+        auto snap = std::make_unique<snapshot>();
+        snap->latitude.resize(size);
+        snap->longitude.resize(size);
+        snap->altitude.resize(size);
+        snap->surface.resize(size);
+        snap->bottom.resize(size);
+        snap->caustic.resize(size);
+        snap->upper.resize(size);
+        snap->lower.resize(size);
+        snap->on_edge.resize(size);
+        _free.push_back(std::move(snap));
+    }
+    _thread = std::thread(&wavefront_writer::run, this);
+}
+
+/**
+ * Waits for all records to be written, and closes the file.
+ */
+wavefront_writer::~wavefront_writer() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+/**
+ * Copies a wavefront into a free snapshot buffer, and queues it to
+ * be written by the background thread.
+ */
+void wavefront_writer::write(double time, const wave_front& front) {
+    std::unique_ptr<snapshot> snap;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_closing) {
+            throw std::logic_error("wavefront_writer: file already closed");
+        }
+        _cond.wait(lock, [this] { return !_free.empty() || _error; });
+        if (_error) {
+            std::rethrow_exception(_error);
+        }
+        snap = std::move(_free.back());
+        _free.pop_back();
+    }
+
+    // copy raw spherical coordinates, converted later by writer thread
+
+    snap->time = time;
+    size_t n = 0;
+    for (size_t d = 0; d < front.position.size1(); d += _de_stride) {
+        for (size_t a = 0; a < front.position.size2(); a += _az_stride) {
+            snap->latitude[n] = front.position.theta(d, a);
+            snap->longitude[n] = front.position.phi(d, a);
+            snap->altitude[n] = front.position.rho(d, a);
+            snap->surface[n] = (short)front.surface(d, a);
+            snap->bottom[n] = (short)front.bottom(d, a);
+            snap->caustic[n] = (short)front.caustic(d, a);
+            snap->upper[n] = (short)front.upper(d, a);
+            snap->lower[n] = (short)front.lower(d, a);
+            snap->on_edge[n] = (signed char)front.on_edge(d, a);
+            ++n;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.push_back(std::move(snap));
+    }
+    _cond.notify_all();
+}
+
+/**
+ * Waits for all records to be written, and closes the file.
+ */
+void wavefront_writer::close() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_thread.joinable()) {
+            return;
+        }
+        _closing = true;
+    }
+    _cond.notify_all();
+    _thread.join();
+    _nc_file.reset();  // destructor frees all netCDF temp variables
+    if (_error) {
+        std::rethrow_exception(_error);
+    }
+}
+
+/**
+ * Background loop that writes queued snapshots until closed.
+ * After an error, snapshots are discarded so that write() never blocks.
+ */
+void wavefront_writer::run() {
+    while (true) {
+        std::unique_ptr<snapshot> snap;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return !_pending.empty() || _closing; });
+            if (_pending.empty()) {
+                return;
+            }
+            snap = std::move(_pending.front());
+            _pending.pop_front();
+        }
+        try {
+            if (!_error) {
+                save(*snap);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(std::move(snap));
+        }
+        _cond.notify_all();
+    }
+}
+
+/**
+ * Converts a snapshot to geodetic coordinates and writes it as
+ * the next record in the file.
+ */
+void wavefront_writer::save(snapshot& snap) {
+    const size_t size = snap.latitude.size();
+    for (size_t n = 0; n < size; ++n) {
+        snap.latitude[n] = to_latitude(snap.latitude[n]);
+        snap.longitude[n] = to_degrees(snap.longitude[n]);
+        snap.altitude[n] -= wposition::earth_radius;
+    }
+
+    const std::vector<size_t> start1 = {_nc_rec};
+    const std::vector<size_t> count1 = {1};
+    const std::vector<size_t> startp = {_nc_rec, 0, 0};
+    const std::vector<size_t> countp = {1, _num_de, _num_az};
+    _nc_time.putVar(start1, count1, &snap.time);
+    _nc_latitude.putVar(startp, countp, snap.latitude.data());
+    _nc_longitude.putVar(startp, countp, snap.longitude.data());
+    _nc_altitude.putVar(startp, countp, snap.altitude.data());
+    _nc_surface.putVar(startp, countp, snap.surface.data());
+    _nc_bottom.putVar(startp, countp, snap.bottom.data());
+    _nc_caustic.putVar(startp, countp, snap.caustic.data());
+    _nc_upper.putVar(startp, countp, snap.upper.data());
+    _nc_lower.putVar(startp, countp, snap.lower.data());
+    _nc_on_edge.putVar(startp, countp, snap.on_edge.data());
+    ++_nc_rec;
+}
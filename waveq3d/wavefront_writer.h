@@ -0,0 +1,183 @@
+/**
+ * @file wavefront_writer.h
+ * Records wavefronts to a netCDF log on a background thread.
+ */
+#pragma once
+
+#include <usml/netcdf-cxx/netcdfcpp.h>
+#include <usml/types/seq_vector.h>
+#include <usml/usml_config.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace usml {
+namespace waveq3d {
+
+using namespace usml::types;
+
+class wave_front;
+
+/// @ingroup waveq3d
+/// @{
+
+/**
+ * Records wavefronts to a netCDF log on a background thread. The
+ * propagation thread copies each wavefront into a snapshot buffer and
+ * returns immediately. A dedicated writer thread converts the snapshot
+ * to latitude, longitude, and altitude, and writes it to disk. Two snapshot
+ * buffers are used, so that the propagation thread can fill one while
+ * the writer thread saves the other. If the writer falls behind, the
+ * propagation thread waits for a buffer to become free, which bounds the
+ * memory used by this class.
+ *
+ * The file is written in the netCDF-4 format. Each record is stored as
+ * a separate chunk that is compressed with the shuffle and deflate filters.
+ * Clients can reduce the size of the log by writing every N-th D/E and AZ
+ * ray. The source_de and source_az coordinates are written for the subset
+ * of rays actually recorded. See wave_queue::init_netcdf() for the layout
+ * of the file.
+ *
+ * A dedicated std::thread is used instead of the thread_controller pool,
+ * because the writer blocks on disk I/O for the whole propagation, and
+ * would otherwise take a pool thread away from other tasks. Exceptions
+ * on the writer thread are passed back to the propagation thread in the
+ * next call to write() or close().
+ */
+class USML_DECLSPEC wavefront_writer {
+   public:
+    /**
+     * Opens the file, writes the coordinates, and starts the writer thread.
+     *
+     * @param filename      Name of the file to write to disk.
+     * @param long_name     Optional global attribute for identifying data-set.
+     * @param frequencies   Frequencies over which to compute loss (Hz).
+     * @param source_de     Initial depression/elevation angles at the source.
+     * @param source_az     Initial azimuthal angle at the source.
+     * @param de_stride     Record every N-th D/E ray, starting at the first.
+     * @param az_stride     Record every N-th AZ ray, starting at the first.
+     * @param deflate       Compression level for deflate filter (0-9).
+     *                      Set to zero to disable compression.
+     */
+    wavefront_writer(const char* filename, const char* long_name,
+                     const seq_vector::csptr& frequencies,
+                     const seq_vector::csptr& source_de,
+                     const seq_vector::csptr& source_az, size_t de_stride = 1,
+                     size_t az_stride = 1, int deflate = 1);
+
+    /**
+     * Waits for all records to be written, and closes the file.
+     * Errors on the writer thread are ignored.
+     */
+    ~wavefront_writer();
+
+    /**
+     * Copies a wavefront into a free snapshot buffer, and queues it to
+     * be written by the background thread. Blocks if both buffers are busy.
+     *
+     * @param time          Travel time for this wavefront (sec).
+     * @param front         Wavefront to be recorded.
+     * @throw netCDF::exceptions::NcException
+     *                      If the writer thread failed to write a record.
+     * @throw std::logic_error  If the file has already been closed.
+     */
+    void write(double time, const wave_front& front);
+
+    /**
+     * Waits for all records to be written, and closes the file.
+     * Does nothing if the file is already closed.
+     *
+     * @throw netCDF::exceptions::NcException
+     *                      If the writer thread failed to write a record.
+     */
+    void close();
+
+   private:
+    /**
+     * Copy of one wavefront, in the order it is written to disk.
+     * The latitude, longitude, and altitude fields hold theta, phi, and
+     * rho until the writer thread converts them.
+     */
+    struct snapshot {
+        double time = 0.0;
+        std::vector<double> latitude;
+        std::vector<double> longitude;
+        std::vector<double> altitude;
+        std::vector<short> surface;
+        std::vector<short> bottom;
+        std::vector<short> caustic;
+        std::vector<short> upper;
+        std::vector<short> lower;
+        std::vector<signed char> on_edge;
+    };
+
+    /// Number of snapshot buffers shared by the two threads.
+    static const size_t NUM_BUFFERS = 2;
+
+    /// Record every N-th D/E ray.
+    const size_t _de_stride;
+
+    /// Record every N-th AZ ray.
+    const size_t _az_stride;
+
+    /// Number of D/E rays in each record.
+    const size_t _num_de;
+
+    /// Number of AZ rays in each record.
+    const size_t _num_az;
+
+    /// The netCDF file used to record the wavefront log.
+    std::unique_ptr<netCDF::NcFile> _nc_file;
+
+    /** The netCDF variables used to record the wavefront log. */
+    netCDF::NcVar _nc_time, _nc_latitude, _nc_longitude, _nc_altitude,
+        _nc_surface, _nc_bottom, _nc_caustic, _nc_upper, _nc_lower,
+        _nc_on_edge;
+
+    /// Current record number in netCDF file, used by writer thread.
+    size_t _nc_rec = 0;
+
+    /// Protects the snapshot queues and state flags.
+    std::mutex _mutex;
+
+    /// Signals changes in the snapshot queues and state flags.
+    std::condition_variable _cond;
+
+    /// Snapshot buffers that are ready to be filled.
+    std::vector<std::unique_ptr<snapshot>> _free;
+
+    /// Snapshot buffers that are waiting to be written.
+    std::deque<std::unique_ptr<snapshot>> _pending;
+
+    /// True when no more snapshots will be added.
+    bool _closing = false;
+
+    /// First error from the writer thread.
+    std::exception_ptr _error;
+
+    /// Background thread that writes snapshots to disk.
+    std::thread _thread;
+
+    /**
+     * Background loop that writes queued snapshots until closed.
+     */
+    void run();
+
+    /**
+     * Converts a snapshot to geodetic coordinates and writes it as
+     * the next record in the file.
+     *
+     * @param snap          Snapshot to write. Contents are modified.
+     */
+    void save(snapshot& snap);
+};
+
+/// @}
+}  // end of namespace waveq3d
+}  // end of namespace usml
@@ -90,3 +90,4 @@
 
 #include <usml/waveq3d/wave_front.h>
 #include <usml/waveq3d/wave_queue.h>
+#include <usml/waveq3d/wavefront_writer.h>